@@ -34,6 +34,7 @@
 #include "Usul/File/AsciiInputFile.h"
 #include "Usul/Functions/NoThrow.h"
 #include "Usul/Jobs/Manager.h"
+#include "Usul/Jobs/Timer.h"
 #include "Usul/Interfaces/IDocumentCreate.h"
 #include "Usul/Interfaces/IRead.h"
 #include "Usul/Plugins/Manager.h"
@@ -41,6 +42,7 @@
 #include "Usul/System/LastError.h"
 #include "Usul/User/Directory.h"
 
+#include "QtCore/QMetaObject"
 #include "QtCore/QTimer"
 #include "QtGui/QApplication"
 #include "QtGui/QDockWidget"
@@ -59,6 +61,25 @@
 using namespace Helios::MainWindows;
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // Where the idle timer's interval is kept.
+  inline Usul::Registry::Node::Path idleTimerPath()
+  {
+    Usul::Registry::Node::Path path;
+    path.push_back ( "idle_timer" );
+    path.push_back ( "milliseconds" );
+    return path;
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Constructor.
@@ -68,6 +89,9 @@ using namespace Helios::MainWindows;
 MainWindow::MainWindow() : BaseClass(),
   _refCount ( 0 ),
   _idleTimer ( 0x0 ),
+  _idleMilliseconds ( Usul::Registry::Database::instance(), Helper::idleTimerPath(), 100 ),
+  _idleVersion ( 0 ),
+  _idlePosted ( false ),
   _menuBar(),
   _toolBars()
 {
@@ -105,6 +129,9 @@ MainWindow::MainWindow() : BaseClass(),
     {
       queue = Usul::Jobs::Queue::RefPtr ( new Usul::Jobs::Queue ( 0 ) );
     }
+
+    // Run idle jobs as soon as they are added instead of at the next tick.
+    queue->notifySet ( boost::bind ( &MainWindow::_idleNotify, this ) );
   }
 
   // Make sure there is a job-queue for background tasks.
@@ -112,9 +139,10 @@ MainWindow::MainWindow() : BaseClass(),
     Usul::Jobs::Queue::RefPtr &queue ( Usul::Jobs::Manager::instance()["worker_queue"] );
     if ( false == queue.valid() )
     {
-      const unsigned int numWorkerThreads ( Usul::Registry::Database::instance()
-        ["job_queues"]["worker_queue"]["num_threads"].get<unsigned int> ( 1, true ) );
-      queue = Usul::Jobs::Queue::RefPtr ( new Usul::Jobs::Queue ( numWorkerThreads ) );
+      Usul::Registry::Node &section ( Usul::Registry::Database::instance()["job_queues"]["worker_queue"] );
+      const unsigned int numWorkerThreads ( section["num_threads"].get<unsigned int> ( 1, true ) );
+      const bool workStealing ( section["work_stealing"].get<bool> ( false, true ) );
+      queue = Usul::Jobs::Queue::RefPtr ( new Usul::Jobs::Queue ( numWorkerThreads, workStealing ) );
     }
   }
 
@@ -123,16 +151,26 @@ MainWindow::MainWindow() : BaseClass(),
     Usul::Jobs::Queue::RefPtr &queue ( Usul::Jobs::Manager::instance()["render_queue"] );
     if ( false == queue.valid() )
     {
-      const unsigned int numWorkerThreads ( Usul::Registry::Database::instance()
-        ["job_queues"]["render_queue"]["num_threads"].get<unsigned int> ( 1, true ) );
+      Usul::Registry::Node &section ( Usul::Registry::Database::instance()["job_queues"]["render_queue"] );
+      const unsigned int numWorkerThreads ( section["num_threads"].get<unsigned int> ( 1, true ) );
       queue = Usul::Jobs::Queue::RefPtr ( new Usul::Jobs::Queue ( numWorkerThreads ) );
+
+      // Optionally, frames that are late go behind the others, or are dropped.
+      // Off by default because jobs without a deadline would wait behind 
+      // every frame that has one.
+      queue->deadlinesSet ( section["deadlines"].get<bool> ( false, true ) );
+      queue->missedSet ( ( true == section["drop_missed_deadlines"].get<bool> ( false, true ) ) ? 
+        Usul::Jobs::Queue::MISSED_DROP : Usul::Jobs::Queue::MISSED_DOWNGRADE );
     }
   }
 
   // Start the idle timer.
   _idleTimer = new QTimer ( this );
   QObject::connect ( _idleTimer, SIGNAL ( timeout() ), SLOT ( _idleProcess() ) );
-  _idleTimer->start ( Usul::Registry::Database::instance()["idle_timer"]["milliseconds"].get<int> ( 100, true ) );
+  // Put the interval in the registry so that it is saved with the settings.
+  _idleMilliseconds.set ( _idleMilliseconds.get() );
+  _idleMilliseconds.changed ( _idleVersion );
+  _idleTimer->start ( _idleMilliseconds.get() );
 
   // For drag-and-drop.
   this->setAcceptDrops ( true );
@@ -190,6 +228,10 @@ MainWindow::~MainWindow()
 {
   Usul::Functions::noThrow ( boost::bind ( &MainWindow::_settingsSave, this ), "3245065420" );
   Usul::Functions::noThrow ( boost::bind ( &MainWindow::_destroy,      this ), "1934297230" );
+
+  // The settings are written in another thread. Wait for them here, 
+  // because the process may end before static destruction joins it.
+  Usul::Functions::noThrow ( &Tree::Registry::IO::wait, "2574396180" );
 }
 
 
@@ -226,6 +268,28 @@ void MainWindow::_destroy()
   _menuBar = MenuBarData();
   _toolBars.clear();
 
+  // Print how the job-queues did, if we should.
+  if ( true == Usul::Registry::Database::instance()["job_queues"]["print_metrics"].get<bool> ( false, true ) )
+  {
+    const Usul::Jobs::Manager::Snapshots metrics ( Usul::Jobs::Manager::instance().metrics() );
+    for ( Usul::Jobs::Manager::Snapshots::const_iterator i = metrics.begin(); i != metrics.end(); ++i )
+    {
+      std::cout << i->first << ": ";
+      i->second.write ( std::cout );
+    }
+    std::cout << std::flush;
+  }
+
+  // Stop adding delayed jobs, and stop hearing about idle jobs.
+  Usul::Jobs::Timer::instance().clear();
+  {
+    Usul::Jobs::Queue::RefPtr queue ( Usul::Jobs::Manager::instance()["idle_queue"] );
+    if ( true == queue.valid() )
+    {
+      queue->notifySet ( Usul::Jobs::Queue::Callback() );
+    }
+  }
+
   // Delete our job-queues.
   Usul::Jobs::Manager::instance()["idle_queue"]   = Usul::Jobs::Queue::RefPtr ( 0x0 );
   Usul::Jobs::Manager::instance()["worker_queue"] = Usul::Jobs::Queue::RefPtr ( 0x0 );
@@ -280,12 +344,52 @@ Usul::Interfaces::IUnknown *MainWindow::queryInterface ( unsigned long iid )
 
 void MainWindow::_idleProcess()
 {
-  typedef boost::posix_time::time_duration Duration;
-
   USUL_TRY_BLOCK
   {
+    // The interval may have changed, like when the settings were loaded.
+    if ( true == _idleMilliseconds.changed ( _idleVersion ) )
+    {
+      _idleTimer->setInterval ( _idleMilliseconds.get() );
+    }
+
     this->_updateMenuBar();
     this->_updateToolBars();
+    this->_idleJobs();
+  }
+  USUL_DEFINE_CATCH_BLOCKS ( "3734789250" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Called when a job is added to the idle queue. This may be any thread, 
+//  so post a call to the gui thread. Only one call is posted at a time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::_idleNotify()
+{
+  if ( false == _idlePosted.fetch_and_store ( true ) )
+  {
+    QMetaObject::invokeMethod ( this, "_idleJobs", Qt::QueuedConnection );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Execute the jobs in the idle queue.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::_idleJobs()
+{
+  typedef boost::posix_time::time_duration Duration;
+
+  USUL_TRY_BLOCK
+  {
+    // Jobs added from now on need another call.
+    _idlePosted = false;
 
     // Execute the next job on the queue.
     Usul::Jobs::Queue::RefPtr queue ( Usul::Jobs::Manager::instance()["idle_queue"] );
@@ -1075,10 +1179,10 @@ void MainWindow::_settingsSave()
   // Save dock window positions.
   mw["dock_window_positions"] = this->saveState();
 
-  // Write to disk.
+  // Write to disk in another thread so that closing does not wait.
   const std::string file ( this->settingsFile() );
   Usul::Functions::noThrow ( boost::bind 
-    ( Tree::Registry::IO::write, file, boost::ref ( registry ) ), "4136994389" );
+    ( Tree::Registry::IO::writeLater, file, boost::ref ( registry ) ), "4136994389" );
 }
 
 
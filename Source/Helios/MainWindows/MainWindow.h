@@ -23,12 +23,14 @@
 #include "Helios/Menus/ToolBar.h"
 #include "Helios/Menus/Builder.h"
 
+#include "Usul/Atomic/Bool.h"
 #include "Usul/Atomic/Container.h"
 #include "Usul/Atomic/Integer.h"
 #include "Usul/Atomic/Object.h"
 #include "Usul/Interfaces/IActiveViewListener.h"
 #include "Usul/Jobs/Queue.h"
 #include "Usul/Pointers/Pointers.h"
+#include "Usul/Registry/Value.h"
 #include "Usul/Threads/Check.h"
 
 #include "QtGui/QMainWindow"
@@ -144,14 +146,20 @@ protected:
 
 private slots:
  
+  void                              _idleJobs();
   void                              _idleProcess();
 
 private:
 
   void                              _destroy();
 
+  void                              _idleNotify();
+
   Usul::Atomic::Integer<unsigned long> _refCount;
   QTimer *_idleTimer;
+  Usul::Registry::Value<int> _idleMilliseconds;
+  Usul::Registry::Node::Version _idleVersion;
+  Usul::Atomic::Bool _idlePosted;
   AtomicMenuBar _menuBar;
   AtomicToolBarMap _toolBars;
 };
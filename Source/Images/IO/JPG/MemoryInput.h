@@ -0,0 +1,151 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Source manager for memory input. The decompressor reads the bytes where
+//  they are, so they have to outlive it.
+//  See: http://svn.ghostscript.com/ghostscript/tags/jpeg-6b/jdatasrc.c
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _IMAGES_IO_JPG_READER_MEMORY_INPUT_CLASS_H_
+#define _IMAGES_IO_JPG_READER_MEMORY_INPUT_CLASS_H_
+
+#include "Usul/Exceptions/Exceptions.h"
+
+#ifdef _MSC_VER
+# pragma warning ( disable : 4005 )
+#endif
+
+extern "C"
+{
+  #include "jpeglib.h"
+}
+
+#include <cstddef>
+
+
+namespace Images {
+namespace IO {
+namespace JPG {
+
+
+struct MemoryInput : public jpeg_source_mgr
+{
+  typedef jpeg_source_mgr BaseClass;
+  typedef Usul::Exceptions::Error Exception;
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Nothing to do because all the bytes are there.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void init ( j_decompress_ptr )
+  {
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Called when the decompressor wants more than there is. Like the file
+  //  source, hand it an end marker so that a short file is only a warning.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static boolean fill ( j_decompress_ptr cinfo )
+  {
+    static const JOCTET endOfImage[2] = { 0xFF, JPEG_EOI };
+
+    MemoryInput *in ( reinterpret_cast < MemoryInput * > ( cinfo->src ) );
+    if ( 0x0 == in )
+      return FALSE;
+
+    in->next_input_byte = endOfImage;
+    in->bytes_in_buffer = 2;
+    return TRUE;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Skip over bytes the decompressor does not want.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void skip ( j_decompress_ptr cinfo, long count )
+  {
+    MemoryInput *in ( reinterpret_cast < MemoryInput * > ( cinfo->src ) );
+    if ( ( 0x0 == in ) || ( count <= 0 ) )
+      return;
+
+    if ( static_cast < std::size_t > ( count ) > in->bytes_in_buffer )
+    {
+      MemoryInput::fill ( cinfo );
+      return;
+    }
+
+    in->next_input_byte += count;
+    in->bytes_in_buffer -= count;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Nothing to do because we do not own the bytes.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void finish ( j_decompress_ptr )
+  {
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Set the decompressor's bytes.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void set ( j_decompress_ptr cinfo, const unsigned char *bytes, std::size_t size )
+  {
+    if ( 0x0 == cinfo->src )
+    {
+      cinfo->src = reinterpret_cast < jpeg_source_mgr * > (
+        (*cinfo->mem->alloc_small) (
+          reinterpret_cast < j_common_ptr > ( cinfo ),
+          JPOOL_PERMANENT,
+          sizeof ( MemoryInput ) ) );
+    }
+
+    MemoryInput *in ( reinterpret_cast < MemoryInput * > ( cinfo->src ) );
+    if ( 0x0 == in )
+    {
+      throw Exception ( "1067309185", "Failed to create input manager" );
+    }
+
+    in->init_source = &MemoryInput::init;
+    in->fill_input_buffer = &MemoryInput::fill;
+    in->skip_input_data = &MemoryInput::skip;
+    in->resync_to_restart = &::jpeg_resync_to_restart;
+    in->term_source = &MemoryInput::finish;
+    in->next_input_byte = bytes;
+    in->bytes_in_buffer = size;
+  }
+};
+
+
+} // namespace JPG
+} // namespace IO
+} // namespace Images
+
+
+#endif // _IMAGES_IO_JPG_READER_MEMORY_INPUT_CLASS_H_
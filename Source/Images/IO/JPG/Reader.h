@@ -17,11 +17,12 @@
 #define _IMAGES_IO_JPG_READER_CLASS_H_
 
 #include "Images/IO/JPG/Base.h"
+#include "Images/IO/JPG/MemoryInput.h"
 
 #include "Usul/Exceptions/Exceptions.h"
+#include "Usul/File/MappedFile.h"
 #include "Usul/Functions/NoThrow.h"
-
-#include "boost/shared_ptr.hpp"
+#include "Usul/Strings/Format.h"
 
 #ifdef _MSC_VER
 # pragma warning ( disable : 4005 )
@@ -32,7 +33,7 @@ extern "C"
   #include "jpeglib.h"
 }
 
-#include <cstdio>
+#include <cstddef>
 #include <stdexcept>
 
 
@@ -65,8 +66,8 @@ public:
 
   /////////////////////////////////////////////////////////////////////////////
   //
-  //  Reads the jpeg file and return the new image.
-  //  See: http://svn.ghostscript.com/ghostscript/tags/jpeg-6b/example.c
+  //  Reads the jpeg file and return the new image. The file is mapped 
+  //  into memory rather than read.
   //
   /////////////////////////////////////////////////////////////////////////////
 
@@ -74,50 +75,13 @@ public:
     const std::string &name, 
     Progress progress = Progress() )
   {
-    // Need to declare in this scope.
-    ImageType::RefPtr image;
-
     USUL_TRY_BLOCK
     {
-      // Set up reading with the jpeg library.
-      jpeg_decompress_struct cinfo;
-      jpeg_error_mgr jerr;
-      cinfo.err = jpeg_std_error ( &jerr );
-      cinfo.err->error_exit = &BaseClass::_jpegError;
-      ::jpeg_create_decompress ( &cinfo );
-
-      // Need local scope.
-      {
-        // Open file and set up decompression.
-        boost::shared_ptr < FILE > file 
-          ( ::fopen ( name.c_str(), "rb" ), ::fclose );
-        ::jpeg_stdio_src ( &cinfo, file.get() );
-        ::jpeg_read_header ( &cinfo, TRUE );
-        ::jpeg_start_decompress ( &cinfo );
-
-        // Needed below.
-        const unsigned int width ( cinfo.output_width );
-        const unsigned int height ( cinfo.output_height );
-        const unsigned int channels ( cinfo.out_color_components );
-        JSAMPROW ptr[1] = { 0x0 };
-
-        // Make our image and get shortcut to the data.
-        image = ImagePtr ( new ImageType ( width, height, channels ) );
-        Data &data ( image->data() );
-
-        // Read all the scan lines.
-        for ( unsigned int i = 0; i < height; ++i )
-        {
-          const unsigned int offset ( i * width * channels );
-          ptr[0] = ( &data[0] + offset );
-          ::jpeg_read_scanlines ( &cinfo, ptr, 1 );
-          progress ( i + 1, height );
-        }
-      }
-
-      // Clean up.
-      ::jpeg_finish_decompress ( &cinfo );
-      ::jpeg_destroy_decompress ( &cinfo );
+      Usul::File::MappedFile::RefPtr file ( new Usul::File::MappedFile 
+        ( name, Usul::File::MappedFile::SEQUENTIAL ) );
+      return Reader::readImageMemory ( 
+        reinterpret_cast < const unsigned char * > ( file->begin() ), 
+        file->length(), progress );
     }
     catch ( const Usul::Exceptions::Error &e )
     {
@@ -134,9 +98,64 @@ public:
       throw Usul::Exceptions::Error ( "4082697744", Usul::Strings::format (
         "Failed to open file: ", name ) );
     }
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Reads the jpeg bytes and return the new image. The bytes are not 
+  //  copied first.
+  //  See: http://svn.ghostscript.com/ghostscript/tags/jpeg-6b/example.c
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static ImagePtr readImageMemory ( 
+    const unsigned char *bytes, 
+    std::size_t size, 
+    Progress progress = Progress() )
+  {
+    if ( ( 0x0 == bytes ) || ( 0 == size ) )
+    {
+      throw Usul::Exceptions::Error ( "1582468231", "No bytes to read" );
+    }
+
+    // Set up reading with the jpeg library.
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error ( &jerr );
+    cinfo.err->error_exit = &BaseClass::_jpegError;
+    ::jpeg_create_decompress ( &cinfo );
+
+    // Set up decompression.
+    MemoryInput::set ( &cinfo, bytes, size );
+    ::jpeg_read_header ( &cinfo, TRUE );
+    ::jpeg_start_decompress ( &cinfo );
+
+    // Needed below.
+    const unsigned int width ( cinfo.output_width );
+    const unsigned int height ( cinfo.output_height );
+    const unsigned int channels ( cinfo.out_color_components );
+    JSAMPROW ptr[1] = { 0x0 };
+
+    // Make our image and get shortcut to the data.
+    ImagePtr image ( new ImageType ( width, height, channels ) );
+    Data &data ( image->data() );
+
+    // Read all the scan lines.
+    for ( unsigned int i = 0; i < height; ++i )
+    {
+      const unsigned int offset ( i * width * channels );
+      ptr[0] = ( &data[0] + offset );
+      ::jpeg_read_scanlines ( &cinfo, ptr, 1 );
+      progress ( i + 1, height );
+    }
+
+    // Clean up.
+    ::jpeg_finish_decompress ( &cinfo );
+    ::jpeg_destroy_decompress ( &cinfo );
 
     // Return the image.
-    return ImagePtr ( image );
+    return image;
   }
 };
 
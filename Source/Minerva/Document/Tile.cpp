@@ -26,6 +26,7 @@
 #include "Images/Interfaces/IImageWrite.h"
 
 #include "Usul/Functions/NoThrow.h"
+#include "Usul/Jobs/Parallel.h"
 #include "Usul/Plugins/Manager.h"
 
 #include "boost/bind.hpp"
@@ -58,6 +59,79 @@ namespace Helper
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper class that makes the mesh's points. Each point only depends on 
+//  its row and column, so the rows can be made in parallel.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  struct MakePoints
+  {
+    typedef Tile::Mesh Mesh;
+    typedef Tile::Extents Extents;
+    typedef Tile::MeshSize MeshSize;
+    typedef Minerva::Body::Ellipse Ellipse;
+    typedef Usul::Math::Vec3d Vec3d;
+    typedef Usul::Math::Vec3f Vec3f;
+    typedef Usul::Math::Vec2f Vec2f;
+
+    MakePoints ( const Ellipse &ellipse, const Extents &extents, const MeshSize &meshSize, const Vec3d &offset,
+                 Mesh::Vertices &vertices, Mesh::Normals &normals, Mesh::TexCoords &texCoords ) :
+      _ellipse ( ellipse ),
+      _extents ( extents ),
+      _meshSize ( meshSize ),
+      _offset ( offset ),
+      _vertices ( vertices ),
+      _normals ( normals ),
+      _texCoords ( texCoords )
+    {
+    }
+
+    void operator () ( std::size_t first, std::size_t last )
+    {
+      for ( std::size_t i = first; i < last; ++i )
+      {
+        const double u1 ( static_cast < double > ( i ) / ( _meshSize[0] - 1 ) );
+        const double lat ( _extents.minLat() + u1 * ( _extents.maxLat() - _extents.minLat() ) );
+
+        for ( unsigned int j = 0; j < _meshSize[1]; ++j )
+        {
+          const double u2 ( static_cast < double > ( j ) / ( _meshSize[1] - 1 ) );
+          const double lon ( _extents.minLon() + u2 * ( _extents.maxLon() - _extents.minLon() ) );
+          const Vec3d xyz ( _ellipse.toXYZ ( lon, lat, 0 ) );
+          const std::size_t index ( i * _meshSize[1] + j );
+
+          _vertices[index] = Vec3f ( static_cast < float > ( xyz[0] - _offset[0] ),
+                                     static_cast < float > ( xyz[1] - _offset[1] ),
+                                     static_cast < float > ( xyz[2] - _offset[2] ) );
+
+          const Vec3f n ( static_cast < float > ( xyz[0] ),
+                          static_cast < float > ( xyz[1] ),
+                          static_cast < float > ( xyz[2] ) );
+          _normals[index] = n.normalized();
+
+          _texCoords[index] = Vec2f ( static_cast < float > ( u2 ), 
+                                      static_cast < float > ( 1.0f - u1 ) );
+        }
+      }
+    }
+
+  private:
+
+    const Ellipse _ellipse;
+    const Extents _extents;
+    const MeshSize _meshSize;
+    const Vec3d _offset;
+    Mesh::Vertices &_vertices;
+    Mesh::Normals &_normals;
+    Mesh::TexCoords &_texCoords;
+  };
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Constructor
@@ -84,58 +158,31 @@ Tile::Tile ( Tile::RefPtr parent,
   using namespace SceneGraph::State;
   typedef Transform::Matrix Matrix;
   typedef Usul::Math::Vec3d Vec3d;
-  typedef Usul::Math::Vec3f Vec3f;
-  typedef Usul::Math::Vec2f Vec2f;
 
   const unsigned int numVerts ( meshSize[0] * meshSize[1] );
 
   Body::RefPtr body ( Helper::getBody ( _body, true ) );
   const Body::Ellipse ellipse ( body->ellipse() );
 
+  // The offset is the first point.
   Vec3d offset ( 0, 0, 0 );
-  Mesh::SharedVertices vertices ( new Mesh::Vertices );
-  Mesh::SharedNormals normals ( new Mesh::Normals );
-  Mesh::SharedTexCoords texCoords ( new Mesh::TexCoords );
-  vertices->reserve ( numVerts );
-  normals->reserve ( numVerts );
-  texCoords->reserve ( numVerts );
-
-  for ( unsigned int i = 0; i < meshSize[0]; ++i )
-  {
-    const double u1 ( static_cast < double > ( i ) / ( meshSize[0] - 1 ) );
-    const double lat ( extents.minLat() + u1 * ( extents.maxLat() - extents.minLat() ) );
-
-    for ( unsigned int j = 0; j < meshSize[1]; ++j )
-    {
-      const double u2 ( static_cast < double > ( j ) / ( meshSize[1] - 1 ) );
-      const double lon ( extents.minLon() + u2 * ( extents.maxLon() - extents.minLon() ) );
-      const Vec3d xyz ( ellipse.toXYZ ( lon, lat, 0 ) );
 #if 1
-      if ( ( 0 == i ) && ( 0 == j ) )
-      {
-        offset = xyz;
-      }
+  offset = ellipse.toXYZ ( extents.minLon(), extents.minLat(), 0 );
 #endif
-      const Vec3f v ( static_cast < float > ( xyz[0] - offset[0] ),
-                      static_cast < float > ( xyz[1] - offset[1] ),
-                      static_cast < float > ( xyz[2] - offset[2] ) );
-      vertices->push_back ( v );
-
-      const Vec3f n ( static_cast < float > ( xyz[0] ),
-                      static_cast < float > ( xyz[1] ),
-                      static_cast < float > ( xyz[2] ) );
-      normals->push_back ( n.normalized() );
-
-      texCoords->push_back ( Vec2f ( static_cast < float > ( u2 ), 
-                                     static_cast < float > ( 1.0f - u1 ) ) );
-    }
-  }
 
-  Mesh::RefPtr &mesh ( _mesh.getReference() );
-  mesh = Mesh::RefPtr ( new Mesh ( meshSize ) );
+  Mesh::SharedVertices vertices ( new Mesh::Vertices ( numVerts ) );
+  Mesh::SharedNormals normals ( new Mesh::Normals ( numVerts ) );
+  Mesh::SharedTexCoords texCoords ( new Mesh::TexCoords ( numVerts ) );
+
+  // Make the rows in parallel.
+  Usul::Jobs::parallelFor ( 0, meshSize[0], Helper::MakePoints 
+    ( ellipse, extents, meshSize, offset, *vertices, *normals, *texCoords ), 1 );
+
+  Mesh::RefPtr mesh ( new Mesh ( meshSize ) );
   mesh->verticesSet ( vertices );
   mesh->normalsSet ( normals );
   mesh->texCoordsSet ( texCoords );
+  _mesh = mesh;
 
   StateSet::RefPtr state ( mesh->stateSet() );
   //state->attributeAdd ( new PolygonMode ( Face::BOTH, Mode::LINES ) );
@@ -150,8 +197,9 @@ Tile::Tile ( Tile::RefPtr parent,
 
   // Add the branch for this tile and not the children. 
   // Later, if we split, we do the opposite.
-  _root.getReference()->append ( thisBranch );
-  //_root.getReference()->drawBoundingSphereSet ( 2 == level );
+  Group::RefPtr root ( _root );
+  root->append ( thisBranch );
+  //root->drawBoundingSphereSet ( 2 == level );
 
 #if 1
 
@@ -384,8 +432,7 @@ void Tile::split ( unsigned int numTimes )
 
   // Remove this tile's branch from the root and add the one for children.
   {
-    Guard guard ( _root.mutex() );
-    Group::RefPtr &root ( _root.getReference() );
+    Group::RefPtr root ( _root );
     if ( false == root.valid() )
       return;
     root->remove ( root->find ( Transform::RefPtr ( _thisBranch ) ) );
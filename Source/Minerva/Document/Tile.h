@@ -24,6 +24,8 @@
 #include "Usul/Atomic/Container.h"
 #include "Usul/Atomic/Integer.h"
 #include "Usul/Atomic/Object.h"
+#include "Usul/Atomic/Pointer.h"
+#include "Usul/Atomic/SeqLock.h"
 #include "Usul/Base/Referenced.h"
 #include "Usul/Interfaces/IClearObject.h"
 #include "Usul/Interfaces/IDestroyObject.h"
@@ -98,11 +100,11 @@ private:
   Usul::Atomic::Object < Tile::RefPtr > _parent;
   Usul::Atomic::Object < IUnknown::RefPtr > _body;
   Usul::Atomic::Integer < unsigned int > _level;
-  Usul::Atomic::Object < Extents > _extents;
-  Usul::Atomic::Object < Group::RefPtr > _root;
-  Usul::Atomic::Object < Transform::RefPtr > _thisBranch;
-  Usul::Atomic::Object < Group::RefPtr > _childBranch;
-  Usul::Atomic::Object < Mesh::RefPtr > _mesh;
+  Usul::Atomic::SeqLockObject < Extents > _extents;
+  Usul::Atomic::Pointer < Group::RefPtr > _root;
+  Usul::Atomic::Pointer < Transform::RefPtr > _thisBranch;
+  Usul::Atomic::Pointer < Group::RefPtr > _childBranch;
+  Usul::Atomic::Pointer < Mesh::RefPtr > _mesh;
   Usul::Atomic::Container < TileVector > _children;
 };
 
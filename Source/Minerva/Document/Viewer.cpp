@@ -48,6 +48,7 @@
 #include "Usul/Plugins/Manager.h"
 #include "Usul/Scope/Caller.h"
 #include "Usul/Scope/Reset.h"
+#include "Usul/System/Clock.h"
 #include "Usul/System/Sleep.h"
 
 #include "QtCore/QUrl"
@@ -80,6 +81,10 @@ Viewer::Viewer ( QWidget *parent, Minerva::Document::RefPtr doc ) :
   _buttons ( 0 ),
   _viewport ( Viewport ( Usul::Math::Vec4i ( 0, 0, 100, 100 ), true ) ),
   _renderJobs(),
+  _renderJobsCoalesce ( true ),
+  _renderRequest ( Matrix::getIdentity(), 0 ),
+  _renderJobPending(),
+  _renderJobActive(),
   _updateJobs(),
   _renderer(),
   _internalViewer(),
@@ -506,7 +511,7 @@ void Viewer::_destroy()
   Helper::cancelAndWait ( _renderQueue, inertialJob );
 
   // Cancel and wait for the render jobs.
-  JobList jobs ( _renderJobs.fetchAndStore ( JobList() ) );
+  JobList jobs ( this->_renderJobsTake() );
   std::for_each ( jobs.begin(), jobs.end(), boost::bind ( Helper::cancelAndWait, _renderQueue, _1 ) );
 
   // Done with these.
@@ -622,6 +627,35 @@ const Usul::Documents::Document *Viewer::documentGet() const
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions for render deadlines.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // A frame should start within the time it is allowed. Zero means it 
+  // has no limit and so no deadline.
+  inline Usul::Types::UInt64 deadline ( Viewer::ClockTics timeAllowed )
+  {
+    return ( ( timeAllowed > 0 ) ? 
+      ( Usul::System::Clock::microseconds() + timeAllowed * 1000 ) : 0 );
+  }
+
+  // Give the waiting job the earlier deadline, since it is rendering for 
+  // all the requests it replaced.
+  inline void earlier ( Usul::Jobs::Queue::RefPtr queue, Viewer::Job::RefPtr job, Usul::Types::UInt64 deadline )
+  {
+    const Usul::Types::UInt64 current ( job->deadlineGet() );
+    if ( ( deadline > 0 ) && ( ( 0 == current ) || ( deadline < current ) ) )
+    {
+      queue->reschedule ( job, deadline );
+    }
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Add the render job.
@@ -640,9 +674,65 @@ void Viewer::renderJobAdd ( const Matrix &nav, ClockTics timeAllowed )
   AtomicJobs::Guard guard ( _renderJobs.mutex() );
   JobList &jobs ( _renderJobs.getReference() );
 
-  // Add a new job.
-  jobs.insert ( queue->add ( boost::bind 
-    ( &Viewer::_render, this, nav, timeAllowed, _1 ) ) );
+  // The render queue may order the jobs by deadline.
+  const Usul::Types::UInt64 deadline ( Helper::deadline ( timeAllowed ) );
+
+  // Without coalescing every request gets its own job.
+  if ( false == _renderJobsCoalesce )
+  {
+    Job::RefPtr job ( Usul::Jobs::makeJob ( 0, boost::bind 
+      ( &Viewer::_render, this, nav, timeAllowed, _1 ) ) );
+    job->deadlineSet ( deadline );
+    jobs.insert ( job );
+    queue->add ( job );
+    return;
+  }
+
+  // The latest request wins. If a job is waiting then it will render this.
+  _renderRequest = RenderRequest ( nav, timeAllowed );
+  if ( true == _renderJobPending.valid() )
+  {
+    Helper::earlier ( queue, _renderJobPending, deadline );
+    return;
+  }
+
+  // Make a job that starts after the one that is rendering, if any.
+  Job::RefPtr job ( Usul::Jobs::makeJob ( 0, boost::bind 
+    ( &Viewer::_renderLatest, this, _1 ) ) );
+  job->deadlineSet ( deadline );
+  job->after ( _renderJobActive );
+  _renderJobPending = job;
+  jobs.insert ( job );
+  queue->add ( job );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Render the latest request.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Viewer::_renderLatest ( Job::RefPtr job )
+{
+  RenderRequest request;
+  {
+    // This job is no longer waiting, so new requests need another one.
+    Guard guard ( _renderJobs.mutex() );
+    if ( job.get() == _renderJobPending.get() )
+      _renderJobPending = Job::RefPtr();
+    _renderJobActive = job;
+    request = _renderRequest;
+  }
+
+  // Cancelled jobs just remove themselves.
+  if ( true == job->isCancelled() )
+  {
+    this->_renderJobFinished ( job );
+    return;
+  }
+
+  this->_render ( request.first, request.second, job );
 }
 
 
@@ -663,6 +753,54 @@ void Viewer::_renderJobFinished ( Job::RefPtr job )
   JobList::iterator i ( std::find ( jobs.begin(), jobs.end(), job ) );
   if ( jobs.end() != i )
     jobs.erase ( i );
+
+  // Clear the slot it was in.
+  if ( job.get() == _renderJobPending.get() )
+    _renderJobPending = Job::RefPtr();
+  if ( job.get() == _renderJobActive.get() )
+    _renderJobActive = Job::RefPtr();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove and return all the render jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Viewer::JobList Viewer::_renderJobsTake()
+{
+  Guard guard ( _renderJobs.mutex() );
+  JobList jobs;
+  jobs.swap ( _renderJobs.getReference() );
+  _renderRequest = RenderRequest ( Matrix::getIdentity(), 0 );
+  _renderJobPending = Job::RefPtr();
+  _renderJobActive = Job::RefPtr();
+  return jobs;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get coalescing of render jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Viewer::renderJobsCoalesceGet() const
+{
+  return _renderJobsCoalesce;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set coalescing of render jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Viewer::renderJobsCoalesceSet ( bool state )
+{
+  _renderJobsCoalesce = state;
 }
 
 
@@ -687,14 +825,10 @@ unsigned int Viewer::renderJobsCount() const
 void Viewer::renderJobsCancel()
 {
   // Stop intertial motion.
-  Job::RefPtr inertialJob ( _inertialJob.fetchAndStore ( Job::RefPtr() ) );
-  if ( true == inertialJob.valid() )
-  {
-    inertialJob->cancel();
-  }
+  this->_inertialJobCancel();
 
   // Get and reset the collection of jobs.
-  JobList jobs ( _renderJobs.fetchAndStore ( JobList() ) );
+  JobList jobs ( this->_renderJobsTake() );
 
   // Get the queue.
   Usul::Jobs::Queue::RefPtr queue ( _renderQueue );
@@ -816,7 +950,8 @@ void Viewer::paintEvent ( QPaintEvent * )
 
   const Matrix nav ( this->navigationMatrixGet() );
 
-  if ( this->renderJobsCount() < 2 )
+  // When coalescing the waiting job is updated, so always add.
+  if ( ( true == this->renderJobsCoalesceGet() ) || ( this->renderJobsCount() < 2 ) )
     this->renderJobAdd ( nav, 0 );
 }
 
@@ -1011,7 +1146,7 @@ void Viewer::mouseMoveEvent ( QMouseEvent *e )
     ClockTics timeAllowed ( 1000 / Constants::TARGET_FRAME_RATE );
 
     // Asynchronous render if there are no existing jobs.
-    if ( this->renderJobsCount() < 2 )
+    if ( ( true == this->renderJobsCoalesceGet() ) || ( this->renderJobsCount() < 2 ) )
       this->renderJobAdd ( nav, timeAllowed );
   }
   USUL_DEFINE_CATCH_BLOCKS ( "3723080959" );
@@ -1075,7 +1210,7 @@ void Viewer::mouseReleaseEvent ( QMouseEvent *e )
       const Matrix nav ( this->navigationMatrixGet() );
 
       // Asynchronous render if there are not too many jobs.
-      if ( this->renderJobsCount() < 2 )
+      if ( ( true == this->renderJobsCoalesceGet() ) || ( this->renderJobsCount() < 2 ) )
         this->renderJobAdd ( nav, 0 );
 
       return;
@@ -1188,9 +1323,13 @@ void Viewer::wheelEvent ( QWheelEvent *e )
     // Handle the event.
     this->_mouseMoveEvent ( data );
 
-    // Asynchronous render.
+    // Asynchronous render. When coalescing the waiting job is updated, 
+    // so there is nothing to cancel but the inertial motion.
     const Matrix nav ( this->navigationMatrixGet() );
-    this->renderJobsCancel();
+    if ( true == this->renderJobsCoalesceGet() )
+      this->_inertialJobCancel();
+    else
+      this->renderJobsCancel();
     this->renderJobAdd ( nav, 1000 / Constants::TARGET_FRAME_RATE );
   }
   USUL_DEFINE_CATCH_BLOCKS ( "1046048141" );
@@ -1735,6 +1874,22 @@ void Viewer::_inertialJobAdd ( const MouseEventData &data )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel the intertial job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Viewer::_inertialJobCancel()
+{
+  Job::RefPtr inertialJob ( _inertialJob.fetchAndStore ( Job::RefPtr() ) );
+  if ( true == inertialJob.valid() )
+  {
+    inertialJob->cancel();
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Update the mouse coordinate by interpolating. This is called during 
@@ -29,6 +29,7 @@
 #include "Usul/Atomic/Container.h"
 #include "Usul/Atomic/Integer.h"
 #include "Usul/Atomic/Object.h"
+#include "Usul/Atomic/SeqLock.h"
 #include "Usul/Interfaces/IActiveViewListener.h"
 #include "Usul/Interfaces/IDocumentGet.h"
 #include "Usul/Interfaces/IModifiedListener.h"
@@ -46,6 +47,7 @@
 #include "boost/noncopyable.hpp"
 
 #include <list>
+#include <utility>
 #include <vector>
 
 
@@ -93,6 +95,7 @@ public:
   typedef std::vector < double > IndepVars;
   typedef std::vector < MenuItem::RefPtr > MenuItems;
   typedef SceneGraph::State::StateSet StateSet;
+  typedef std::pair < Matrix, ClockTics > RenderRequest;
 
   // Smart-pointer definitions.
   USUL_REFERENCED_CLASS ( Viewer );
@@ -144,6 +147,11 @@ public:
   void                        renderJobsCancel();
   unsigned int                renderJobsCount() const;
 
+  // Get/set coalescing of render jobs. When on, a new request replaces the 
+  // one that has not started yet. On by default.
+  bool                        renderJobsCoalesceGet() const;
+  void                        renderJobsCoalesceSet ( bool );
+
   // Get the state-set.
   StateSet::RefPtr            stateSet ( bool createIfNeeded = true );
 
@@ -173,6 +181,7 @@ protected:
   virtual void                wheelEvent ( QWheelEvent * );
 
   void                        _inertialJobAdd ( const MouseEventData & );
+  void                        _inertialJobCancel();
   void                        _inertialMotion ( Job::RefPtr job, const MouseEventData & );
 
   void                        _menuButtonsAdd();
@@ -182,6 +191,8 @@ protected:
 
   void                        _render ( const Matrix &nav, ClockTics timeAllowed, Job::RefPtr job );
   void                        _renderJobFinished ( Job::RefPtr job );
+  void                        _renderLatest ( Job::RefPtr job );
+  JobList                     _renderJobsTake();
 
   void                        _toolBarButtonsAdd();
   void                        _toolBarButtonsRemove();
@@ -193,12 +204,16 @@ private:
   Usul::Threads::Check _threadCheck;
   Usul::Atomic::Integer < unsigned long > _refCount;
   Usul::Atomic::Object < Minerva::Document::RefPtr > _document;
-  Usul::Atomic::Object < Matrix > _projection;
-  Usul::Atomic::Object < Matrix > _navigation;
+  Usul::Atomic::SeqLockObject < Matrix > _projection;
+  Usul::Atomic::SeqLockObject < Matrix > _navigation;
   Usul::Atomic::Object < MouseCoordinates > _mouse;
   Usul::Atomic::Integer < int > _buttons;
   Usul::Atomic::Object < Viewport > _viewport;
   Usul::Atomic::Container < JobList > _renderJobs;
+  Usul::Atomic::Bool _renderJobsCoalesce;
+  RenderRequest _renderRequest;   // These three use the mutex of _renderJobs.
+  Job::RefPtr _renderJobPending;
+  Job::RefPtr _renderJobActive;
   Usul::Atomic::Container < JobList > _updateJobs;
   Usul::Atomic::Object < InternalViewer::RefPtr > _internalViewer;
   Usul::Atomic::Object < JobQueue::RefPtr > _renderQueue;
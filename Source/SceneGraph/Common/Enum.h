@@ -29,7 +29,7 @@ struct VisitMode
   enum Mode
   {
     LOCK_CHILDREN, // Lock container of children then visit them.
-    COPY_CHILDREN  // Lock, copy child smare-pointers, visit them.
+    COPY_CHILDREN  // Visit a copy or snapshot of the children.
   };
 };
 
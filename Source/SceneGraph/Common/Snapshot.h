@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A reference counted value that does not change once it is made. Share
+//  it without a lock, and make a new one to change it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCENE_GRAPH_SNAPSHOT_CLASS_H_
+#define _SCENE_GRAPH_SNAPSHOT_CLASS_H_
+
+#include "SceneGraph/Base/Object.h"
+
+#include "Usul/Config/Config.h"
+
+
+namespace SceneGraph {
+namespace Common {
+
+
+template < class T > class Snapshot : public SceneGraph::Base::Object
+{
+public:
+
+  SCENE_GRAPH_OBJECT ( Snapshot, SceneGraph::Base::Object );
+  typedef T ValueType;
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Constructors.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  Snapshot() : BaseClass(),
+    _value()
+  {
+  }
+  explicit Snapshot ( const ValueType &v ) : BaseClass(),
+    _value ( v )
+  {
+  }
+  #ifdef USUL_HAS_RVALUE_REFERENCES
+  explicit Snapshot ( ValueType &&v ) : BaseClass(),
+    _value ( USUL_MOVE ( v ) )
+  {
+  }
+  #endif
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Get the value.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  const ValueType &get() const
+  {
+    return _value;
+  }
+
+protected:
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Destructor. Use reference counting.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  virtual ~Snapshot()
+  {
+  }
+
+private:
+
+  const ValueType _value;
+};
+
+
+} // namespace Common
+} // namespace SceneGraph
+
+
+#endif // _SCENE_GRAPH_SNAPSHOT_CLASS_H_
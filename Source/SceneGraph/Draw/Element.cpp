@@ -30,8 +30,8 @@ Element::Element ( Shape::RefPtr shape,
                    StateContainer::RefPtr stateContainer,
                    const Matrix &matrix,
                    int importance ) : BaseClass(),
-  _shape ( shape ),
-  _stateContainer ( stateContainer ),
+  _shape ( USUL_MOVE ( shape ) ),
+  _stateContainer ( USUL_MOVE ( stateContainer ) ),
   _matrix ( matrix ),
   _importance ( importance )
 {
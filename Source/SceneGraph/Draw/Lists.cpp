@@ -26,7 +26,7 @@ using namespace SceneGraph::Draw;
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-typedef Usul::Threads::Guard<Usul::Threads::Mutex> Guard;
+typedef SceneGraph::Draw::Lists::AtomicElementLists::Guard Guard;
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -70,7 +70,7 @@ void Lists::append ( int key, Element::RefPtr element )
     Guard guard ( _elementLists.mutex() );
     ElementLists &els ( _elementLists.getReference() );
     ElementList &el ( els[key] );
-    el.push_back ( element );
+    el.push_back ( USUL_MOVE ( element ) );
   }
 }
 
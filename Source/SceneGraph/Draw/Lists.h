@@ -19,6 +19,7 @@
 #include "SceneGraph/Draw/Element.h"
 
 #include "Usul/Atomic/Container.h"
+#include "Usul/Threads/FastMutex.h"
 
 #include <map>
 #include <vector>
@@ -35,7 +36,7 @@ public:
   SCENE_GRAPH_OBJECT ( Lists, SceneGraph::Base::Object );
   typedef std::vector < Element::RefPtr > ElementList;
   typedef std::map < int, ElementList > ElementLists;
-  typedef Usul::Atomic::Container < ElementLists > AtomicElementLists;
+  typedef Usul::Atomic::Container < ElementLists, Usul::Threads::FastMutex > AtomicElementLists;
 
   // Default construction.
   Lists();
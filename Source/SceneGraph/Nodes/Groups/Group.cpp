@@ -33,7 +33,8 @@ using namespace SceneGraph::Nodes::Groups;
 ///////////////////////////////////////////////////////////////////////////////
 
 Group::Group() : BaseClass(),
-  _nodes()
+  _mutex(),
+  _children ( Children::RefPtr ( new Children() ) )
 {
 }
 
@@ -58,7 +59,7 @@ Group::~Group()
 
 void Group::_destroy()
 {
-  _nodes.clear();
+  _children = Children::RefPtr();
 }
 
 
@@ -70,7 +71,32 @@ void Group::_destroy()
 
 void Group::clear()
 {
-  _nodes.clear();
+  Guard guard ( _mutex );
+  _children = Children::RefPtr ( new Children() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Publish the new children. Call this with the mutex locked.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Group::_publish ( Nodes &nodes )
+{
+  _children = Children::RefPtr ( new Children ( USUL_MOVE ( nodes ) ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the children as they are now.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Group::Children::RefPtr Group::children() const
+{
+  return _children;
 }
 
 
@@ -86,9 +112,9 @@ void Group::insert ( unsigned int position, Node::RefPtr node )
   if ( ( false == node.valid() ) || ( node.get() == this ) )
     return;
 
-  // Lock the nodes.
-  Guard guard ( _nodes.mutex() );
-  Nodes &nodes ( _nodes.getReference() );
+  // Lock and copy the nodes.
+  Guard guard ( _mutex );
+  Nodes nodes ( this->children()->get() );
 
   // Adjust the index if needed.
   const unsigned int numChildren ( nodes.size() );
@@ -101,11 +127,13 @@ void Group::insert ( unsigned int position, Node::RefPtr node )
   Nodes::iterator i ( nodes.begin() );
   std::advance ( i, position );
 
-  // Insert at the iterator.
-  nodes.insert ( i, node );
+  // Insert at the iterator. The container takes our reference.
+  Node *child ( node.get() );
+  nodes.insert ( i, USUL_MOVE ( node ) );
+  this->_publish ( nodes );
 
   // We are a parent.
-  node->parentAdd ( this );
+  child->parentAdd ( this );
 
   // We have dirty bounds.
   this->dirtyBounds ( true, true );
@@ -124,13 +152,15 @@ void Group::append ( Node::RefPtr node )
   if ( ( false == node.valid() ) || ( node.get() == this ) )
     return;
 
-  // Lock and append.
-  Guard guard ( _nodes.mutex() );
-  Nodes &nodes ( _nodes.getReference() );
-  nodes.insert ( nodes.end(), node );
+  // Lock and append. The container takes our reference.
+  Node *child ( node.get() );
+  Guard guard ( _mutex );
+  Nodes nodes ( this->children()->get() );
+  nodes.insert ( nodes.end(), USUL_MOVE ( node ) );
+  this->_publish ( nodes );
 
   // We are a parent.
-  node->parentAdd ( this );
+  child->parentAdd ( this );
 
   // We have dirty bounds.
   this->dirtyBounds ( true, true );
@@ -149,13 +179,15 @@ void Group::prepend ( Node::RefPtr node )
   if ( ( false == node.valid() ) || ( node.get() == this ) )
     return;
 
-  // Lock and prepend.
-  Guard guard ( _nodes.mutex() );
-  Nodes &nodes ( _nodes.getReference() );
-  nodes.insert ( nodes.begin(), node );
+  // Lock and prepend. The container takes our reference.
+  Node *child ( node.get() );
+  Guard guard ( _mutex );
+  Nodes nodes ( this->children()->get() );
+  nodes.insert ( nodes.begin(), USUL_MOVE ( node ) );
+  this->_publish ( nodes );
 
   // We are a parent.
-  node->parentAdd ( this );
+  child->parentAdd ( this );
 
   // We have dirty bounds.
   this->dirtyBounds ( true, true );
@@ -170,9 +202,9 @@ void Group::prepend ( Node::RefPtr node )
 
 unsigned int Group::find ( Node::RefPtr node ) const
 {
-  // Lock and get shortcut.
-  Guard guard ( _nodes.mutex() );
-  const Nodes &nodes ( _nodes.getReference() );
+  // Get the children and a shortcut.
+  const Children::RefPtr children ( this->children() );
+  const Nodes &nodes ( children->get() );
 
   // Loop through the nodes.
   typedef Nodes::const_iterator Itr;
@@ -199,9 +231,9 @@ unsigned int Group::find ( Node::RefPtr node ) const
 
 void Group::remove ( unsigned int index ) 
 {
-  // Lock the nodes.
-  Guard guard ( _nodes.mutex() );
-  Nodes &nodes ( _nodes.getReference() );
+  // Lock and copy the nodes.
+  Guard guard ( _mutex );
+  Nodes nodes ( this->children()->get() );
 
   // Handle index out of range.
   if ( index >= nodes.size() )
@@ -220,6 +252,7 @@ void Group::remove ( unsigned int index )
 
   // Erase the child.
   nodes.erase ( i );
+  this->_publish ( nodes );
 
   // We are no longer a parent.
   if ( true == child.valid() )
@@ -238,7 +271,7 @@ void Group::remove ( unsigned int index )
 
 unsigned int Group::size() const
 {
-  return _nodes.size();
+  return this->children()->get().size();
 }
 
 
@@ -250,7 +283,7 @@ unsigned int Group::size() const
 
 bool Group::empty() const
 {
-  return _nodes.empty();
+  return this->children()->get().empty();
 }
 
 
@@ -262,9 +295,9 @@ bool Group::empty() const
 
 SceneGraph::Nodes::Node::RefPtr Group::at ( unsigned int index ) const
 {
-  // Lock nodes.
-  Guard guard ( _nodes.mutex() );
-  const Nodes &nodes ( _nodes.getReference() );
+  // Get the children and a shortcut.
+  const Children::RefPtr children ( this->children() );
+  const Nodes &nodes ( children->get() );
 
   // Check index.
   if ( index >= nodes.size() )
@@ -290,9 +323,8 @@ SceneGraph::Nodes::Node::RefPtr Group::at ( unsigned int index ) const
 
 void Group::nodes ( Group::Nodes &to ) const
 {
-  // Lock and copy.
-  Guard guard ( _nodes.mutex() );
-  const Nodes &from ( _nodes.getReference() );
+  const Children::RefPtr children ( this->children() );
+  const Nodes &from ( children->get() );
   to.assign ( from.begin(), from.end() );
 }
 
@@ -412,8 +444,9 @@ void Group::_updateBoundingSphere()
 {
   typedef Usul::Math::Sphered Sphered;
 
-  // Copy the nodes.
-  Nodes nodes ( _nodes );
+  // Get the children and a shortcut.
+  const Children::RefPtr children ( this->children() );
+  const Nodes &nodes ( children->get() );
 
   // Initialize the new bounds.
   BoundingSphere ourBounds ( false, Sphered() );
@@ -479,8 +512,9 @@ void Group::_updateBoundingSphere()
 
 void Group::_updateBoundingBox()
 {
-  // Copy the node pointers.
-  Nodes nodes ( _nodes );
+  // Get the children and a shortcut.
+  const Children::RefPtr children ( this->children() );
+  const Nodes &nodes ( children->get() );
 
   // Initialize the new bounds.
   BoundingBox bbox;
@@ -511,15 +545,16 @@ void Group::_updateBoundingBox()
 
 namespace Helper
 {
-  template < class V, class N > inline void accept ( V &v, N &n )
+  template < class V, class N > inline void accept ( V &v, const N &n )
   {
-    typedef typename N::iterator Itr;
-    typedef typename N::value_type NodePtr;
+    typedef typename N::const_iterator Itr;
+    typedef typename N::value_type::element_type NodeType;
 
+    // The snapshot holds the references, so use the pointers.
     for ( Itr i = n.begin(); i != n.end(); ++i )
     {
-      NodePtr &node ( *i );
-      if ( true == node.valid() )
+      NodeType *node ( const_cast < NodeType * > ( i->get() ) );
+      if ( 0x0 != node )
       {
         node->accept ( v );
       }
@@ -538,13 +573,14 @@ void Group::accept ( SceneGraph::Visitors::Visitor &v, VisitMode::Mode mode )
 {
   if ( VisitMode::COPY_CHILDREN == mode )
   {
-    Nodes nodes ( _nodes );
-    Helper::accept ( v, nodes );
+    const Children::RefPtr children ( this->children() );
+    Helper::accept ( v, children->get() );
   }
   else if ( VisitMode::LOCK_CHILDREN == mode )
   {
-    Guard guard ( _nodes.mutex() );
-    Helper::accept ( v, _nodes.getReference() );
+    Guard guard ( _mutex );
+    const Children::RefPtr children ( this->children() );
+    Helper::accept ( v, children->get() );
   }
   else
   {
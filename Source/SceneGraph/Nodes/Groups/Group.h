@@ -17,9 +17,11 @@
 #define _SCENE_GRAPH_GROUP_CLASS_H_
 
 #include "SceneGraph/Common/Enum.h"
+#include "SceneGraph/Common/Snapshot.h"
 #include "SceneGraph/Nodes/Node.h"
 
-#include "Usul/Atomic/Container.h"
+#include "Usul/Atomic/Pointer.h"
+#include "Usul/Threads/Mutex.h"
 
 
 namespace SceneGraph {
@@ -34,6 +36,7 @@ public:
   SCENE_GRAPH_NODE ( Group, Node );
 
   typedef SCENE_GRAPH_GROUP_CONTAINER_TYPE Nodes;
+  typedef SceneGraph::Common::Snapshot < Nodes > Children;
   typedef SceneGraph::Nodes::Node Node;
   typedef SceneGraph::Common::VisitMode VisitMode;
 
@@ -49,6 +52,9 @@ public:
   // Return the child at the given index.
   Node::RefPtr                  at ( unsigned int ) const;
 
+  // Return the children as they are now. Later changes do not affect it.
+  Children::RefPtr              children() const;
+
   // Are we empty?
   bool                          empty() const;
 
@@ -85,7 +91,12 @@ private:
 
   void                          _destroy();
 
-  Usul::Atomic::Container < Nodes > _nodes;
+  void                          _publish ( Nodes & );
+
+  // Changes copy the children, change the copy, and publish it as a new
+  // snapshot. Readers only take the snapshot.
+  Usul::Threads::Mutex _mutex;
+  Usul::Atomic::Pointer < Children::RefPtr > _children;
 };
 
 
@@ -21,6 +21,7 @@
 #include "Usul/Atomic/Container.h"
 #include "Usul/Atomic/Integer.h"
 #include "Usul/Atomic/Object.h"
+#include "Usul/Atomic/SeqLock.h"
 #include "Usul/Math/Box.h"
 #include "Usul/Math/Sphere.h"
 
@@ -86,8 +87,8 @@ protected:
   virtual void                  _updateBoundingSphere(){}
 
   Usul::Atomic::Integer < unsigned int > _flags;
-  Usul::Atomic::Object < BoundingSphere > _bSphere;
-  Usul::Atomic::Object < BoundingBox > _bBox;
+  Usul::Atomic::SeqLockObject < BoundingSphere > _bSphere;
+  Usul::Atomic::SeqLockObject < BoundingBox > _bBox;
   Usul::Atomic::Container < Parents > _parents;
 };
 
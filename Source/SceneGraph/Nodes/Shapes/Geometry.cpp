@@ -17,10 +17,14 @@
 
 #include "Usul/Exceptions/Exceptions.h"
 #include "Usul/Functions/NoThrow.h"
+#include "Usul/Jobs/Parallel.h"
 #include "Usul/Strings/Format.h"
 
 #include "boost/bind.hpp"
 
+#include <utility>
+#include <vector>
+
 
 using namespace SceneGraph::Nodes::Shapes;
 
@@ -101,39 +105,14 @@ namespace Helper
 {
   struct SortTriangles
   {
-    typedef Geometry::Matrix Matrix;
-    typedef Geometry::Vertices Vertices;
-    typedef Geometry::Vertex Vertex;
-    typedef Usul::Math::Vector3<Matrix::value_type> Vec3;
-    SortTriangles ( const Matrix &m, const Vertices &v ) : 
-      _m ( m ), _v ( v )
-    {
-    }
-    template < class Triangle > bool operator () 
-      ( const Triangle &ta, const Triangle &tb )
+    typedef Geometry::Matrix::value_type Distance;
+    typedef Usul::Math::Vec3ui Triangle;
+    typedef std::pair < Distance, Triangle > SortedTriangle;
+    bool operator () ( const SortedTriangle &a, const SortedTriangle &b ) const
     {
-      // Get the average vertex for triangle a.
-      const Vertex tav0 ( _v.at ( ta[0] ) );
-      const Vertex tav1 ( _v.at ( ta[1] ) );
-      const Vertex tav2 ( _v.at ( ta[2] ) );
-      const Vertex tavm ( ( tav0 + tav1 + tav2 ) * 0.33f );
-
-      // Get the average vertex for triangle b.
-      const Vertex tbv0 ( _v.at ( tb[0] ) );
-      const Vertex tbv1 ( _v.at ( tb[1] ) );
-      const Vertex tbv2 ( _v.at ( tb[2] ) );
-      const Vertex tbvm ( ( tbv0 + tbv1 + tbv2 ) * 0.33f );
-
-      // Convert the average vertives to global space.
-      const Vec3 vag ( _m * Vec3 ( tavm[0], tavm[1], tavm[2] ) );
-      const Vec3 vbg ( _m * Vec3 ( tbvm[0], tbvm[1], tbvm[2] ) );
-
       // Return false if a is closer to origin that b.
-      return ( vag.dot ( vag ) < vbg.dot ( vbg ) );
+      return ( a.first < b.first );
     }
-  private:
-    Matrix _m;
-    const Vertices &_v;
   };
 }
 
@@ -162,8 +141,12 @@ namespace Helper
     typedef SharedVertices::AtomicVector AtomicVertices;
     typedef Geometry::Vertices Vertices;
     typedef Usul::Threads::Guard < AtomicPrimitives::Mutex > Guard;
-    typedef Usul::Math::Vec3ui Triangle;
-    typedef std::vector < Triangle > Triangles;
+    typedef Geometry::Vertex Vertex;
+    typedef Helper::SortTriangles::Triangle Triangle;
+    typedef Helper::SortTriangles::SortedTriangle SortedTriangle;
+    typedef std::vector < SortedTriangle > Triangles;
+    typedef Usul::Math::Vector3 < Geometry::Matrix::value_type > Center;
+    typedef std::vector < Center > Centers;
 
     // Require a valid target.
     if ( false == target.valid() )
@@ -196,10 +179,11 @@ namespace Helper
     Vertices &vertices ( atomicVertices.getReference() );
 
     // Predicate used to sort triangles.
-    Helper::SortTriangles pred ( m, vertices );
+    Helper::SortTriangles pred;
 
     // Declare triangles up here.
     Triangles triangles;
+    Centers centers;
 
     // Loop through the primitives.
     for ( Itr i = sourcePrims.begin(); i != sourcePrims.end(); ++i )
@@ -209,27 +193,43 @@ namespace Helper
       const unsigned int numVertices ( sourcePrim.second.size() );
       if ( ( Geometry::TRIANGLES == sourcePrim.first ) && ( 0 == numVertices % 3 ) )
       {
-        // Make sequence of triangles.
+        // Make sequence of triangles and their average vertices.
         triangles.clear();
+        centers.clear();
         const unsigned int numTriangles ( numVertices / 3 );
         triangles.reserve ( numTriangles );
+        centers.reserve ( numTriangles );
         for ( unsigned int i = 0; i < numVertices; i += 3 )
         {
-          triangles.push_back ( Triangle ( 
+          const Triangle t (
             sourcePrim.second.at ( i     ),
             sourcePrim.second.at ( i + 1 ),
-            sourcePrim.second.at ( i + 2 ) ) );
+            sourcePrim.second.at ( i + 2 ) );
+          const Vertex c ( ( vertices.at ( t[0] ) + vertices.at ( t[1] ) + vertices.at ( t[2] ) ) * 0.33f );
+          triangles.push_back ( SortedTriangle ( 0, t ) );
+          centers.push_back ( Center ( c[0], c[1], c[2] ) );
+        }
+
+        // Convert the average vertices to global space all at once, instead
+        // of every time two triangles are compared.
+        if ( false == centers.empty() )
+        {
+          m.transform ( &centers[0], centers.size(), &centers[0] );
+        }
+        for ( unsigned int j = 0; j < numTriangles; ++j )
+        {
+          triangles[j].first = centers[j].dot ( centers[j] );
         }
 
         // Sort triangles.
-        std::sort ( triangles.begin(), triangles.end(), pred );
+        Usul::Jobs::parallelSort ( triangles.begin(), triangles.end(), pred );
 
         // Copy sorted indices back to target primitive.
         targetPrims.push_back ( Primitive ( sourcePrim.first, Indices() ) );
         Indices &targetIndices ( targetPrims.back().second );
         for ( unsigned int j = 0; j < numTriangles; ++j )
         {
-          const Triangle &t ( triangles.at ( j ) );
+          const Triangle &t ( triangles.at ( j ).second );
           targetIndices.push_back ( t[0] );
           targetIndices.push_back ( t[1] );
           targetIndices.push_back ( t[2] );
@@ -401,6 +401,87 @@ void Geometry::verticesSet ( SharedVertices::RefPtr v )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions for finding the bounds of the vertices in parallel.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  typedef Geometry::Vertex Vertex;
+  typedef Geometry::Vertices Vertices;
+  typedef Geometry::BoundingBox BoundingBox;
+
+  // Add up the vertices in double precision.
+  struct SumVertices
+  {
+    SumVertices ( const Vertices &v ) : _v ( v ){}
+    void operator () ( std::size_t first, std::size_t last, Usul::Math::Vec3d &sum ) const
+    {
+      for ( std::size_t i = first; i < last; ++i )
+      {
+        const Vertex &pt ( _v[i] );
+        sum[0] += pt[0];
+        sum[1] += pt[1];
+        sum[2] += pt[2];
+      }
+    }
+  private:
+    const Vertices &_v;
+  };
+
+  // Find the largest squared distance from the point.
+  struct MaxDistanceSquared
+  {
+    MaxDistanceSquared ( const Vertices &v, const Vertex &center ) : _v ( v ), _center ( center ){}
+    void operator () ( std::size_t first, std::size_t last, float &maxDist ) const
+    {
+      for ( std::size_t i = first; i < last; ++i )
+      {
+        const float dist ( _center.distanceSquared ( _v[i] ) );
+        if ( dist > maxDist )
+          maxDist = dist;
+      }
+    }
+  private:
+    const Vertices &_v;
+    const Vertex _center;
+  };
+
+  // Grow the box to hold the vertices.
+  struct GrowBox
+  {
+    GrowBox ( const Vertices &v ) : _v ( v ){}
+    void operator () ( std::size_t first, std::size_t last, BoundingBox &bbox ) const
+    {
+      for ( std::size_t i = first; i < last; ++i )
+      {
+        const Vertex &pf ( _v[i] );
+        const BoundingBox::Vector pd ( pf[0], pf[1], pf[2] );
+        bbox = BoundingBox::bounds ( bbox, pd );
+      }
+    }
+  private:
+    const Vertices &_v;
+  };
+
+  // Functions that combine the answers from each thread.
+  inline Usul::Math::Vec3d addVectors ( const Usul::Math::Vec3d &a, const Usul::Math::Vec3d &b )
+  {
+    return a + b;
+  }
+  inline float maxFloat ( float a, float b )
+  {
+    return ( ( a > b ) ? a : b );
+  }
+  inline BoundingBox addBoxes ( const BoundingBox &a, const BoundingBox &b )
+  {
+    return BoundingBox::bounds ( a, b );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Update the bounding sphere.
@@ -413,21 +494,15 @@ void Geometry::_updateBoundingSphere()
   SharedVertices::RefPtr sv ( _vertices );
   if ( false == sv.valid() )
     return;
-  const SharedVertices::AtomicVector av ( sv->get() );
-  Guard guard ( av.mutex() );
-  const Vertices &v ( av.getReference() );
+
+  // Copy them so that they are not locked while the threads work.
+  const Vertices v ( sv->get() );
   if ( true == v.empty() )
     return;
 
   // Find average vertex in double precision.
-  Usul::Math::Vec3d da ( 0, 0, 0 );
-  for ( Vertices::const_iterator i = v.begin(); i != v.end(); ++i )
-  {
-    const Vertex &pt ( *i );
-    da[0] += pt[0];
-    da[1] += pt[1];
-    da[2] += pt[2];
-  }
+  Usul::Math::Vec3d da ( Usul::Jobs::parallelReduce ( 0, v.size(), 
+    Usul::Math::Vec3d ( 0, 0, 0 ), Helper::SumVertices ( v ), &Helper::addVectors ) );
   da /= v.size();
 
   // Convert to single precision.
@@ -437,14 +512,8 @@ void Geometry::_updateBoundingSphere()
       static_cast < Vertex::value_type > ( da[2] ) );
 
   // Find max distance between average and all others.
-  float maxDist ( 0 );
-  for ( Vertices::const_iterator i = v.begin(); i != v.end(); ++i )
-  {
-    const Vertex &pt ( *i );
-    const float dist ( average.distanceSquared ( pt ) );
-    if ( dist > maxDist )
-      maxDist = dist;
-  }
+  float maxDist ( Usul::Jobs::parallelReduce ( 0, v.size(), 0.0f, 
+    Helper::MaxDistanceSquared ( v, average ), &Helper::maxFloat ) );
   maxDist = ( ( maxDist > 0 ) ? Usul::Math::sqrt ( maxDist ) : 0 );
 
   // Set new bounding sphere.
@@ -468,23 +537,15 @@ void Geometry::_updateBoundingBox()
   SharedVertices::RefPtr sv ( _vertices );
   if ( false == sv.valid() )
     return;
-  const SharedVertices::AtomicVector av ( sv->get() );
-  Guard guard ( av.mutex() );
-  const Vertices &v ( av.getReference() );
+
+  // Copy them so that they are not locked while the threads work.
+  const Vertices v ( sv->get() );
   if ( true == v.empty() )
     return;
 
-  // Initialize bounding box.
-  BoundingBox bbox;
-
-  // Loop through the vertices.
-  for ( Vertices::const_iterator i = v.begin(); i != v.end(); ++i )
-  {
-    // Grow the bounding box.
-    const Vertex &pf ( *i );
-    const BoundingBox::Vector pd ( pf[0], pf[1], pf[2] );
-    bbox = BoundingBox::bounds ( bbox, pd );
-  }
+  // Grow the bounding box around the vertices.
+  const BoundingBox bbox ( Usul::Jobs::parallelReduce ( 0, v.size(), 
+    BoundingBox(), Helper::GrowBox ( v ), &Helper::addBoxes ) );
 
   // Set new bounding box.
   this->boundingBoxSet ( bbox );
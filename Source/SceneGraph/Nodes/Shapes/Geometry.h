@@ -21,6 +21,7 @@
 
 #include "Usul/Atomic/Container.h"
 #include "Usul/Atomic/Object.h"
+#include "Usul/Atomic/Pointer.h"
 #include "Usul/Math/Matrix44.h"
 #include "Usul/Math/Vector2.h"
 #include "Usul/Math/Vector3.h"
@@ -135,11 +136,11 @@ protected:
 
 private:
 
-  Usul::Atomic::Object < SharedVertices::RefPtr > _vertices;
-  Usul::Atomic::Object < SharedNormals::RefPtr > _normals;
-  Usul::Atomic::Object < SharedTexCoords::RefPtr > _texCoords;
-  Usul::Atomic::Object < SharedColors::RefPtr > _colors;
-  Usul::Atomic::Object < SharedPrimitives::RefPtr > _primitives;
+  Usul::Atomic::Pointer < SharedVertices::RefPtr > _vertices;
+  Usul::Atomic::Pointer < SharedNormals::RefPtr > _normals;
+  Usul::Atomic::Pointer < SharedTexCoords::RefPtr > _texCoords;
+  Usul::Atomic::Pointer < SharedColors::RefPtr > _colors;
+  Usul::Atomic::Pointer < SharedPrimitives::RefPtr > _primitives;
   Usul::Atomic::Object < SortPrimitivesCallback > _sortPrimitivesCallback;
 };
 
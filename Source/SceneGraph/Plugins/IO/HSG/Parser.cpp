@@ -33,7 +33,7 @@
 #include "Usul/Convert/Vector3.h"
 #include "Usul/Convert/Vector4.h"
 #include "Usul/Functions/NoThrow.h"
-#include "Usul/IO/TextReader.h"
+#include "Usul/IO/TextParser.h"
 #include "Usul/Math/Constants.h"
 #include "Usul/Plugins/Manager.h"
 #include "Usul/Strings/Format.h"
@@ -68,22 +68,6 @@ typedef SceneGraph::State::Attributes::Light Light;
 typedef SceneGraph::State::Attributes::Blending Blending;
 
 
-///////////////////////////////////////////////////////////////////////////////
-//
-//  Definitions for reading a vector of vectors.
-//
-///////////////////////////////////////////////////////////////////////////////
-
-typedef std::vector < Usul::Math::Vec2f > VectorVec2f;
-typedef std::vector < Usul::Math::Vec3f > VectorVec3f;
-typedef std::vector < Usul::Math::Vec4f > VectorVec4f;
-typedef std::vector < unsigned int >      VectorUInt;
-USUL_IO_TEXT_DEFINE_READER_TYPE_SEQUENCE ( VectorVec2f );
-USUL_IO_TEXT_DEFINE_READER_TYPE_SEQUENCE ( VectorVec3f );
-USUL_IO_TEXT_DEFINE_READER_TYPE_SEQUENCE ( VectorVec4f );
-USUL_IO_TEXT_DEFINE_READER_TYPE_SEQUENCE ( VectorUInt  );
-
-
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  String conversion for face enumerations.
@@ -1323,10 +1307,7 @@ namespace Helper
 
     // Read indices.
     Indices indices;
-    {
-      std::istringstream in ( tni->value() );
-      Usul::IO::Text::Reader::read ( in, indices );
-    }
+    Usul::IO::Text::Parser::sequence ( tni->value(), indices );
 
     // Convert the string to a primitive mode.
     Geometry::Mode mode ( Helper::convertPrimitiveMode ( tnm->value() ) );
@@ -1363,8 +1344,7 @@ Parser::SceneNode::RefPtr Parser::_buildGeometry ( const TreeNode &tn )
     if ( true == child.valid() )
     {
       Geometry::Vertices vertices;
-      std::istringstream in ( child->value() );
-      Usul::IO::Text::Reader::read ( in, vertices );
+      Usul::IO::Text::Parser::sequence ( child->value(), vertices );
       geometry->verticesSet ( new Geometry::SharedVertices ( vertices ) );
     }
   }
@@ -1376,8 +1356,7 @@ Parser::SceneNode::RefPtr Parser::_buildGeometry ( const TreeNode &tn )
     if ( true == child.valid() )
     {
       Geometry::Normals normals;
-      std::istringstream in ( child->value() );
-      Usul::IO::Text::Reader::read ( in, normals );
+      Usul::IO::Text::Parser::sequence ( child->value(), normals );
       geometry->normalsSet ( new Geometry::SharedNormals ( normals ) );
     }
   }
@@ -1389,8 +1368,7 @@ Parser::SceneNode::RefPtr Parser::_buildGeometry ( const TreeNode &tn )
     if ( true == child.valid() )
     {
       Geometry::Colors colors;
-      std::istringstream in ( child->value() );
-      Usul::IO::Text::Reader::read ( in, colors );
+      Usul::IO::Text::Parser::sequence ( child->value(), colors );
       geometry->colorsSet ( new Geometry::SharedColors ( colors ) );
     }
   }
@@ -1402,8 +1380,7 @@ Parser::SceneNode::RefPtr Parser::_buildGeometry ( const TreeNode &tn )
     if ( true == child.valid() )
     {
       Geometry::TexCoords texCoords;
-      std::istringstream in ( child->value() );
-      Usul::IO::Text::Reader::read ( in, texCoords );
+      Usul::IO::Text::Parser::sequence ( child->value(), texCoords );
       geometry->texCoordsSet ( new Geometry::SharedTexCoords ( texCoords ) );
     }
   }
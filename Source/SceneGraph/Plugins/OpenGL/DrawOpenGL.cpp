@@ -1534,12 +1534,15 @@ void DrawOpenGL::_drawElements ( ElementList &el )
   typedef ElementList::iterator Itr;
   typedef ElementList::value_type ElementPtr;
 
+  // The navigation matrix is the same for all of them.
+  const Matrix n ( this->navigationMatrixGet() );
+
   for ( Itr i = el.begin(); i != el.end(); ++i )
   {
     ElementPtr &e ( *i );
     if ( true == e.valid() )
     {
-      this->_drawElement ( *e );
+      this->_drawElement ( *e, n );
     }
   }
 }
@@ -1551,14 +1554,12 @@ void DrawOpenGL::_drawElements ( ElementList &el )
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void DrawOpenGL::_drawElement ( Element &e )
+void DrawOpenGL::_drawElement ( Element &e, const Matrix &n )
 {
   typedef Element::Shape Shape;
-  typedef Element::Matrix Matrix;
 
   // Load the matrix.
-  const Matrix n ( this->navigationMatrixGet() );
-  _currentModelview = n * e.matrix();
+  Matrix::multiply ( n, e.matrix(), _currentModelview );
   ::glLoadMatrixd ( _currentModelview.get() );
 
   // If the state-container is different...
@@ -83,7 +83,7 @@ protected:
   // Use reference counting.
   virtual ~DrawOpenGL();
 
-  void                    _drawElement ( Element & );
+  void                    _drawElement ( Element &, const Matrix &navigation );
   void                    _drawElements ( ElementList & );
 
   GLuint                  _getProgramId ( Program::RefPtr );
@@ -49,6 +49,10 @@ Viewer::Viewer ( IUnknown::RefPtr context ) : BaseClass(),
   _eventListeners(),
   _renderQueue ( Usul::Jobs::Manager::instance()["render_queue"] ),
   _renderJobs(),
+  _renderJobsCoalesce ( true ),
+  _renderRequest(),
+  _renderJobPending(),
+  _renderJobActive(),
   _context ( context ),
   _scene(),
   _projection ( new Functors::Perspective ( 45, 1, 2, 10000 ) ),
@@ -130,7 +134,7 @@ namespace Helper
 void Viewer::_destroy()
 {
   // Cancel and wait for the render jobs.
-  JobList jobs ( _renderJobs.fetchAndStore ( JobList() ) );
+  JobList jobs ( this->_renderJobsTake() );
   std::for_each ( jobs.begin(), jobs.end(), 
     boost::bind ( Helper::cancelAndWait, _renderQueue, _1 ) );
 
@@ -556,6 +560,35 @@ Viewer::Job::RefPtr Viewer::renderJobAdd
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions for render deadlines.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // A frame should start within the time it is allowed. Zero means it 
+  // has no limit and so no deadline.
+  inline Usul::Types::UInt64 deadline ( Viewer::ClockTics timeAllowed )
+  {
+    return ( ( timeAllowed > 0 ) ? 
+      ( Usul::System::Clock::microseconds() + timeAllowed * 1000 ) : 0 );
+  }
+
+  // Give the waiting job the earlier deadline, since it is rendering for 
+  // all the requests it replaced.
+  inline void earlier ( Usul::Jobs::Queue::RefPtr queue, Viewer::Job::RefPtr job, Usul::Types::UInt64 deadline )
+  {
+    const Usul::Types::UInt64 current ( job->deadlineGet() );
+    if ( ( deadline > 0 ) && ( ( 0 == current ) || ( deadline < current ) ) )
+    {
+      queue->reschedule ( job, deadline );
+    }
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Add the render job.
@@ -583,16 +616,71 @@ Viewer::Job::RefPtr Viewer::renderJobAdd
 #endif
 #endif
 
-  // Add a new job.
-  Job::RefPtr job ( queue->add ( boost::bind 
-    ( &Viewer::_render, this, nav, proj, timeAllowed, _1 ) ) );
+  // The render queue may order the jobs by deadline.
+  const Usul::Types::UInt64 deadline ( Helper::deadline ( timeAllowed ) );
+
+  // Without coalescing every request gets its own job.
+  if ( false == _renderJobsCoalesce )
+  {
+    Job::RefPtr job ( Usul::Jobs::makeJob ( 0, boost::bind 
+      ( &Viewer::_render, this, nav, proj, timeAllowed, _1 ) ) );
+    job->deadlineSet ( deadline );
+    jobs.insert ( job );
+    queue->add ( job );
+    return job;
+  }
+
+  // The latest request wins. If a job is waiting then it will render this.
+  _renderRequest = RenderRequest ( nav, proj, timeAllowed );
+  if ( true == _renderJobPending.valid() )
+  {
+    Helper::earlier ( queue, _renderJobPending, deadline );
+    return _renderJobPending;
+  }
+
+  // Make a job that starts after the one that is rendering, if any.
+  Job::RefPtr job ( Usul::Jobs::makeJob ( 0, boost::bind 
+    ( &Viewer::_renderLatest, this, _1 ) ) );
+  job->deadlineSet ( deadline );
+  job->after ( _renderJobActive );
+  _renderJobPending = job;
   jobs.insert ( job );
+  queue->add ( job );
 
   // Return this new job.
   return job;
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Render the latest request.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Viewer::_renderLatest ( Job::RefPtr job )
+{
+  RenderRequest request;
+  {
+    // This job is no longer waiting, so new requests need another one.
+    Guard guard ( _renderJobs.mutex() );
+    if ( job.get() == _renderJobPending.get() )
+      _renderJobPending = Job::RefPtr();
+    _renderJobActive = job;
+    request = _renderRequest;
+  }
+
+  // Cancelled jobs just remove themselves.
+  if ( true == job->isCancelled() )
+  {
+    this->_renderJobFinished ( job );
+    return;
+  }
+
+  this->_render ( request.get<0>(), request.get<1>(), request.get<2>(), job );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Call when the job finished.
@@ -609,6 +697,54 @@ void Viewer::_renderJobFinished ( Job::RefPtr job )
   JobList::iterator i ( std::find ( jobs.begin(), jobs.end(), job ) );
   if ( jobs.end() != i )
     jobs.erase ( i );
+
+  // Clear the slot it was in.
+  if ( job.get() == _renderJobPending.get() )
+    _renderJobPending = Job::RefPtr();
+  if ( job.get() == _renderJobActive.get() )
+    _renderJobActive = Job::RefPtr();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove and return all the render jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Viewer::JobList Viewer::_renderJobsTake()
+{
+  Guard guard ( _renderJobs.mutex() );
+  JobList jobs;
+  jobs.swap ( _renderJobs.getReference() );
+  _renderRequest = RenderRequest();
+  _renderJobPending = Job::RefPtr();
+  _renderJobActive = Job::RefPtr();
+  return jobs;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get coalescing of render jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Viewer::renderJobsCoalesceGet() const
+{
+  return _renderJobsCoalesce;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set coalescing of render jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Viewer::renderJobsCoalesceSet ( bool state )
+{
+  _renderJobsCoalesce = state;
 }
 
 
@@ -662,7 +798,7 @@ void Viewer::renderJobCancel ( Job::RefPtr job )
 void Viewer::renderJobsCancel()
 {
   // Get and reset the collection of jobs.
-  JobList jobs ( _renderJobs.fetchAndStore ( JobList() ) );
+  JobList jobs ( this->_renderJobsTake() );
 
   // Get the queue.
   Usul::Jobs::Queue::RefPtr queue ( _renderQueue );
@@ -1059,7 +1195,8 @@ void Viewer::_onResize ( Event::RefPtr e )
 
 void Viewer::_onPaint ( Event::RefPtr )
 {
-  if ( this->renderJobsCount() < 2 )
+  // When coalescing the waiting job is updated, so always add.
+  if ( ( true == this->renderJobsCoalesceGet() ) || ( this->renderJobsCount() < 2 ) )
   {
     const Matrix n ( this->navigationMatrixGet() );
     const Matrix p ( this->projectionMatrixGet() );
@@ -27,8 +27,11 @@
 #include "SceneGraph/Visitors/CullVisitor.h"
 #include "SceneGraph/Visitors/UpdateVisitor.h"
 
+#include "Usul/Atomic/Bool.h"
 #include "Usul/Atomic/Container.h"
 #include "Usul/Atomic/Object.h"
+#include "Usul/Atomic/Pointer.h"
+#include "Usul/Atomic/SharedObject.h"
 #include "Usul/Commands/Commands.h"
 #include "Usul/Jobs/Queue.h"
 #include "Usul/Math/Matrix44.h"
@@ -85,6 +88,13 @@ public:
   typedef std::vector < ListenerValue > ListenerSequence;
   typedef std::map < std::string, ListenerSequence > EventListeners;
   typedef Usul::Math::Vec4d Viewport;
+  typedef boost::tuples::tuple
+  <
+    IMatrixGet::RefPtr, // Navigation
+    IMatrixGet::RefPtr, // Projection
+    ClockTics           // Time allowed
+  >
+  RenderRequest;
 
   // Usul::Interfaces::IUnknown
   USUL_DECLARE_IUNKNOWN_MEMBERS;
@@ -138,6 +148,12 @@ public:
   void                        renderJobsCancel();
   unsigned int                renderJobsCount() const;
 
+  // Get/set coalescing of render jobs. When on, a new request replaces the 
+  // one that has not started yet, so there is at most one job rendering and 
+  // one waiting. The waiting job renders the latest request. On by default.
+  bool                        renderJobsCoalesceGet() const;
+  void                        renderJobsCoalesceSet ( bool );
+
   // Get/set the scene.
   Node::RefPtr                sceneGet();
   void                        sceneSet ( Node::RefPtr );
@@ -159,6 +175,8 @@ protected:
 
   void                        _render ( IMatrixGet::RefPtr navigation, IMatrixGet::RefPtr projection, ClockTics timeAllowed, Job::RefPtr job );
   void                        _renderJobFinished ( Job::RefPtr job );
+  void                        _renderLatest ( Job::RefPtr job );
+  JobList                     _renderJobsTake();
 
 private:
 
@@ -167,14 +185,18 @@ private:
   Usul::Atomic::Container < UpdatePipeline > _updatePipeline;
   Usul::Atomic::Container < CullPipeline > _cullPipeline;
   Usul::Atomic::Container < DrawPipeline > _drawPipeline;
-  Usul::Atomic::Object < DrawLists::RefPtr > _drawLists;
+  Usul::Atomic::Pointer < DrawLists::RefPtr > _drawLists;
   Usul::Atomic::Container < EventListeners > _eventListeners;
   Usul::Atomic::Object < JobQueue::RefPtr > _renderQueue;
   Usul::Atomic::Container < JobList > _renderJobs;
+  Usul::Atomic::Bool _renderJobsCoalesce;
+  RenderRequest _renderRequest;   // These three use the mutex of _renderJobs.
+  Job::RefPtr _renderJobPending;
+  Job::RefPtr _renderJobActive;
   Usul::Atomic::Object < IContext::QueryPtr > _context;
-  Usul::Atomic::Object < Node::RefPtr > _scene;
-  Usul::Atomic::Object < IMatrixGet::QueryPtr > _projection;
-  Usul::Atomic::Object < IMatrixGet::QueryPtr > _navigation;
+  Usul::Atomic::Pointer < Node::RefPtr > _scene;
+  Usul::Atomic::SharedObject < IMatrixGet::QueryPtr > _projection;
+  Usul::Atomic::SharedObject < IMatrixGet::QueryPtr > _navigation;
   Usul::Atomic::Object < ClockTics > _timeAllowed;
   Usul::Atomic::Object < Viewport > _viewport;
 };
@@ -20,6 +20,7 @@
 #include "SceneGraph/Draw/Lists.h"
 
 #include "Usul/Atomic/Object.h"
+#include "Usul/Atomic/SeqLock.h"
 #include "Usul/Math/Matrix44.h"
 #include "Usul/Math/Vector4.h"
 
@@ -65,9 +66,9 @@ protected:
 
 private:
 
-  Usul::Atomic::Object < Matrix > _navigation;
-  Usul::Atomic::Object < Matrix > _projection;
-  Usul::Atomic::Object < Viewport > _viewport;
+  Usul::Atomic::SeqLockObject < Matrix > _navigation;
+  Usul::Atomic::SeqLockObject < Matrix > _projection;
+  Usul::Atomic::SeqLockObject < Viewport > _viewport;
   Usul::Atomic::Object < DrawLists::RefPtr > _drawLists;
 };
 
@@ -85,7 +85,7 @@ namespace Helper
       const int index ( shape->drawListIndexGet() );
       DrawElement::RefPtr de ( new DrawElement 
         ( shape, stateContainer, matrix, importance ) );
-      dl->append ( index, de );
+      dl->append ( index, USUL_MOVE ( de ) );
     }
   }
 }
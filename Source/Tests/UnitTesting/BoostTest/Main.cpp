@@ -13,8 +13,15 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "Tests/UnitTesting/BoostTest/UsulAtomic.h"
+#include "Tests/UnitTesting/BoostTest/UsulConvert.h"
+#include "Tests/UnitTesting/BoostTest/UsulIO.h"
+#include "Tests/UnitTesting/BoostTest/UsulJobs.h"
 #include "Tests/UnitTesting/BoostTest/UsulMath.h"
+#include "Tests/UnitTesting/BoostTest/UsulRegistry.h"
+#include "Tests/UnitTesting/BoostTest/UsulStrings.h"
 #include "Tests/UnitTesting/BoostTest/SceneGraph.h"
+#include "Tests/UnitTesting/BoostTest/TreeRegistry.h"
 #include "Tests/UnitTesting/BoostTest/XmlTree.h"
 
 #include "boost/test/included/unit_test_framework.hpp"
@@ -51,8 +58,47 @@ boost::unit_test::test_suite *init_unit_test_suite ( int, char ** const )
   ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Math::test002 ) );
   ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Math::test003 ) );
   ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Math::test004 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Math::test005 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Atomic::test001 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Atomic::test002 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Atomic::test003 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Atomic::test004 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Atomic::test005 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Atomic::test006 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Atomic::test007 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Convert::test001 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Convert::test002 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Convert::test003 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::IO::test001 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::IO::test002 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::IO::test003 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::IO::test004 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::IO::test005 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::IO::test006 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::IO::test007 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test001 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test002 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test003 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test004 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test005 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test006 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test007 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test008 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test009 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test010 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test011 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Jobs::test012 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Registry::test001 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Registry::test002 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Strings::test001 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Strings::test002 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Strings::test003 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Usul::Strings::test004 ) );
   ts.add ( BOOST_TEST_CASE ( &Tests::SceneGraph::test001 ) );
   ts.add ( BOOST_TEST_CASE ( &Tests::SceneGraph::test002 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::SceneGraph::test003 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Tree::Registry::test001 ) );
+  ts.add ( BOOST_TEST_CASE ( &Tests::Tree::Registry::test002 ) );
   ts.add ( BOOST_TEST_CASE ( &Tests::XmlTree::test001 ) );
   ts.add ( BOOST_TEST_CASE ( &Tests::XmlTree::test002 ) );
   ts.add ( BOOST_TEST_CASE ( &Tests::XmlTree::test003 ) );
@@ -16,7 +16,12 @@
 #include "SceneGraph/Nodes/Sphere.h"
 #include "SceneGraph/Nodes/Transform.h"
 
+#include "Usul/Atomic/Bool.h"
+#include "Usul/Atomic/Integer.h"
+
+#include "boost/bind.hpp"
 #include "boost/test/unit_test.hpp"
+#include "boost/thread/thread.hpp"
 
 
 namespace Tests {
@@ -190,5 +195,74 @@ inline void test002()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Threads read the children of a group while another 
+//  changes them. A snapshot of the children never changes and keeps them 
+//  alive.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  typedef ::Usul::Atomic::Integer < unsigned long > Counter;
+
+  inline void changeChildren ( Group::RefPtr group, ::Usul::Atomic::Bool &done )
+  {
+    for ( unsigned int i = 0; i < 2000; ++i )
+    {
+      group->append ( Group::RefPtr ( new Group ) );
+      group->insert ( 0, Group::RefPtr ( new Group ) );
+      group->prepend ( Group::RefPtr ( new Group ) );
+      group->remove ( 1 );
+      if ( 0 == ( i % 100 ) )
+      {
+        group->clear();
+      }
+    }
+    done = true;
+  }
+
+  inline void readChildren ( Group::RefPtr group, const ::Usul::Atomic::Bool &done, Counter &bad )
+  {
+    while ( false == done )
+    {
+      const Group::Children::RefPtr children ( group->children() );
+      const Group::Nodes &nodes ( children->get() );
+      const std::size_t size ( nodes.size() );
+      for ( Group::Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
+      {
+        if ( ( false == i->valid() ) || ( 0 == (*i)->refCount() ) )
+        {
+          ++bad;
+        }
+      }
+      if ( size != children->get().size() )
+      {
+        ++bad;
+      }
+    }
+  }
+}
+
+inline void test003()
+{
+  Group::RefPtr group ( new Group );
+  ::Usul::Atomic::Bool done ( false );
+  Details::Counter bad ( 0 );
+
+  boost::thread_group threads;
+  for ( unsigned int i = 0; i < 4; ++i )
+  {
+    threads.create_thread ( boost::bind ( &Details::readChildren, group, boost::cref ( done ), boost::ref ( bad ) ) );
+  }
+  threads.create_thread ( boost::bind ( &Details::changeChildren, group, boost::ref ( done ) ) );
+  threads.join_all();
+
+  BOOST_CHECK_EQUAL ( 0u, static_cast < unsigned long > ( bad ) );
+  BOOST_CHECK_EQUAL ( group->size(), group->children()->get().size() );
+}
+
+
 } // namespace SceneGraph
 } // namespace Tests
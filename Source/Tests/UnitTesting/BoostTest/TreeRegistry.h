@@ -0,0 +1,162 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test functions for the binary snapshot of the registry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Tree/Registry/Binary.h"
+
+#include "Usul/File/Temp.h"
+#include "Usul/Registry/Database.h"
+#include "Usul/Registry/Node.h"
+#include "Usul/Scope/RemoveFile.h"
+
+#include "boost/filesystem.hpp"
+#include "boost/test/unit_test.hpp"
+
+#include <fstream>
+
+
+namespace Tests {
+namespace Tree {
+namespace Registry {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helpers for the tests below.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  typedef ::Usul::Registry::Node Node;
+  typedef ::Tree::Registry::Binary Binary;
+
+  inline void fill ( ::Usul::Registry::Database &db )
+  {
+    db["program"]["name"] = std::string ( "Helios" );
+    db["program"]["version"] = 3;
+    db["window"]["size"]["width"] = 800;
+    db["window"]["size"]["height"] = 600;
+    db["window"]["title"] = std::string ( "spaces and\nnew lines" );
+    db["empty"];
+  }
+
+  // Are the names, values and children of the nodes the same?
+  inline bool equal ( const Node &a, const Node &b )
+  {
+    if ( ( a.name() != b.name() ) || ( a.get ( std::string() ) != b.get ( std::string() ) ) )
+      return false;
+
+    const Node::Children ca ( a.children() );
+    const Node::Children cb ( b.children() );
+    if ( ca.size() != cb.size() )
+      return false;
+
+    for ( Node::ConstIterator i = ca.begin(), j = cb.begin(); i != ca.end(); ++i, ++j )
+    {
+      if ( ( i->first != j->first ) || ( false == i->second.valid() ) || ( false == j->second.valid() ) )
+        return false;
+      if ( false == Details::equal ( *(i->second), *(j->second) ) )
+        return false;
+    }
+    return true;
+  }
+
+  inline void writeText ( const std::string &file, const std::string &text )
+  {
+    std::ofstream out ( file.c_str() );
+    out << text;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Encode the registry, write it, read it into another one,
+//  and compare. The snapshot is current until the text file changes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test001()
+{
+  const std::string text ( ::Usul::File::Temp::file() );
+  const std::string snapshot ( Details::Binary::snapshotFile ( text ) );
+  ::Usul::Scope::RemoveFile removeText ( text );
+  ::Usul::Scope::RemoveFile removeSnapshot ( snapshot );
+
+  ::Usul::Registry::Database original;
+  Details::fill ( original );
+
+  // The buffer decodes to the same tree.
+  Details::Binary::Buffer buffer;
+  Details::Binary::encode ( *original.root(), buffer );
+  {
+    Details::Node::RefPtr decoded ( new Details::Node );
+    Details::Binary::decode ( buffer, *decoded );
+    BOOST_CHECK ( Details::equal ( *original.root(), *decoded ) );
+  }
+
+  // So does the file.
+  Details::writeText ( text, "<registry/>\n" );
+  Details::Binary::write ( snapshot, buffer, text );
+  {
+    ::Usul::Registry::Database copy;
+    BOOST_CHECK_EQUAL ( true, Details::Binary::read ( snapshot, copy ) );
+    BOOST_CHECK ( Details::equal ( *original.root(), *copy.root() ) );
+  }
+
+  // Changing the text file makes the snapshot old.
+  BOOST_CHECK_EQUAL ( true, Details::Binary::isCurrent ( snapshot, text ) );
+  Details::writeText ( text, "<registry>changed</registry>\n" );
+  BOOST_CHECK_EQUAL ( false, Details::Binary::isCurrent ( snapshot, text ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Reading a truncated snapshot throws and does not change
+//  the registry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test002()
+{
+  const std::string snapshot ( ::Usul::File::Temp::file() );
+  ::Usul::Scope::RemoveFile removeSnapshot ( snapshot );
+
+  ::Usul::Registry::Database original;
+  Details::fill ( original );
+  Details::Binary::write ( snapshot, original, std::string() );
+
+  const boost::uintmax_t size ( boost::filesystem::file_size ( snapshot ) );
+  BOOST_REQUIRE ( size > 1 );
+
+  // Cut it off in the header, and in the nodes.
+  const boost::uintmax_t sizes[] = { 4, 12, size / 2, size - 1 };
+  for ( unsigned int i = 0; i < sizeof ( sizes ) / sizeof ( sizes[0] ); ++i )
+  {
+    boost::filesystem::resize_file ( snapshot, sizes[i] );
+
+    ::Usul::Registry::Database db;
+    db["program"]["name"] = std::string ( "before" );
+    BOOST_CHECK_THROW ( Details::Binary::read ( snapshot, db ), std::exception );
+    BOOST_CHECK_EQUAL ( std::string ( "before" ), db["program"]["name"].get ( std::string() ) );
+    BOOST_CHECK_EQUAL ( 1u, db.root()->numChildren() );
+  }
+}
+
+
+} // namespace Registry
+} // namespace Tree
+} // namespace Tests
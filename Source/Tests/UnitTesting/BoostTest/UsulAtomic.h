@@ -0,0 +1,535 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test functions for Usul's atomic classes and mutexes. Several threads 
+//  read and write the same object at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Atomic/Bool.h"
+#include "Usul/Atomic/Integer.h"
+#include "Usul/Atomic/Pointer.h"
+#include "Usul/Atomic/SeqLock.h"
+#include "Usul/Atomic/SharedObject.h"
+#include "Usul/Base/Ref/Checked.h"
+#include "Usul/Base/Referenced.h"
+#include "Usul/Exceptions/Exceptions.h"
+#include "Usul/Threads/FastMutex.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/LockProfiler.h"
+#include "Usul/Threads/Mutex.h"
+
+#include "boost/bind.hpp"
+#include "boost/test/unit_test.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+
+namespace Tests {
+namespace Usul {
+namespace Atomic {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helpers for the tests below.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  const unsigned int NUM_READERS ( 4 );
+  const unsigned int NUM_WRITERS ( 2 );
+  const unsigned int NUM_TIMES ( 100000 );
+
+  // All the members are the same, unless a reader saw a partial write.
+  struct Triple
+  {
+    Triple ( unsigned long v = 0 ) : a ( v ), b ( v ), c ( v ){}
+    bool valid() const { return ( ( a == b ) && ( b == c ) ); }
+    unsigned long a, b, c;
+  };
+
+  typedef ::Usul::Atomic::Integer < unsigned long > Counter;
+
+  template < class ObjectType > inline void writeTriples ( ObjectType &object, unsigned long start )
+  {
+    for ( unsigned long i = 0; i < NUM_TIMES; ++i )
+    {
+      object = Triple ( start + i );
+    }
+  }
+
+  template < class ObjectType > inline void readTriples ( const ObjectType &object, Counter &bad )
+  {
+    for ( unsigned long i = 0; i < NUM_TIMES; ++i )
+    {
+      const Triple t ( object );
+      if ( false == t.valid() )
+      {
+        ++bad;
+      }
+    }
+  }
+
+  // Read and write the object from several threads.
+  template < class ObjectType > inline void readAndWrite()
+  {
+    ObjectType object ( Triple ( 1 ) );
+    Counter bad ( 0 );
+
+    boost::thread_group threads;
+    for ( unsigned int i = 0; i < NUM_WRITERS; ++i )
+    {
+      threads.create_thread ( boost::bind ( &Details::writeTriples < ObjectType >,
+        boost::ref ( object ), ( i + 1 ) * NUM_TIMES ) );
+    }
+    for ( unsigned int i = 0; i < NUM_READERS; ++i )
+    {
+      threads.create_thread ( boost::bind ( &Details::readTriples < ObjectType >,
+        boost::cref ( object ), boost::ref ( bad ) ) );
+    }
+    threads.join_all();
+
+    BOOST_CHECK_EQUAL ( 0u, static_cast < unsigned long > ( bad ) );
+    BOOST_CHECK_EQUAL ( true, Triple ( object ).valid() );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Readers of a sequence-lock object never see a partial
+//  write.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test001()
+{
+  Details::readAndWrite < ::Usul::Atomic::SeqLockObject < Details::Triple > >();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Readers of a shared-lock object never see a partial write.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test002()
+{
+  Details::readAndWrite < ::Usul::Atomic::SharedObject < Details::Triple > >();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Threads load, store and swap the same atomic pointer. 
+//  Every object they get is still alive, and all of them are deleted in 
+//  the end.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  class Counted : public ::Usul::Base::Referenced
+  {
+  public:
+
+    // The macro for these does not work inside namespace Tests::Usul.
+    typedef ::Usul::Base::Referenced BaseClass;
+    typedef ::Usul::Pointers::SmartPointer < Counted, ::Usul::Pointers::Configs::RefCountingNullOk > RefPtr;
+
+    enum { ALIVE = 0x600dF00D, DEAD = 0xDEADBEEF };
+
+    Counted ( Counter &live ) : BaseClass(), _live ( live ), _magic ( ALIVE )
+    {
+      ++_live;
+    }
+
+    bool alive() const
+    {
+      return ( ALIVE == _magic );
+    }
+
+  protected:
+
+    virtual ~Counted()
+    {
+      _magic = DEAD;
+      --_live;
+    }
+
+  private:
+
+    Counter &_live;
+    volatile unsigned long _magic;
+  };
+
+  typedef ::Usul::Atomic::Pointer < Counted::RefPtr > CountedPointer;
+
+  inline void check ( const Counted::RefPtr &p, Counter &bad )
+  {
+    if ( ( true == p.valid() ) && ( false == p->alive() ) )
+    {
+      ++bad;
+    }
+  }
+
+  inline void loadPointers ( const CountedPointer &pointer, Counter &bad )
+  {
+    for ( unsigned long i = 0; i < NUM_TIMES; ++i )
+    {
+      Details::check ( pointer, bad );
+    }
+  }
+
+  inline void storePointers ( CountedPointer &pointer, Counter &live )
+  {
+    for ( unsigned long i = 0; i < NUM_TIMES / 10; ++i )
+    {
+      pointer = Counted::RefPtr ( new Counted ( live ) );
+    }
+  }
+
+  inline void swapPointers ( CountedPointer &pointer, Counter &live, Counter &bad )
+  {
+    for ( unsigned long i = 0; i < NUM_TIMES / 10; ++i )
+    {
+      const Counted::RefPtr p ( ( 0 == i % 2 ) ? Counted::RefPtr ( new Counted ( live ) ) : Counted::RefPtr() );
+      Details::check ( pointer.fetchAndStore ( p ), bad );
+    }
+  }
+}
+
+inline void test003()
+{
+  Details::Counter live ( 0 );
+  Details::Counter bad ( 0 );
+  {
+    Details::CountedPointer pointer ( Details::Counted::RefPtr ( new Details::Counted ( live ) ) );
+
+    boost::thread_group threads;
+    for ( unsigned int i = 0; i < Details::NUM_READERS; ++i )
+    {
+      threads.create_thread ( boost::bind ( &Details::loadPointers, boost::cref ( pointer ), boost::ref ( bad ) ) );
+    }
+    threads.create_thread ( boost::bind ( &Details::storePointers, boost::ref ( pointer ), boost::ref ( live ) ) );
+    threads.create_thread ( boost::bind ( &Details::swapPointers, boost::ref ( pointer ), boost::ref ( live ), boost::ref ( bad ) ) );
+    threads.join_all();
+
+    // Only the last one is left, and only the slot has it.
+    BOOST_CHECK ( static_cast < unsigned long > ( live ) <= 1 );
+    pointer = Details::Counted::RefPtr();
+  }
+
+  BOOST_CHECK_EQUAL ( 0u, static_cast < unsigned long > ( bad ) );
+  BOOST_CHECK_EQUAL ( 0u, static_cast < unsigned long > ( live ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Threads that add to the same number under a lock do not 
+//  lose any of the additions.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  template < class MutexType > inline void addUnderLock ( MutexType &mutex, unsigned long &number )
+  {
+    for ( unsigned long i = 0; i < NUM_TIMES; ++i )
+    {
+      ::Usul::Threads::Guard < MutexType > guard ( mutex );
+      ++number;
+    }
+  }
+
+  template < class MutexType > inline void countUnderLock()
+  {
+    MutexType mutex;
+    unsigned long number ( 0 );
+
+    boost::thread_group threads;
+    for ( unsigned int i = 0; i < NUM_READERS; ++i )
+    {
+      threads.create_thread ( boost::bind ( &Details::addUnderLock < MutexType >, boost::ref ( mutex ), boost::ref ( number ) ) );
+    }
+    threads.join_all();
+
+    BOOST_CHECK_EQUAL ( NUM_READERS * NUM_TIMES, number );
+  }
+}
+
+inline void test004()
+{
+  Details::countUnderLock < ::Usul::Threads::FastMutex >();
+  Details::countUnderLock < ::Usul::Threads::Mutex >();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Locking with a timeout throws when another thread keeps 
+//  the lock too long, and gets the lock when the other thread lets it go.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  template < class MutexType > inline void holdLock ( MutexType &mutex, ::Usul::Atomic::Bool &locked, unsigned long milliseconds )
+  {
+    mutex.lock();
+    locked = true;
+    boost::this_thread::sleep ( boost::posix_time::milliseconds ( milliseconds ) );
+    mutex.unlock();
+  }
+
+  template < class MutexType > inline void lockWithTimeout()
+  {
+    MutexType mutex;
+    ::Usul::Atomic::Bool locked ( false );
+
+    boost::thread holder ( boost::bind ( &Details::holdLock < MutexType >, boost::ref ( mutex ), boost::ref ( locked ), 500 ) );
+    while ( false == locked )
+    {
+      boost::this_thread::yield();
+    }
+
+    BOOST_CHECK_THROW ( mutex.lock ( 20, 1 ), ::Usul::Exceptions::TimedOut );
+    BOOST_CHECK_EQUAL ( false, mutex.trylock() );
+
+    // The holder lets it go well before this times out.
+    BOOST_CHECK_NO_THROW ( mutex.lock ( 10000, 1 ) );
+    mutex.unlock();
+    holder.join();
+
+    // Nobody has it now.
+    BOOST_CHECK_NO_THROW ( mutex.lock ( 20, 1 ) );
+    mutex.unlock();
+  }
+}
+
+inline void test005()
+{
+  Details::lockWithTimeout < ::Usul::Threads::FastMutex >();
+  Details::lockWithTimeout < ::Usul::Threads::Mutex >();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. The lock profiler counts the locks from every thread, 
+//  including the ones that ended, and times the waits.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  typedef ::Usul::Threads::LockProfiler LockProfiler;
+
+  inline void probeLocks ( boost::mutex &mutex, unsigned long &number )
+  {
+    for ( unsigned long i = 0; i < NUM_TIMES / 10; ++i )
+    {
+      LockProfiler::Probe probe ( LockProfiler::Site ( "profiled", 1 ) );
+      probe.lock ( mutex );
+      ++number;
+      mutex.unlock();
+      probe.unlocked();
+    }
+  }
+
+  inline void holdProbedLock ( boost::mutex &mutex, ::Usul::Atomic::Bool &locked )
+  {
+    LockProfiler::Probe probe ( LockProfiler::Site ( "profiled", 2 ) );
+    probe.lock ( mutex );
+    locked = true;
+    boost::this_thread::sleep ( boost::posix_time::milliseconds ( 50 ) );
+    mutex.unlock();
+    probe.unlocked();
+  }
+}
+
+inline void test006()
+{
+  typedef Details::LockProfiler LockProfiler;
+  const LockProfiler::Site counted ( "profiled", 1 );
+  const LockProfiler::Site held ( "profiled", 2 );
+  const LockProfiler::Site waited ( "profiled", 3 );
+
+  LockProfiler::enable ( true );
+  LockProfiler::reset();
+
+  // The threads end before the counts are read.
+  boost::mutex mutex;
+  unsigned long number ( 0 );
+  {
+    boost::thread_group threads;
+    for ( unsigned int i = 0; i < Details::NUM_READERS; ++i )
+    {
+      threads.create_thread ( boost::bind ( &Details::probeLocks, boost::ref ( mutex ), boost::ref ( number ) ) );
+    }
+    threads.join_all();
+  }
+
+  // Wait for a lock that another thread holds.
+  {
+    ::Usul::Atomic::Bool locked ( false );
+    boost::thread holder ( boost::bind ( &Details::holdProbedLock, boost::ref ( mutex ), boost::ref ( locked ) ) );
+    while ( false == locked )
+    {
+      boost::this_thread::yield();
+    }
+    LockProfiler::Probe probe ( waited );
+    probe.lock ( mutex );
+    mutex.unlock();
+    probe.unlocked();
+    holder.join();
+  }
+
+  LockProfiler::Sites sites ( LockProfiler::sites() );
+  BOOST_CHECK_EQUAL ( 3u, sites.size() );
+  BOOST_CHECK_EQUAL ( number, sites[counted].count );
+  BOOST_CHECK_EQUAL ( Details::NUM_READERS * ( Details::NUM_TIMES / 10 ), number );
+  BOOST_CHECK_EQUAL ( 1u, sites[held].count );
+  BOOST_CHECK ( sites[held].holdMaximum >= 10000000u );
+  BOOST_CHECK_EQUAL ( 1u, sites[waited].count );
+  BOOST_CHECK_EQUAL ( 1u, sites[waited].contended );
+  BOOST_CHECK ( sites[waited].waitMaximum > 0 );
+
+  // Longest total wait first.
+  const LockProfiler::SortedSites sorted ( LockProfiler::sorted ( 2 ) );
+  BOOST_REQUIRE_EQUAL ( 2u, sorted.size() );
+  BOOST_CHECK ( sorted[0].second.waitTotal >= sorted[1].second.waitTotal );
+
+  std::ostringstream out;
+  LockProfiler::report ( out, 3 );
+  const std::string report ( out.str() );
+  BOOST_CHECK_EQUAL ( 3, std::count ( report.begin(), report.end(), '\n' ) );
+  BOOST_CHECK ( std::string::npos != report.find ( "profiled:3 locked 1, contended 1" ) );
+
+  // Nothing is recorded while it is off.
+  LockProfiler::enable ( false );
+  LockProfiler::reset();
+  {
+    LockProfiler::Probe probe ( counted );
+    probe.lock ( mutex );
+    mutex.unlock();
+    probe.unlocked();
+  }
+  BOOST_CHECK_EQUAL ( true, LockProfiler::sites().empty() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Checked objects made and released by several threads 
+//  come and go from the list of live objects. One that was never 
+//  referenced is listed with its own type.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  class Tracked : public ::Usul::Base::Ref::Checked
+  {
+  public:
+
+    typedef ::Usul::Base::Ref::Checked BaseClass;
+
+    Tracked() : BaseClass(){}
+
+  protected:
+
+    virtual ~Tracked(){}
+  };
+
+  // How many of the live objects are of the given type?
+  inline unsigned long numLive ( const std::string &type )
+  {
+    std::ostringstream out;
+    ::Usul::Base::Ref::Checked::writeLiveObjects ( out );
+    const std::string live ( out.str() );
+
+    unsigned long count ( 0 );
+    const std::string key ( ", Type: " + type + "," );
+    for ( std::string::size_type i = live.find ( key ); std::string::npos != i; i = live.find ( key, i + 1 ) )
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  inline void makeTracked()
+  {
+    std::vector < Tracked * > objects;
+    for ( unsigned int i = 0; i < 1000; ++i )
+    {
+      objects.push_back ( new Tracked );
+      objects.back()->ref();
+    }
+    for ( unsigned int i = 0; i < objects.size(); ++i )
+    {
+      objects[i]->unref();
+    }
+  }
+}
+
+inline void test007()
+{
+  #ifdef USUL_USE_INSTANCE_MANAGER
+
+  const std::string type ( typeid ( Details::Tracked ).name() );
+  BOOST_REQUIRE_EQUAL ( 0u, Details::numLive ( type ) );
+
+  // Never referenced, but listed with its type.
+  Details::Tracked *tracked ( new Details::Tracked );
+  BOOST_CHECK_EQUAL ( 1u, Details::numLive ( type ) );
+
+  {
+    boost::thread_group threads;
+    for ( unsigned int i = 0; i < Details::NUM_READERS; ++i )
+    {
+      threads.create_thread ( &Details::makeTracked );
+    }
+    threads.join_all();
+  }
+  BOOST_CHECK_EQUAL ( 1u, Details::numLive ( type ) );
+
+  tracked->ref();
+  tracked->unref();
+  BOOST_CHECK_EQUAL ( 0u, Details::numLive ( type ) );
+
+  // In debug builds every referenced object is a checked one.
+  #ifdef USUL_BASE_REFERENCED_CHECKED
+  Details::Counter live ( 0 );
+  const std::string counted ( typeid ( Details::Counted ).name() );
+  {
+    Details::Counted::RefPtr c ( new Details::Counted ( live ) );
+    BOOST_CHECK_EQUAL ( 1u, Details::numLive ( counted ) );
+  }
+  BOOST_CHECK_EQUAL ( 0u, Details::numLive ( counted ) );
+  #endif
+
+  #endif
+}
+
+
+} // namespace Atomic
+} // namespace Usul
+} // namespace Tests
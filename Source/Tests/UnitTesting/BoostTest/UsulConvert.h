@@ -0,0 +1,193 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test functions for converting numbers to and from strings.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Convert/Convert.h"
+#include "Usul/Convert/Vector3.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/test/unit_test.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+
+namespace Tests {
+namespace Usul {
+namespace Convert {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helpers for the tests below.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  typedef ::Usul::Types::Float32 Float32;
+  typedef ::Usul::Types::Float64 Float64;
+  typedef ::Usul::Types::UInt32 UInt32;
+  typedef ::Usul::Types::UInt64 UInt64;
+
+  template < class T > inline std::string toString ( const T &t )
+  {
+    return ::Usul::Convert::Type < T, std::string >::convert ( t );
+  }
+
+  template < class T > inline T fromString ( const std::string &s )
+  {
+    return ::Usul::Convert::Type < std::string, T >::convert ( s );
+  }
+
+  // The same bits, so that the sign of zero counts.
+  template < class T > inline void roundTrip ( T t )
+  {
+    const std::string s ( Details::toString ( t ) );
+    const T answer ( Details::fromString < T > ( s ) );
+    const bool same ( 0 == std::memcmp ( &t, &answer, sizeof ( T ) ) );
+    BOOST_CHECK_MESSAGE ( same, "Text '" << s << "' did not read back the same" );
+  }
+
+  // Numbers made from random bits, so that all of them are possible.
+  inline UInt64 randomBits()
+  {
+    UInt64 bits ( 0 );
+    for ( unsigned int i = 0; i < 8; ++i )
+    {
+      bits = ( bits << 8 ) | static_cast < UInt64 > ( std::rand() & 0xff );
+    }
+    return bits;
+  }
+  template < class T, class Bits > inline T randomReal()
+  {
+    T t ( 0 );
+    do
+    {
+      const Bits bits ( static_cast < Bits > ( Details::randomBits() ) );
+      std::memcpy ( &t, &bits, sizeof ( T ) );
+    }
+    while ( ( t != t ) || ( t > std::numeric_limits < T >::max() ) || ( t < -std::numeric_limits < T >::max() ) );
+    return t;
+  }
+
+  template < class T > inline void limits()
+  {
+    typedef std::numeric_limits < T > Limits;
+    Details::roundTrip ( T ( 0 ) );
+    Details::roundTrip ( -T ( 0 ) );
+    Details::roundTrip ( Limits::min() );
+    Details::roundTrip ( -Limits::min() );
+    Details::roundTrip ( Limits::max() );
+    Details::roundTrip ( -Limits::max() );
+    Details::roundTrip ( Limits::denorm_min() );
+    Details::roundTrip ( -Limits::denorm_min() );
+    Details::roundTrip ( Limits::epsilon() );
+    Details::roundTrip ( T ( 1 ) + Limits::epsilon() );
+    Details::roundTrip ( T ( 0.1 ) );
+    Details::roundTrip ( T ( 1 ) / T ( 3 ) );
+
+    // Every power of two down through the denormals.
+    for ( T t = Limits::min(); t > 0; t /= 2 )
+    {
+      Details::roundTrip ( t );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Single-precision numbers read back the same.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test001()
+{
+  Details::limits < Details::Float32 >();
+
+  std::srand ( 1 );
+  for ( unsigned int i = 0; i < 100000; ++i )
+  {
+    Details::roundTrip ( Details::randomReal < Details::Float32, Details::UInt32 >() );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Double-precision numbers read back the same.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test002()
+{
+  Details::limits < Details::Float64 >();
+
+  std::srand ( 2 );
+  for ( unsigned int i = 0; i < 100000; ++i )
+  {
+    Details::roundTrip ( Details::randomReal < Details::Float64, Details::UInt64 >() );
+  }
+
+  // Vectors are written one number at a time.
+  const ::Usul::Math::Vec3d v ( Details::randomReal < Details::Float64, Details::UInt64 >(),
+    -0.0, std::numeric_limits < Details::Float64 >::denorm_min() );
+  const ::Usul::Math::Vec3d answer ( Details::fromString < ::Usul::Math::Vec3d > ( Details::toString ( v ) ) );
+  BOOST_CHECK ( 0 == std::memcmp ( &v[0], &answer[0], 3 * sizeof ( Details::Float64 ) ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Text that is written by hand. Numbers out of range are
+//  not read, and the value is left alone.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test003()
+{
+  BOOST_CHECK_EQUAL ( 0.1, Details::fromString < Details::Float64 > ( "0.1" ) );
+  BOOST_CHECK_EQUAL ( 0.1, Details::fromString < Details::Float64 > ( " +0.1" ) );
+  BOOST_CHECK_EQUAL ( 1e-320, Details::fromString < Details::Float64 > ( "1e-320" ) );
+  BOOST_CHECK_EQUAL ( 1e-320, Details::fromString < Details::Float64 > ( "0.00000000001e-309" ) );
+  BOOST_CHECK_EQUAL ( 4.9406564584124654e-324, Details::fromString < Details::Float64 > ( "4.9406564584124654e-324" ) );
+  BOOST_CHECK_EQUAL ( 1.7976931348623157e308, Details::fromString < Details::Float64 > ( "1.7976931348623157e308" ) );
+  BOOST_CHECK_EQUAL ( 1e-40f, Details::fromString < Details::Float32 > ( "1e-40" ) );
+  BOOST_CHECK_EQUAL ( 0.3f, Details::fromString < Details::Float32 > ( "0.3" ) );
+
+  // Half way between two doubles rounds to even. A long run of digits
+  // after it decides which way.
+  BOOST_CHECK_EQUAL ( 9007199254740992.0, Details::fromString < Details::Float64 > ( "9007199254740993" ) );
+  BOOST_CHECK_EQUAL ( 9007199254740994.0, Details::fromString < Details::Float64 > ( "9007199254740993.00000000000000000000000000000000000001" ) );
+
+  Details::Float64 d ( 2 );
+  ::Usul::Convert::Type < std::string, Details::Float64 >::convert ( "1e400", d );
+  BOOST_CHECK_EQUAL ( 2.0, d );
+  ::Usul::Convert::Type < std::string, Details::Float64 >::convert ( "1e-400", d );
+  BOOST_CHECK_EQUAL ( 2.0, d );
+  ::Usul::Convert::Type < std::string, Details::Float64 >::convert ( "inf", d );
+  BOOST_CHECK_EQUAL ( 2.0, d );
+
+  Details::Float32 f ( 2 );
+  ::Usul::Convert::Type < std::string, Details::Float32 >::convert ( "1e39", f );
+  BOOST_CHECK_EQUAL ( 2.0f, f );
+}
+
+
+} // namespace Convert
+} // namespace Usul
+} // namespace Tests
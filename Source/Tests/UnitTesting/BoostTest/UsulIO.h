@@ -0,0 +1,416 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test functions for reading and writing arrays of numbers in any byte
+//  order, and for parsing lists of numbers from text.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Endian/Endian.h"
+#include "Usul/Exceptions/IO.h"
+#include "Usul/IO/BinaryReader.h"
+#include "Usul/IO/BinaryWriter.h"
+#include "Usul/IO/TextParser.h"
+#include "Usul/IO/TextReader.h"
+#include "Usul/IO/Vector3.h"
+#include "Usul/Jobs/Manager.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/test/unit_test.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace Tests {
+namespace Usul {
+namespace IO {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helpers for the tests below.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  typedef ::Usul::IO::Binary::ReadBigEndian ReadBig;
+  typedef ::Usul::IO::Binary::ReadLittleEndian ReadLittle;
+  typedef ::Usul::IO::Binary::WriteBigEndian WriteBig;
+  typedef ::Usul::IO::Binary::WriteLittleEndian WriteLittle;
+
+  // Enough to fill the writer's stack buffer more than twice, with some
+  // left over. The others are around the 16 bytes that SSE2 swaps at once.
+  const std::size_t COUNTS[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 2049, 5003 };
+  const std::size_t NUM_COUNTS ( sizeof ( COUNTS ) / sizeof ( COUNTS[0] ) );
+
+  // Every byte of every number is different, so a wrong swap shows.
+  template < class T > inline std::vector < T > numbers ( std::size_t count )
+  {
+    std::vector < T > v ( count );
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+      unsigned char bytes[sizeof ( T )];
+      for ( std::size_t j = 0; j < sizeof ( T ); ++j )
+      {
+        bytes[j] = static_cast < unsigned char > ( i * sizeof ( T ) + j + 1 );
+      }
+      std::memcpy ( &v[i], bytes, sizeof ( T ) );
+    }
+    return v;
+  }
+
+  // The bytes of the numbers, most significant first.
+  template < class T > inline std::string bigEndian ( const T *t, std::size_t count )
+  {
+    std::string s;
+    const char *bytes ( reinterpret_cast < const char * > ( t ) );
+    for ( std::size_t i = 0; i < count; ++i, bytes += sizeof ( T ) )
+    {
+      for ( std::size_t j = 0; j < sizeof ( T ); ++j )
+      {
+        #ifdef USUL_LITTLE_ENDIAN
+        s.push_back ( bytes[sizeof ( T ) - 1 - j] );
+        #else
+        s.push_back ( bytes[j] );
+        #endif
+      }
+    }
+    return s;
+  }
+
+  template < class T > inline bool same ( const T *a, const T *b, std::size_t count )
+  {
+    return ( ( 0 == count ) || ( 0 == std::memcmp ( a, b, count * sizeof ( T ) ) ) );
+  }
+
+  // Write the numbers and read them back in both byte orders. Also swap
+  // them in place and compare with swapping one at a time.
+  template < class T > inline void roundTrip()
+  {
+    for ( std::size_t c = 0; c < NUM_COUNTS; ++c )
+    {
+      const std::size_t count ( COUNTS[c] );
+
+      // Start one number in, so that it is not on a 16-byte boundary.
+      const std::vector < T > original ( Details::numbers < T > ( count + 1 ) );
+      const T *data ( &original[0] + 1 );
+
+      std::vector < T > answer ( count + 1 );
+      T *result ( &answer[0] + 1 );
+
+      {
+        std::ostringstream out;
+        WriteBig::array ( out, data, count );
+        BOOST_CHECK ( Details::bigEndian ( data, count ) == out.str() );
+
+        std::istringstream in ( out.str() );
+        ReadBig::array ( in, result, count );
+        BOOST_CHECK ( Details::same ( data, result, count ) );
+      }
+
+      {
+        std::ostringstream out;
+        WriteLittle::array ( out, data, count );
+        BOOST_CHECK_EQUAL ( count * sizeof ( T ), out.str().size() );
+
+        std::fill ( answer.begin(), answer.end(), T ( 0 ) );
+        std::istringstream in ( out.str() );
+        ReadLittle::array ( in, result, count );
+        BOOST_CHECK ( Details::same ( data, result, count ) );
+      }
+
+      {
+        // Copy the bytes, because some of them are not valid numbers.
+        std::vector < T > one ( count + 1 );
+        std::memcpy ( &one[0], &original[0], one.size() * sizeof ( T ) );
+        for ( std::size_t i = 1; i <= count; ++i )
+        {
+          ::Usul::Endian::reverseBytes ( one[i] );
+        }
+
+        std::memcpy ( &answer[0], &original[0], answer.size() * sizeof ( T ) );
+        ::Usul::Endian::reverseBytes ( result, count );
+        BOOST_CHECK ( Details::same ( &one[0] + 1, result, count ) );
+      }
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helpers for the text parser tests below.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  typedef std::vector < float > Floats;
+  typedef std::vector < unsigned int > UInts;
+  typedef std::vector < ::Usul::Math::Vec3f > Vec3fs;
+
+  // Text shorter than this is parsed in one piece.
+  const std::size_t ONE_MEGABYTE ( 1024 * 1024 );
+
+  // The old way, with the stream reader one element at a time. Unlike the
+  // old sequence reader, this does not add an element when the read fails.
+  template < class ContainerType > inline ContainerType streamRead ( const std::string &text )
+  {
+    typedef typename ContainerType::value_type ValueType;
+    ContainerType c;
+    std::istringstream in ( text );
+    while ( EOF != in.peek() )
+    {
+      ValueType value;
+      ::Usul::IO::Text::Reader::read ( in, value );
+      if ( in.fail() )
+        break;
+      c.push_back ( value );
+    }
+    return c;
+  }
+
+  // Parse the text both ways and compare.
+  template < class ContainerType > inline void compareParsed ( const std::string &text, std::size_t expected )
+  {
+    const ContainerType answer ( Details::streamRead < ContainerType > ( text ) );
+    BOOST_CHECK_EQUAL ( expected, answer.size() );
+
+    // Fill it first to see that the parser clears it.
+    ContainerType c ( 3 );
+    ::Usul::IO::Text::Parser::sequence ( text, c );
+    BOOST_REQUIRE_EQUAL ( answer.size(), c.size() );
+    BOOST_CHECK ( ( true == c.empty() ) || ( true == Details::same ( &answer[0], &c[0], c.size() ) ) );
+  }
+
+  // Random numbers, written the way a stream would.
+  inline std::string floats ( std::size_t count )
+  {
+    std::ostringstream out;
+    out << std::setprecision ( 9 );
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+      const float f ( static_cast < float > ( std::rand() - RAND_MAX / 2 ) /
+        static_cast < float > ( 1 + std::rand() % 10000 ) );
+      out << f << ( ( 0 == ( i % 10 ) ) ? "\n" : ( ( 0 == ( i % 7 ) ) ? "\t " : " " ) );
+    }
+    return out.str();
+  }
+  inline std::string uints ( std::size_t count )
+  {
+    std::ostringstream out;
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+      out << static_cast < unsigned int > ( std::rand() ) << ( ( 0 == ( i % 10 ) ) ? "\r\n" : " " );
+    }
+    return out.str();
+  }
+
+  // Text of at least the given length, ending without white space.
+  inline std::string floatsOfLength ( std::size_t length, std::size_t &count )
+  {
+    std::string text;
+    count = 0;
+    while ( text.size() < length )
+    {
+      text += Details::floats ( 999 );
+      count += 999;
+    }
+    text += "1.5";
+    ++count;
+    return text;
+  }
+
+  // Use a worker queue for the long text.
+  struct WorkerQueue
+  {
+    WorkerQueue()
+    {
+      ::Usul::Jobs::Manager::instance()["worker_queue"] = ::Usul::Jobs::Queue::RefPtr ( new ::Usul::Jobs::Queue ( 3 ) );
+    }
+    ~WorkerQueue()
+    {
+      ::Usul::Jobs::Manager::instance().remove ( "worker_queue" );
+    }
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Arrays of 2-byte numbers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test001()
+{
+  Details::roundTrip < ::Usul::Types::UInt16 >();
+  Details::roundTrip < ::Usul::Types::Int16 >();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Arrays of 4-byte numbers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test002()
+{
+  Details::roundTrip < ::Usul::Types::UInt32 >();
+  Details::roundTrip < ::Usul::Types::Int32 >();
+  Details::roundTrip < ::Usul::Types::Float32 >();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Arrays of 8-byte numbers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test003()
+{
+  Details::roundTrip < ::Usul::Types::UInt64 >();
+  Details::roundTrip < ::Usul::Types::Int64 >();
+  Details::roundTrip < ::Usul::Types::Float64 >();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Reading more numbers than the stream has throws.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test004()
+{
+  const std::vector < ::Usul::Types::Float64 > original ( Details::numbers < ::Usul::Types::Float64 > ( 10 ) );
+
+  std::ostringstream out;
+  Details::WriteBig::array ( out, &original[0], original.size() );
+
+  std::vector < ::Usul::Types::Float64 > answer ( original.size() + 1 );
+  std::istringstream in ( out.str() );
+  BOOST_CHECK_THROW ( Details::ReadBig::array ( in, &answer[0], answer.size() ), ::Usul::Exceptions::IO::UnexpectedEndOfFile );
+
+  // Cut off in the middle of a number.
+  std::istringstream partial ( out.str().substr ( 0, out.str().size() - 3 ) );
+  BOOST_CHECK_THROW ( Details::ReadLittle::array ( partial, &answer[0], original.size() ), ::Usul::Exceptions::IO::UnexpectedEndOfFile );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Parsing text that is done in one piece gives the same
+//  numbers as the stream.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test005()
+{
+  std::srand ( 5 );
+
+  // Empty, and only white space.
+  Details::compareParsed < Details::Floats > ( std::string(), 0 );
+  Details::compareParsed < Details::Floats > ( std::string ( " \t\r\n " ), 0 );
+  Details::compareParsed < Details::Vec3fs > ( std::string(), 0 );
+
+  // White space before and after.
+  const std::string text ( Details::floats ( 3000 ) );
+  BOOST_REQUIRE ( text.size() < Details::ONE_MEGABYTE );
+  Details::compareParsed < Details::Floats > ( text, 3000 );
+  Details::compareParsed < Details::Floats > ( "\n  \t" + text + "\t\n ", 3000 );
+  Details::compareParsed < Details::Vec3fs > ( "  " + text, 1000 );
+
+  const std::string numbers ( Details::uints ( 3000 ) );
+  Details::compareParsed < Details::UInts > ( numbers, 3000 );
+  Details::compareParsed < Details::UInts > ( "\r\n" + numbers + "\r\n", 3000 );
+
+  // The last vector is not whole.
+  Details::compareParsed < Details::Vec3fs > ( text + " 1 2", 1000 );
+  Details::compareParsed < Details::Vec3fs > ( "1 2 3 4", 1 );
+
+  // A bad word stops it, even part way through a vector.
+  Details::compareParsed < Details::Floats > ( "1 2 3 oops 5 6", 3 );
+  Details::compareParsed < Details::Vec3fs > ( "1 2 3 4 oops 6", 1 );
+  Details::compareParsed < Details::Floats > ( text + " oops " + text, 3000 );
+  Details::compareParsed < Details::UInts > ( numbers + " oops " + numbers, 3000 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Parsing text that is long enough to be split into pieces
+//  gives the same numbers as the stream.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test006()
+{
+  std::srand ( 6 );
+  Details::WorkerQueue queue;
+
+  std::size_t count ( 0 );
+  const std::string text ( Details::floatsOfLength ( 3 * Details::ONE_MEGABYTE, count ) );
+  Details::compareParsed < Details::Floats > ( text, count );
+  Details::compareParsed < Details::Floats > ( "\n\n  " + text + "  \n\n", count );
+  Details::compareParsed < Details::Vec3fs > ( text, count / 3 );
+
+  // The last vector is not whole.
+  Details::compareParsed < Details::Vec3fs > ( text + ( ( 0 == count % 3 ) ? " 1" : "" ), count / 3 );
+
+  std::string numbers;
+  while ( numbers.size() < 2 * Details::ONE_MEGABYTE )
+  {
+    numbers += Details::uints ( 1000 );
+  }
+  const std::size_t numWords ( Details::streamRead < Details::UInts > ( numbers ).size() );
+  Details::compareParsed < Details::UInts > ( numbers, numWords );
+  Details::compareParsed < Details::UInts > ( " " + numbers + " ", numWords );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. A bad word in a piece after the first one stops long text
+//  where it is, even when the pieces after it are good.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test007()
+{
+  std::srand ( 7 );
+  Details::WorkerQueue queue;
+
+  std::size_t count ( 0 );
+  const std::string text ( Details::floatsOfLength ( 2 * Details::ONE_MEGABYTE, count ) );
+
+  // In the middle, in the last piece, and part way through a vector.
+  Details::compareParsed < Details::Floats > ( text + " oops " + text, count );
+  Details::compareParsed < Details::Floats > ( text + " " + text + " 1 x", 2 * count + 1 );
+  Details::compareParsed < Details::Vec3fs > ( text + " 7 8 oops " + text, ( count + 2 ) / 3 );
+
+  // A word cut off by the end of the text.
+  Details::compareParsed < Details::Floats > ( text + " " + text + " -", 2 * count );
+}
+
+
+} // namespace IO
+} // namespace Usul
+} // namespace Tests
@@ -0,0 +1,723 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test functions for Usul's job classes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Jobs/Group.h"
+#include "Usul/Jobs/Parallel.h"
+#include "Usul/Jobs/Queue.h"
+#include "Usul/Jobs/Timer.h"
+#include "Usul/Exceptions/Exceptions.h"
+#include "Usul/System/Clock.h"
+#include "Usul/System/Sleep.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/Mutex.h"
+
+#include "boost/bind.hpp"
+#include "boost/test/unit_test.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <cstdlib>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+
+namespace Tests {
+namespace Usul {
+namespace Jobs {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Records the order in which the jobs run.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  struct Recorder
+  {
+    typedef ::Usul::Threads::Mutex Mutex;
+    typedef ::Usul::Threads::Guard < Mutex > Guard;
+    typedef std::vector < int > Order;
+
+    void record ( int value, ::Usul::Jobs::BaseJob::RefPtr )
+    {
+      Guard guard ( _mutex );
+      _order.push_back ( value );
+    }
+
+    Order order() const
+    {
+      Guard guard ( _mutex );
+      return _order;
+    }
+
+  private:
+
+    mutable Mutex _mutex;
+    Order _order;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Jobs with predecessors run after them.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test001()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Group Group;
+  typedef ::Usul::Jobs::Queue Queue;
+  using ::Usul::Jobs::makeJob;
+
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 4, true ) );
+  Group::RefPtr group ( new Group );
+
+  BaseJob::RefPtr a ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ) ) );
+  BaseJob::RefPtr b ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 2, _1 ) ) );
+  BaseJob::RefPtr c ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 3, _1 ) ) );
+  BaseJob::RefPtr d ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 4, _1 ) ) );
+
+  a->then ( b )->then ( c );
+  d->after ( b );
+  d->after ( c );
+  BOOST_CHECK_EQUAL ( true, d->isWaiting() );
+
+  group->add ( a );
+  group->add ( b );
+  group->add ( c );
+  group->add ( d );
+
+  // Add them in the wrong order on purpose.
+  queue->add ( d );
+  queue->add ( c );
+  queue->add ( b );
+  queue->add ( a );
+
+  BOOST_CHECK_EQUAL ( true, group->wait() );
+  BOOST_CHECK_EQUAL ( true, group->isFinished() );
+
+  const Details::Recorder::Order order ( recorder.order() );
+  BOOST_REQUIRE_EQUAL ( 4u, order.size() );
+  for ( unsigned int i = 0; i < order.size(); ++i )
+  {
+    BOOST_CHECK_EQUAL ( static_cast < int > ( i + 1 ), order[i] );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Cancelling a job cancels the jobs that depend on it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test002()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Queue Queue;
+  using ::Usul::Jobs::makeJob;
+
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 1 ) );
+
+  BaseJob::RefPtr a ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ) ) );
+  BaseJob::RefPtr b ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 2, _1 ) ) );
+  a->then ( b );
+  a->cancel();
+
+  queue->add ( b );
+  BOOST_CHECK_EQUAL ( false, b->wait ( 50 ) );
+
+  queue->add ( a );
+  BOOST_CHECK_EQUAL ( true, b->wait() );
+  BOOST_CHECK_EQUAL ( true, b->isCancelled() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Changing the priority of queued jobs changes the order.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  inline ::Usul::Jobs::BaseJob::Priority reverse ( ::Usul::Jobs::BaseJob::RefPtr job )
+  {
+    return -job->priority();
+  }
+}
+
+inline void test003()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Queue Queue;
+  using ::Usul::Jobs::makeJob;
+
+  // No threads, so the jobs only run when we say.
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 0 ) );
+
+  std::vector < BaseJob::RefPtr > jobs;
+  for ( int i = 0; i < 5; ++i )
+  {
+    jobs.push_back ( makeJob ( i, boost::bind ( &Details::Recorder::record, &recorder, i, _1 ) ) );
+    queue->add ( jobs.back() );
+  }
+
+  // Move the last job to the front, then reverse them all.
+  BOOST_CHECK_EQUAL ( true, queue->prioritize ( jobs[4], -1 ) );
+  BOOST_CHECK_EQUAL ( -1, jobs[4]->priority() );
+  BOOST_CHECK_EQUAL ( true, queue->isHigherPriorityJobWaiting ( 0 ) );
+  queue->prioritize ( &Details::reverse );
+
+  while ( true == queue->executeNextJob() ){}
+
+  const Details::Recorder::Order order ( recorder.order() );
+  BOOST_REQUIRE_EQUAL ( 5u, order.size() );
+  BOOST_CHECK_EQUAL ( 3, order[0] );
+  BOOST_CHECK_EQUAL ( 2, order[1] );
+  BOOST_CHECK_EQUAL ( 1, order[2] );
+  BOOST_CHECK_EQUAL ( 0, order[3] );
+  BOOST_CHECK_EQUAL ( 4, order[4] );
+
+  // A job that is not queued only gets its new priority.
+  BOOST_CHECK_EQUAL ( false, queue->prioritize ( jobs[0], 7 ) );
+  BOOST_CHECK_EQUAL ( 7, jobs[0]->priority() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Parallel loops give the same answers as serial ones.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  typedef std::vector < int > Numbers;
+
+  struct Square
+  {
+    Square ( Numbers &n ) : _n ( n ){}
+    void operator () ( std::size_t first, std::size_t last )
+    {
+      for ( std::size_t i = first; i < last; ++i )
+        _n[i] = static_cast < int > ( i * i );
+    }
+  private:
+    Numbers &_n;
+  };
+
+  struct Sum
+  {
+    Sum ( const Numbers &n ) : _n ( n ){}
+    void operator () ( std::size_t first, std::size_t last, long &sum )
+    {
+      for ( std::size_t i = first; i < last; ++i )
+        sum += _n[i] % 1000;
+    }
+  private:
+    const Numbers &_n;
+  };
+}
+
+inline void test004()
+{
+  typedef ::Usul::Jobs::Queue Queue;
+
+  Queue::RefPtr queue ( new Queue ( 4 ) );
+  const std::size_t size ( 100000 );
+
+  Details::Numbers numbers ( size, -1 );
+  ::Usul::Jobs::parallelFor ( 0, size, Details::Square ( numbers ), 0, queue );
+  long expected ( 0 );
+  for ( std::size_t i = 0; i < size; ++i )
+  {
+    BOOST_REQUIRE_EQUAL ( static_cast < int > ( i * i ), numbers[i] );
+    expected += numbers[i] % 1000;
+  }
+
+  const long sum ( ::Usul::Jobs::parallelReduce ( 0, size, 0L, 
+    Details::Sum ( numbers ), std::plus < long > (), 100, queue ) );
+  BOOST_CHECK_EQUAL ( expected, sum );
+
+  for ( std::size_t i = 0; i < size; ++i )
+    numbers[i] = std::rand();
+  Details::Numbers sorted ( numbers );
+  std::sort ( sorted.begin(), sorted.end() );
+  ::Usul::Jobs::parallelSort ( numbers.begin(), numbers.end(), queue );
+  BOOST_CHECK ( sorted == numbers );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. The queue counts how its jobs ended.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  inline void cancelled ( ::Usul::Jobs::BaseJob::RefPtr job )
+  {
+    job->cancel();
+  }
+  inline void failed ( ::Usul::Jobs::BaseJob::RefPtr )
+  {
+    throw std::runtime_error ( "Error 3086416373: Job failed on purpose" );
+  }
+}
+
+inline void test005()
+{
+  typedef ::Usul::Jobs::Metrics Metrics;
+  typedef ::Usul::Jobs::Queue Queue;
+
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 0 ) );
+
+  queue->add ( boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ), 1 );
+  queue->add ( boost::bind ( &Details::Recorder::record, &recorder, 2, _1 ), 1 );
+  queue->add ( &Details::cancelled, 2 );
+  queue->add ( &Details::failed, 2 );
+  while ( true == queue->executeNextJob() ){}
+
+  const Metrics::Snapshot s ( queue->metrics() );
+  BOOST_CHECK_EQUAL ( 0u, s.depth );
+  BOOST_CHECK_EQUAL ( 3u, s.peakDepth );
+  BOOST_CHECK_EQUAL ( 4u, s.all.latency.count );
+  BOOST_CHECK_EQUAL ( 2u, s.all.finished );
+  BOOST_CHECK_EQUAL ( 1u, s.all.cancelled );
+  BOOST_CHECK_EQUAL ( 1u, s.all.failed );
+  BOOST_REQUIRE_EQUAL ( 2u, s.priorities.size() );
+  BOOST_CHECK_EQUAL ( 2u, s.priorities.find ( 1 )->second.finished );
+  BOOST_CHECK_EQUAL ( 2u, s.priorities.find ( 2 )->second.duration.count );
+
+  queue->metricsReset();
+  BOOST_CHECK_EQUAL ( 0u, queue->metrics().all.latency.count );
+
+  // Priorities beyond the buckets are counted in the first or last one.
+  queue->add ( boost::bind ( &Details::Recorder::record, &recorder, 3, _1 ), 1000 );
+  queue->add ( boost::bind ( &Details::Recorder::record, &recorder, 4, _1 ), -1000 );
+  while ( true == queue->executeNextJob() ){}
+  const Metrics::Snapshot t ( queue->metrics() );
+  BOOST_REQUIRE_EQUAL ( 2u, t.priorities.size() );
+  BOOST_CHECK_EQUAL ( 1u, t.priorities.find ( Metrics::MAX_PRIORITY )->second.finished );
+  BOOST_CHECK_EQUAL ( 1u, t.priorities.find ( Metrics::MIN_PRIORITY )->second.finished );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Jobs with the earliest deadline run first, and the ones
+//  that missed it are downgraded or dropped.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test006()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Queue Queue;
+  using ::Usul::Jobs::makeJob;
+
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 0 ) );
+  queue->deadlinesSet ( true );
+  queue->missedSet ( Queue::MISSED_DOWNGRADE );
+
+  const ::Usul::Types::UInt64 now ( ::Usul::System::Clock::microseconds() );
+  BaseJob::RefPtr a ( makeJob ( -5, boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ) ) );
+  BaseJob::RefPtr b ( makeJob (  0, boost::bind ( &Details::Recorder::record, &recorder, 2, _1 ) ) );
+  BaseJob::RefPtr c ( makeJob (  0, boost::bind ( &Details::Recorder::record, &recorder, 3, _1 ) ) );
+  BaseJob::RefPtr d ( makeJob (  0, boost::bind ( &Details::Recorder::record, &recorder, 4, _1 ) ) );
+  b->deadlineSet ( now + 20000000 );
+  c->deadlineSet ( now + 10000000 );
+  d->deadlineSet ( 1 );
+
+  queue->add ( a );
+  queue->add ( b );
+  queue->add ( c );
+  queue->add ( d );
+  while ( true == queue->executeNextJob() ){}
+
+  // The missed one runs after all the others because its priority is lower.
+  const Details::Recorder::Order order ( recorder.order() );
+  BOOST_REQUIRE_EQUAL ( 4u, order.size() );
+  BOOST_CHECK_EQUAL ( 3, order[0] );
+  BOOST_CHECK_EQUAL ( 2, order[1] );
+  BOOST_CHECK_EQUAL ( 1, order[2] );
+  BOOST_CHECK_EQUAL ( 4, order[3] );
+
+  // Now drop the missed ones.
+  queue->missedSet ( Queue::MISSED_DROP );
+  BaseJob::RefPtr e ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 5, _1 ) ) );
+  e->deadlineSet ( 1 );
+  queue->add ( e );
+  while ( true == queue->executeNextJob() ){}
+
+  BOOST_CHECK_EQUAL ( 4u, recorder.order().size() );
+  BOOST_CHECK_EQUAL ( true, e->isCancelled() );
+  BOOST_CHECK_EQUAL ( true, e->isFinished() );
+  BOOST_CHECK_EQUAL ( 1u, queue->metrics().all.dropped );
+  BOOST_CHECK_EQUAL ( 2u, queue->metrics().all.missed );
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Delayed jobs are added in the order they are due, 
+//  repeating ones stop when cancelled, and restarted jobs back off.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  struct Restarter
+  {
+    Restarter() : _count ( 0 ){}
+    void run ( ::Usul::Jobs::BaseJob::RefPtr )
+    {
+      if ( ++_count < 3 )
+        throw ::Usul::Exceptions::Restart();
+    }
+    unsigned int count() const { return _count; }
+  private:
+    unsigned int _count;
+  };
+}
+
+inline void test007()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Queue Queue;
+  typedef ::Usul::Jobs::Timer Timer;
+  using ::Usul::Jobs::makeJob;
+
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 1 ) );
+  Timer &timer ( Timer::instance() );
+
+  BaseJob::RefPtr a ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 3, _1 ) ) );
+  BaseJob::RefPtr b ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ) ) );
+  BaseJob::RefPtr c ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 2, _1 ) ) );
+  timer.schedule ( queue, a, 60 );
+  timer.schedule ( queue, b, 20 );
+  timer.schedule ( queue, c, 40 );
+  BOOST_CHECK_EQUAL ( 3u, timer.size() );
+  BOOST_CHECK_EQUAL ( true, a->wait ( 5000 ) );
+  BOOST_CHECK_EQUAL ( true, b->wait ( 5000 ) );
+  BOOST_CHECK_EQUAL ( true, c->wait ( 5000 ) );
+
+  const Details::Recorder::Order order ( recorder.order() );
+  BOOST_REQUIRE_EQUAL ( 3u, order.size() );
+  BOOST_CHECK_EQUAL ( 1, order[0] );
+  BOOST_CHECK_EQUAL ( 2, order[1] );
+  BOOST_CHECK_EQUAL ( 3, order[2] );
+
+  // A cancelled job is never added, and the timer lets go of it.
+  BaseJob::RefPtr d ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 4, _1 ) ) );
+  const unsigned long refs ( d->refCount() );
+  const Timer::ID id ( timer.schedule ( queue, d, 10000 ) );
+  BOOST_CHECK ( d->refCount() > refs );
+  BOOST_CHECK_EQUAL ( true, timer.cancel ( id ) );
+  BOOST_CHECK_EQUAL ( refs, static_cast < unsigned long > ( d->refCount() ) );
+  BOOST_CHECK_EQUAL ( false, timer.cancel ( id ) );
+  BOOST_CHECK_EQUAL ( 0u, timer.size() );
+
+  // Repeat until cancelled.
+  Details::Recorder ticks;
+  const Timer::ID repeating ( timer.repeat ( queue, boost::bind ( &Details::Recorder::record, &ticks, 0, _1 ), 5 ) );
+  for ( unsigned int i = 0; ( i < 1000 ) && ( ticks.order().size() < 3 ); ++i )
+  {
+    ::Usul::System::Sleep::milliseconds ( 5 );
+  }
+  BOOST_CHECK_EQUAL ( true, timer.cancel ( repeating ) );
+  BOOST_CHECK ( ticks.order().size() >= 3 );
+
+  // The job runs again after it restarts.
+  Details::Restarter restarter;
+  queue->restartDelaySet ( Queue::RestartDelay ( 1, 4 ) );
+  BaseJob::RefPtr e ( makeJob ( 0, boost::bind ( &Details::Restarter::run, &restarter, _1 ) ) );
+  queue->add ( e );
+  BOOST_CHECK_EQUAL ( true, e->wait ( 5000 ) );
+  BOOST_CHECK_EQUAL ( 3u, restarter.count() );
+  BOOST_CHECK_EQUAL ( 2u, queue->metrics().all.restarted );
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. The memory of a freed job is used for the next one.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test008()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Queue Queue;
+  using ::Usul::Jobs::makeJob;
+
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 0 ) );
+
+  const void *first ( 0x0 );
+  {
+    BaseJob::RefPtr job ( queue->add ( boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ) ) );
+    first = job.get();
+    while ( true == queue->executeNextJob() ){}
+  }
+
+  BaseJob::RefPtr job ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 2, _1 ) ) );
+  BOOST_CHECK_EQUAL ( first, static_cast < const void * > ( job.get() ) );
+  BOOST_CHECK_EQUAL ( 1u, recorder.order().size() );
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Removing or clearing queued jobs finishes them, so the 
+//  threads waiting on them and their successors wake up.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  inline void waitFor ( ::Usul::Jobs::BaseJob::RefPtr a, ::Usul::Jobs::BaseJob::RefPtr b )
+  {
+    a->wait();
+    b->wait();
+  }
+}
+
+inline void test009()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Queue Queue;
+  using ::Usul::Jobs::makeJob;
+
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 0 ) );
+
+  BaseJob::RefPtr a ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ) ) );
+  BaseJob::RefPtr b ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 2, _1 ) ) );
+  a->then ( b );
+  queue->add ( a );
+  queue->add ( b );
+  BOOST_CHECK_EQUAL ( 1u, queue->size() );
+
+  boost::thread waiter ( boost::bind ( &Details::waitFor, a, b ) );
+  BOOST_CHECK_EQUAL ( true, queue->remove ( a ) );
+  BOOST_CHECK_EQUAL ( false, queue->remove ( a ) );
+  BOOST_REQUIRE_EQUAL ( true, waiter.timed_join ( boost::posix_time::seconds ( 5 ) ) );
+
+  BOOST_CHECK_EQUAL ( true, a->isCancelled() );
+  BOOST_CHECK_EQUAL ( true, b->isCancelled() );
+  BOOST_CHECK_EQUAL ( true, b->isFinished() );
+  BOOST_CHECK_EQUAL ( true, queue->empty() );
+
+  // Clearing does the same.
+  BaseJob::RefPtr c ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 3, _1 ) ) );
+  BaseJob::RefPtr d ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 4, _1 ) ) );
+  c->then ( d );
+  queue->add ( c );
+  queue->add ( d );
+  queue->clear();
+  BOOST_CHECK_EQUAL ( true, c->wait ( 5000 ) );
+  BOOST_CHECK_EQUAL ( true, d->wait ( 5000 ) );
+  BOOST_CHECK_EQUAL ( true, d->isCancelled() );
+
+  // None of them ran.
+  while ( true == queue->executeNextJob() ){}
+  BOOST_CHECK_EQUAL ( 0u, recorder.order().size() );
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. A job that is queued in one lane is not added to another.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  inline void block ( ::Usul::Jobs::BaseJob::RefPtr gate, ::Usul::Jobs::BaseJob::RefPtr )
+  {
+    gate->wait();
+  }
+}
+
+inline void test010()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Queue Queue;
+  using ::Usul::Jobs::makeJob;
+
+  Details::Recorder recorder;
+  Queue::RefPtr queue ( new Queue ( 2, true ) );
+  Queue::RefPtr opener ( new Queue ( 0 ) );
+
+  // Keep both threads busy so that the job stays queued.
+  BaseJob::RefPtr gate ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 0, _1 ) ) );
+  queue->add ( boost::bind ( &Details::block, gate, _1 ) );
+  queue->add ( boost::bind ( &Details::block, gate, _1 ) );
+  for ( unsigned int i = 0; ( i < 1000 ) && ( queue->numRunning() < 2 ); ++i )
+  {
+    ::Usul::System::Sleep::milliseconds ( 5 );
+  }
+  BOOST_REQUIRE_EQUAL ( 2u, queue->numRunning() );
+
+  // Jobs added from this thread go to the lanes in turn.
+  BaseJob::RefPtr job ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ) ) );
+  queue->add ( job );
+  queue->add ( job );
+  BOOST_CHECK_EQUAL ( 1u, queue->size() );
+
+  opener->add ( gate );
+  opener->executeNextJob();
+  BOOST_CHECK_EQUAL ( true, job->wait ( 5000 ) );
+  BOOST_CHECK_EQUAL ( true, queue->empty() );
+  BOOST_CHECK_EQUAL ( 2u, recorder.order().size() );
+
+  // It can be queued again after it ran.
+  queue->add ( job );
+  for ( unsigned int i = 0; ( i < 1000 ) && ( recorder.order().size() < 3 ); ++i )
+  {
+    ::Usul::System::Sleep::milliseconds ( 5 );
+  }
+  BOOST_CHECK_EQUAL ( 3u, recorder.order().size() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Jobs added from inside a job go to that thread's lane, 
+//  and the idle threads take some of them.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  struct ThreadRecorder
+  {
+    typedef ::Usul::Threads::Mutex Mutex;
+    typedef ::Usul::Threads::Guard < Mutex > Guard;
+    typedef std::set < boost::thread::id > Threads;
+
+    void record ( ::Usul::Jobs::BaseJob::RefPtr )
+    {
+      boost::this_thread::sleep ( boost::posix_time::milliseconds ( 5 ) );
+      Guard guard ( _mutex );
+      _threads.insert ( boost::this_thread::get_id() );
+    }
+
+    Threads threads() const
+    {
+      Guard guard ( _mutex );
+      return _threads;
+    }
+
+  private:
+
+    mutable Mutex _mutex;
+    Threads _threads;
+  };
+
+  inline void spawn ( ::Usul::Jobs::Queue::RefPtr queue, ThreadRecorder &recorder, ::Usul::Jobs::Group::RefPtr group, ::Usul::Jobs::BaseJob::RefPtr )
+  {
+    for ( unsigned int i = 0; i < 40; ++i )
+    {
+      ::Usul::Jobs::BaseJob::RefPtr job ( ::Usul::Jobs::makeJob ( 0, boost::bind ( &ThreadRecorder::record, &recorder, _1 ) ) );
+      group->add ( job );
+      queue->add ( job );
+    }
+  }
+}
+
+inline void test011()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Group Group;
+  typedef ::Usul::Jobs::Queue Queue;
+
+  Details::ThreadRecorder recorder;
+  Queue::RefPtr queue ( new Queue ( 4, true ) );
+  Group::RefPtr group ( new Group );
+
+  // All the jobs go to the lane of the thread that runs this one.
+  BaseJob::RefPtr spawner ( queue->add ( boost::bind ( &Details::spawn, queue, boost::ref ( recorder ), group, _1 ) ) );
+  BOOST_REQUIRE_EQUAL ( true, spawner->wait ( 5000 ) );
+  BOOST_REQUIRE_EQUAL ( true, group->wait ( 10000 ) );
+
+  BOOST_CHECK ( recorder.threads().size() > 1 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. A job that waits for a job in another queue runs in the 
+//  queue it was added to. If that queue is gone then it is cancelled.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test012()
+{
+  typedef ::Usul::Jobs::BaseJob BaseJob;
+  typedef ::Usul::Jobs::Queue Queue;
+  using ::Usul::Jobs::makeJob;
+
+  Details::Recorder recorder;
+  Queue::RefPtr workers ( new Queue ( 2 ) );
+  Queue::RefPtr gui ( new Queue ( 0 ) );
+
+  BaseJob::RefPtr a ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 1, _1 ) ) );
+  BaseJob::RefPtr b ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 2, _1 ) ) );
+  a->then ( b );
+  gui->add ( b );
+  workers->add ( a );
+
+  BOOST_REQUIRE_EQUAL ( true, a->wait ( 5000 ) );
+  BOOST_CHECK_EQUAL ( 1u, gui->size() );
+  BOOST_CHECK_EQUAL ( true, gui->executeNextJob() );
+  BOOST_CHECK_EQUAL ( true, b->isFinished() );
+  BOOST_CHECK_EQUAL ( false, b->isCancelled() );
+  BOOST_CHECK_EQUAL ( 2u, recorder.order().size() );
+
+  // Now the queue it was added to goes away first.
+  BaseJob::RefPtr c ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 3, _1 ) ) );
+  BaseJob::RefPtr d ( makeJob ( 0, boost::bind ( &Details::Recorder::record, &recorder, 4, _1 ) ) );
+  c->then ( d );
+  gui->add ( d );
+  gui = Queue::RefPtr();
+  workers->add ( c );
+
+  BOOST_CHECK_EQUAL ( true, d->wait ( 5000 ) );
+  BOOST_CHECK_EQUAL ( true, d->isCancelled() );
+  BOOST_CHECK_EQUAL ( 3u, recorder.order().size() );
+}
+
+} // namespace Jobs
+} // namespace Usul
+} // namespace Tests
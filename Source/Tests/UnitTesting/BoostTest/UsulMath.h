@@ -23,6 +23,10 @@
 
 #include "boost/test/unit_test.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 
 namespace Tests {
 namespace Usul {
@@ -129,7 +133,7 @@ namespace Details
     const T x ( 10 );
     const Matrix t ( Matrix::translation ( x, 0, 0 ) );
     const Vec3 axis ( 0, 1, 0 );
-    const Matrix r ( Matrix::rotation<90> ( axis ) );
+    const Matrix r ( Matrix::template rotation<90> ( axis ) );
     const Matrix m1 ( t * r );
     const Matrix m2 ( r * t );
 
@@ -164,7 +168,7 @@ namespace Details
   template < class T > inline void test004()
   {
     typedef ::Usul::Math::Sphere<T> Sphere;
-    typedef Sphere::Vector Vec;
+    typedef typename Sphere::Vector Vec;
 
     // Identical spheres should be equal.
     {
@@ -237,6 +241,150 @@ namespace Details
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. The matrix kernels give the same answers as the plain 
+//  ones, for singular matrices and when the answer is one of the inputs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  template < class T > inline T absolute ( T t )
+  {
+    return ( ( t < 0 ) ? -t : t );
+  }
+
+  // Are the numbers close, allowing more error for larger numbers?
+  template < class T > inline bool close ( const T *a, const T *b, std::size_t size )
+  {
+    const T tolerance ( std::numeric_limits < T >::epsilon() * 256 );
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+      const T scale ( std::max ( static_cast < T > ( 1 ), std::max ( Details::absolute ( a[i] ), Details::absolute ( b[i] ) ) ) );
+      if ( false == ( Details::absolute ( a[i] - b[i] ) <= ( tolerance * scale ) ) )
+        return false;
+    }
+    return true;
+  }
+
+  template < class T > inline bool same ( const T *a, const T *b, std::size_t size )
+  {
+    return std::equal ( a, a + size, b );
+  }
+
+  template < class T > inline void test005()
+  {
+    typedef ::Usul::Math::Vector3<T> Vec3;
+    typedef ::Usul::Math::Matrix44<T> Matrix;
+    typedef ::Usul::Math::Detail::Matrix44Kernels<T> Kernels;
+    typedef std::vector < Matrix > Matrices;
+    typedef std::vector < Vec3 > Points;
+
+    Matrices matrices;
+
+    // Invertible, and w is never zero for the points below.
+    matrices.push_back ( Matrix ( 2, 1, 3, 4, 1, 5, 2, 3, 3, 2, 7, 1, 1, 4, 2, 9 ) );
+    matrices.push_back ( Matrix::translation ( 100, 10, 1 ) * Matrix::rotation ( static_cast < T > ( 0.5 ), Vec3 ( 1, 2, 3 ).normalized() ) );
+    const std::size_t numToTransform ( matrices.size() );
+
+    // Invertible, but the top-left 2x2 block is singular.
+    matrices.push_back ( Matrix ( 1, 2, 1, 0, 2, 4, 0, 1, 1, 0, 3, 1, 0, 1, 2, 5 ) );
+    matrices.push_back ( Matrix ( 0, 0, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 0, 0 ) );
+
+    // Singular. The numbers are small integers, so the determinant is 
+    // exactly zero in every kernel.
+    matrices.push_back ( Matrix ( 1, 2, 3, 4, 2, 4, 6, 8, 3, 1, 7, 2, 5, 6, 1, 3 ) );
+    matrices.push_back ( Matrix ( 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 ) );
+    matrices.push_back ( Matrix ( 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 ) );
+
+    const T *identity ( Matrix::getIdentity().get() );
+
+    for ( std::size_t i = 0; i < matrices.size(); ++i )
+    {
+      const std::size_t j ( ( i + 1 ) % matrices.size() );
+      const T *a ( matrices[i].get() );
+      const T *b ( matrices[j].get() );
+      T expected[16], answer[16], c[16];
+
+      // Multiply, also with the answer in the inputs.
+      ::Usul::Math::Detail::multiply44 ( a, b, expected );
+      Kernels::multiply ( a, b, answer );
+      BOOST_CHECK ( Details::close ( expected, answer, 16 ) );
+
+      std::copy ( a, a + 16, c );
+      Kernels::multiply ( c, b, c );
+      BOOST_CHECK ( Details::same ( answer, c, 16 ) );
+
+      std::copy ( b, b + 16, c );
+      Kernels::multiply ( a, c, c );
+      BOOST_CHECK ( Details::same ( answer, c, 16 ) );
+
+      Matrix post ( matrices[i] );
+      post.postMultiply ( matrices[j] );
+      BOOST_CHECK ( Details::same ( answer, post.get(), 16 ) );
+
+      Matrix pre ( matrices[j] );
+      pre.preMultiply ( matrices[i] );
+      BOOST_CHECK ( Details::same ( answer, pre.get(), 16 ) );
+
+      ::Usul::Math::Detail::multiply44 ( a, a, expected );
+      std::copy ( a, a + 16, c );
+      Kernels::multiply ( c, c, c );
+      BOOST_CHECK ( Details::close ( expected, c, 16 ) );
+
+      // Inverse, also in place. When there is none the answer is not touched.
+      std::fill ( expected, expected + 16, static_cast < T > ( 7 ) );
+      std::fill ( answer, answer + 16, static_cast < T > ( 7 ) );
+      const bool invertible ( ::Usul::Math::Detail::inverse44 ( a, expected ) );
+      BOOST_CHECK_EQUAL ( ( i < 4 ), invertible );
+      BOOST_CHECK_EQUAL ( invertible, Kernels::inverse ( a, answer ) );
+      BOOST_CHECK ( Details::close ( expected, answer, 16 ) );
+
+      std::copy ( a, a + 16, c );
+      BOOST_CHECK_EQUAL ( invertible, Kernels::inverse ( c, c ) );
+      BOOST_CHECK ( Details::same ( ( ( invertible ) ? answer : a ), c, 16 ) );
+
+      if ( true == invertible )
+      {
+        Kernels::multiply ( a, answer, c );
+        BOOST_CHECK ( Details::close ( identity, c, 16 ) );
+      }
+      else
+      {
+        BOOST_CHECK_THROW ( matrices[i].inverse(), std::runtime_error );
+      }
+    }
+
+    // Transform the points, also in place.
+    Points points;
+    for ( unsigned int i = 0; i < 11; ++i )
+    {
+      points.push_back ( Vec3 ( static_cast < T > ( i ), static_cast < T > ( 3 ) - i, static_cast < T > ( i * i ) / 4 ) );
+    }
+
+    for ( std::size_t i = 0; i < numToTransform; ++i )
+    {
+      Points expected ( points.size() ), answer ( points.size() ), inPlace ( points );
+      ::Usul::Math::Detail::transform44 ( matrices[i].get(), &points[0], points.size(), &expected[0] );
+      matrices[i].transform ( &points[0], points.size(), &answer[0] );
+      matrices[i].transform ( &inPlace[0], inPlace.size(), &inPlace[0] );
+
+      for ( std::size_t k = 0; k < points.size(); ++k )
+      {
+        const Vec3 one ( matrices[i] * points[k] );
+        const T e[] = { expected[k][0], expected[k][1], expected[k][2] };
+        const T r[] = { answer[k][0], answer[k][1], answer[k][2] };
+        const T o[] = { one[0], one[1], one[2] };
+        BOOST_CHECK ( Details::close ( e, r, 3 ) );
+        BOOST_CHECK ( Details::close ( o, r, 3 ) );
+        BOOST_CHECK ( answer[k].equal ( inPlace[k] ) );
+      }
+    }
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Test function.
@@ -290,6 +438,20 @@ inline void test004()
 }
 
 
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test005()
+{
+  Tests::Usul::Math::Details::test005<double>();
+  Tests::Usul::Math::Details::test005<float>();
+}
+
+
 } // namespace Math
 } // namespace Usul
 } // namespace Tests
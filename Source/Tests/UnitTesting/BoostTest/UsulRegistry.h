@@ -0,0 +1,161 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test functions for Usul's registry classes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Atomic/Bool.h"
+#include "Usul/Atomic/Integer.h"
+#include "Usul/Registry/Handle.h"
+#include "Usul/Registry/Node.h"
+#include "Usul/Registry/Value.h"
+
+#include "boost/bind.hpp"
+#include "boost/test/unit_test.hpp"
+#include "boost/thread/thread.hpp"
+
+
+namespace Tests {
+namespace Usul {
+namespace Registry {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helpers for the tests below.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  typedef ::Usul::Registry::Node Node;
+  typedef ::Usul::Registry::Value < int > IntValue;
+  typedef ::Usul::Atomic::Integer < unsigned long > Counter;
+
+  inline Node::Path path ( const std::string &a, const std::string &b )
+  {
+    Node::Path p;
+    p.push_back ( a );
+    p.push_back ( b );
+    return p;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Handles and values follow the node at their path, even
+//  after it is removed and made again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test001()
+{
+  typedef Details::Node Node;
+
+  Node::RefPtr root ( new Node );
+  Details::IntValue value ( root, Details::path ( "section", "number" ), 7 );
+  BOOST_CHECK_EQUAL ( 7, value.get() );
+  BOOST_CHECK ( &((*root)["section"]["number"]) == value.handle().node().get() );
+
+  Node::Version seen ( 0 );
+  value.changed ( seen );
+  BOOST_CHECK_EQUAL ( false, value.changed ( seen ) );
+
+  (*root)["section"]["number"] = 42;
+  BOOST_CHECK_EQUAL ( true, value.changed ( seen ) );
+  BOOST_CHECK_EQUAL ( 42, value.get() );
+
+  value.set ( 43 );
+  BOOST_CHECK_EQUAL ( 43, (*root)["section"]["number"].get<int> ( 0 ) );
+
+  // Removing the node makes the handle look it up again.
+  (*root)["section"].clear();
+  BOOST_CHECK_EQUAL ( 7, value.get() );
+  (*root)["section"]["number"] = 44;
+  BOOST_CHECK_EQUAL ( 44, value.get() );
+  BOOST_CHECK ( &((*root)["section"]["number"]) == value.handle().node().get() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Threads read a value while others set it and remove its
+//  node. They only ever see the default or a value that was set.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  const int NUM_TIMES ( 20000 );
+
+  inline void setValues ( IntValue &value, ::Usul::Atomic::Bool &done )
+  {
+    for ( int i = 1; i <= NUM_TIMES; ++i )
+    {
+      value.set ( i );
+    }
+    done = true;
+  }
+
+  inline void removeNodes ( Node::RefPtr root, const ::Usul::Atomic::Bool &done )
+  {
+    while ( false == done )
+    {
+      (*root)["section"].clear();
+      boost::this_thread::yield();
+    }
+  }
+
+  inline void readValues ( const IntValue &value, const ::Usul::Atomic::Bool &done, Counter &bad )
+  {
+    while ( false == done )
+    {
+      const int v ( value.get() );
+      if ( ( v < 0 ) || ( v > NUM_TIMES ) )
+      {
+        ++bad;
+      }
+    }
+  }
+}
+
+inline void test002()
+{
+  typedef Details::Node Node;
+
+  Node::RefPtr root ( new Node );
+  Details::IntValue value ( root, Details::path ( "section", "number" ), 0 );
+  ::Usul::Atomic::Bool done ( false );
+  Details::Counter bad ( 0 );
+
+  boost::thread_group threads;
+  for ( unsigned int i = 0; i < 4; ++i )
+  {
+    threads.create_thread ( boost::bind ( &Details::readValues, boost::cref ( value ), boost::cref ( done ), boost::ref ( bad ) ) );
+  }
+  threads.create_thread ( boost::bind ( &Details::removeNodes, root, boost::cref ( done ) ) );
+  threads.create_thread ( boost::bind ( &Details::setValues, boost::ref ( value ), boost::ref ( done ) ) );
+  threads.join_all();
+
+  BOOST_CHECK_EQUAL ( 0u, static_cast < unsigned long > ( bad ) );
+
+  // Afterwards it reads what is there.
+  value.set ( 5 );
+  BOOST_CHECK_EQUAL ( 5, value.get() );
+  BOOST_CHECK_EQUAL ( 5, (*root)["section"]["number"].get<int> ( 0 ) );
+}
+
+
+} // namespace Registry
+} // namespace Usul
+} // namespace Tests
@@ -0,0 +1,238 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test functions for formatting strings. The text has to be the same as
+//  from a stream.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Strings/Format.h"
+
+#include "boost/test/unit_test.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+
+
+namespace Tests {
+namespace Usul {
+namespace Strings {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helpers for the tests below.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Details
+{
+  template < class T > inline std::string stream ( const T &t )
+  {
+    std::ostringstream out;
+    out << t;
+    return out.str();
+  }
+
+  template < class T > inline void compare ( const T &t )
+  {
+    BOOST_CHECK_EQUAL ( Details::stream ( t ), ::Usul::Strings::format ( t ) );
+  }
+
+  template < class T > inline void compareLimits()
+  {
+    Details::compare ( std::numeric_limits < T >::min() );
+    Details::compare ( std::numeric_limits < T >::max() );
+    Details::compare ( static_cast < T > ( 0 ) );
+    Details::compare ( static_cast < T > ( 1 ) );
+    Details::compare ( static_cast < T > ( 10 ) );
+    Details::compare ( static_cast < T > ( std::numeric_limits < T >::max() / 3 ) );
+  }
+
+  // Only has a stream operator.
+  struct Point
+  {
+    Point ( int a, int b ) : x ( a ), y ( b ){}
+    int x, y;
+  };
+  inline std::ostream &operator << ( std::ostream &out, const Point &p )
+  {
+    out << '(' << p.x << ", " << p.y << ')';
+    return out;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Integers and characters.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test001()
+{
+  Details::compareLimits < short >();
+  Details::compareLimits < int >();
+  Details::compareLimits < long >();
+  Details::compareLimits < long long >();
+  Details::compareLimits < unsigned short >();
+  Details::compareLimits < unsigned int >();
+  Details::compareLimits < unsigned long >();
+  Details::compareLimits < unsigned long long >();
+
+  Details::compare ( -1 );
+  Details::compare ( -1234567890L );
+  Details::compare ( true );
+  Details::compare ( false );
+  Details::compare ( 'a' );
+  Details::compare ( static_cast < signed char > ( 'b' ) );
+  Details::compare ( static_cast < unsigned char > ( 'c' ) );
+  Details::compare ( Details::Point ( 3, -4 ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Real numbers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test002()
+{
+  const double doubles[] =
+  {
+    0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 1.0 / 3.0, 2.0 / 3.0, 123456.0, 1234567.0,
+    0.0001, 0.00001, 1e-300, 1e300, -2.5e-7, 99999.95, 999999.5,
+    std::numeric_limits < double >::min(),
+    std::numeric_limits < double >::max(),
+    std::numeric_limits < double >::denorm_min(),
+    std::numeric_limits < double >::infinity(),
+    -std::numeric_limits < double >::infinity()
+  };
+  for ( unsigned int i = 0; i < sizeof ( doubles ) / sizeof ( doubles[0] ); ++i )
+  {
+    Details::compare ( doubles[i] );
+    Details::compare ( static_cast < float > ( doubles[i] ) );
+  }
+
+  // Random ones, from tiny to huge.
+  std::srand ( 1234 );
+  for ( unsigned int i = 0; i < 10000; ++i )
+  {
+    const double d ( static_cast < double > ( std::rand() - RAND_MAX / 2 ) *
+      std::pow ( 10.0, static_cast < int > ( std::rand() % 40 ) - 20 ) / RAND_MAX );
+    Details::compare ( d );
+    Details::compare ( static_cast < float > ( d ) );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Strings, character pointers and other pointers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test003()
+{
+  char text[] = "some text";
+  signed char signedText[] = { 'a', 'b', '\0' };
+  unsigned char unsignedText[] = { 'c', 'd', '\0' };
+
+  Details::compare ( std::string ( "a string" ) );
+  Details::compare ( std::string() );
+  Details::compare ( "literal" );
+  Details::compare ( static_cast < const char * > ( text ) );
+  Details::compare ( static_cast < char * > ( text ) );
+  Details::compare ( static_cast < const signed char * > ( signedText ) );
+  Details::compare ( static_cast < signed char * > ( signedText ) );
+  Details::compare ( static_cast < const unsigned char * > ( unsignedText ) );
+  Details::compare ( static_cast < unsigned char * > ( unsignedText ) );
+
+  // A stream cannot take a null string, and the format writes nothing.
+  BOOST_CHECK_EQUAL ( std::string ( "[]" ), ::Usul::Strings::format ( '[', static_cast < const char * > ( 0x0 ), ']' ) );
+
+  // Pointers are hex. Streams differ on how, so only compare with ours.
+  int number ( 0 );
+  const std::string heap ( 1000, 'h' );
+  const void *pointers[] = { 0x0, &number, text, heap.c_str() };
+  for ( unsigned int i = 0; i < sizeof ( pointers ) / sizeof ( pointers[0] ); ++i )
+  {
+    const std::string s ( ::Usul::Strings::format ( pointers[i] ) );
+    if ( 0x0 == pointers[i] )
+    {
+      BOOST_CHECK_EQUAL ( std::string ( "0" ), s );
+      continue;
+    }
+    BOOST_REQUIRE ( s.size() > 2 );
+    BOOST_CHECK_EQUAL ( std::string ( "0x" ), s.substr ( 0, 2 ) );
+    BOOST_CHECK_EQUAL ( reinterpret_cast < std::size_t > ( pointers[i] ),
+      static_cast < std::size_t > ( std::strtoull ( s.c_str() + 2, 0x0, 16 ) ) );
+    #ifdef __GLIBCXX__
+    Details::compare ( pointers[i] );
+    #endif
+  }
+
+  // Pointers to other types are written the same way.
+  BOOST_CHECK_EQUAL ( ::Usul::Strings::format ( static_cast < const void * > ( &number ) ), ::Usul::Strings::format ( &number ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Test function. Text that does not fit in the writer's stack buffer moves
+//  to the heap, whether it is one long piece or many short ones.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void test004()
+{
+  const std::size_t sizes[] = { 0, 1, 255, 256, 257, 300, 511, 512, 513, 5000 };
+  for ( unsigned int i = 0; i < sizeof ( sizes ) / sizeof ( sizes[0] ); ++i )
+  {
+    const std::string a ( sizes[i], 'a' );
+    Details::compare ( a );
+
+    // The buffer fills up in the middle of the second or third piece.
+    for ( unsigned int j = 0; j < sizeof ( sizes ) / sizeof ( sizes[0] ); ++j )
+    {
+      const std::string b ( sizes[j], 'b' );
+      std::ostringstream out;
+      out << a << 12345 << b.c_str() << -0.25 << 'c' << b;
+      BOOST_CHECK_EQUAL ( out.str(), ::Usul::Strings::format ( a, 12345, b.c_str(), -0.25, 'c', b ) );
+    }
+  }
+
+  // Many short pieces.
+  {
+    std::ostringstream out;
+    for ( int i = 0; i < 8; ++i )
+    {
+      out << "piece " << i << ", ";
+    }
+    const std::string s ( ::Usul::Strings::format (
+      "piece ", 0, ", ", "piece ", 1, ", ", "piece ", 2, ", ", "piece ", 3, ", ",
+      "piece ", 4, ", ", "piece ", 5, ", ", "piece ", 6, ", ", "piece ", 7, ", " ) );
+    BOOST_CHECK_EQUAL ( out.str(), s );
+
+    const std::string longer ( ::Usul::Strings::format ( s, s, s, s, s ) );
+    BOOST_CHECK_EQUAL ( s + s + s + s + s, longer );
+    BOOST_CHECK ( longer.size() > 256 );
+  }
+}
+
+
+} // namespace Strings
+} // namespace Usul
+} // namespace Tests
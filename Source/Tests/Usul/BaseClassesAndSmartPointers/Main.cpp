@@ -14,6 +14,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Usul/Base/Ref/Careful.h"
+#include "Usul/Base/Ref/Checked.h"
 #include "Usul/Base/Ref/MultiThreaded.h"
 #include "Usul/Base/Ref/SingleThreaded.h"
 #include "Usul/Functions/NoThrow.h"
@@ -206,6 +207,7 @@ template < class BaseClassType > struct Test
 void test ( unsigned long num )
 {
   Test < Usul::Base::Ref::Careful >::test ( num );
+  Test < Usul::Base::Ref::Checked >::test ( num );
   Test < Usul::Base::Ref::MultiThreaded >::test ( num );
   Test < Usul::Base::Ref::SingleThreaded >::test ( num );
 }
@@ -16,6 +16,7 @@
 #include "Tree/Expat/Reader.h"
 
 #include "Usul/Errors/Assert.h"
+#include "Usul/File/MappedFile.h"
 #include "Usul/Functions/NoThrow.h"
 #include "Usul/Math/MinMax.h"
 #include "Usul/Scope/Caller.h"
@@ -30,13 +31,27 @@
 
 #include "expat.h"
 
-#include <fstream>
 #include <stdexcept>
 #include <vector>
 
 using namespace Tree::Expat;
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The handlers are given the parser, so that they can stop it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  Reader *reader ( ::XML_Parser parser )
+  {
+    return ( ( 0x0 == parser ) ? 0x0 : reinterpret_cast < Reader * > ( XML_GetUserData ( parser ) ) );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Constructor
@@ -77,11 +92,17 @@ Reader::~Reader()
 
 void Reader::_elementStartCB ( void *userData, const char *name, const char **atts )
 {
-  Reader *reader ( reinterpret_cast < Reader * > ( userData ) );
+  ::XML_Parser parser ( reinterpret_cast < ::XML_Parser > ( userData ) );
+  Reader *reader ( Helper::reader ( parser ) );
   if ( 0x0 != reader )
   {
-    Usul::Functions::noThrow
-      ( boost::bind ( &Reader::_elementStart, reader, name, atts ) );
+    // Exceptions cannot go through expat. Stop now so that read() throws.
+    if ( false == Usul::Functions::noThrow 
+      ( boost::bind ( &Reader::_elementStart, reader, name, atts ), false, "1209425513" ) )
+    {
+      reader->_stop = true;
+      ::XML_StopParser ( parser, XML_FALSE );
+    }
   }
 }
 
@@ -94,10 +115,17 @@ void Reader::_elementStartCB ( void *userData, const char *name, const char **at
 
 void Reader::_elementEndCB ( void *userData, const char *name )
 {
-  Reader *reader ( reinterpret_cast < Reader * > ( userData ) );
+  ::XML_Parser parser ( reinterpret_cast < ::XML_Parser > ( userData ) );
+  Reader *reader ( Helper::reader ( parser ) );
   if ( 0x0 != reader )
   {
-    reader->_elementEnd ( name );
+    // Exceptions cannot go through expat. Stop now so that read() throws.
+    if ( false == Usul::Functions::noThrow 
+      ( boost::bind ( &Reader::_elementEnd, reader, name ), false, "3376590263" ) )
+    {
+      reader->_stop = true;
+      ::XML_StopParser ( parser, XML_FALSE );
+    }
   }
 }
 
@@ -108,23 +136,21 @@ void Reader::_elementEndCB ( void *userData, const char *name )
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Reader::_elementStart ( const char *n, const char **a )
+bool Reader::_elementStart ( const char *n, const char **a )
 {
   _threadCheck.throwIfDifferentThread();
 
   // Handle bad input.
   if ( 0x0 == n )
   {
-    _stop = true;
-    return;
+    return false;
   }
 
   // Get the name.
   const std::string name ( n );
   if ( true == name.empty() )
   {
-    _stop = true;
-    return;
+    return false;
   }
 
   // Get the current node. It will be null if this is the first one.
@@ -173,6 +199,7 @@ void Reader::_elementStart ( const char *n, const char **a )
 
   // Set the node's attributes.
   node->attributes ( attributes );
+  return true;
 }
 
 
@@ -182,7 +209,7 @@ void Reader::_elementStart ( const char *n, const char **a )
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Reader::_elementEnd ( const char * )
+bool Reader::_elementEnd ( const char * )
 {
   _threadCheck.throwIfDifferentThread();
 
@@ -190,8 +217,7 @@ void Reader::_elementEnd ( const char * )
   Node::RefPtr node ( this->_nodeStackTop() );
   if ( false == node.valid() )
   {
-    _stop = true;
-    return;
+    return false;
   }
 
   // Trim leading and trailing white-space from the value.
@@ -201,6 +227,7 @@ void Reader::_elementEnd ( const char * )
 
   // Done with this node.
   this->_nodeStackPop();
+  return true;
 }
 
 
@@ -213,11 +240,17 @@ void Reader::_elementEnd ( const char * )
 
 void Reader::_elementValueCB ( void *userData, const char *value, int length )
 {
-  Reader *reader ( reinterpret_cast < Reader * > ( userData ) );
+  ::XML_Parser parser ( reinterpret_cast < ::XML_Parser > ( userData ) );
+  Reader *reader ( Helper::reader ( parser ) );
   if ( 0x0 != reader )
   {
-    Usul::Functions::noThrow
-      ( boost::bind ( &Reader::_elementValue, reader, value, length ) );
+    // Exceptions cannot go through expat. Stop now so that read() throws.
+    if ( false == Usul::Functions::noThrow 
+      ( boost::bind ( &Reader::_elementValue, reader, value, length ), false, "2741867104" ) )
+    {
+      reader->_stop = true;
+      ::XML_StopParser ( parser, XML_FALSE );
+    }
   }
 }
 
@@ -229,14 +262,14 @@ void Reader::_elementValueCB ( void *userData, const char *value, int length )
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Reader::_elementValue ( const char *v, int length )
+bool Reader::_elementValue ( const char *v, int length )
 {
   _threadCheck.throwIfDifferentThread();
 
   // Handle bad input.
   if ( 0x0 == v )
   {
-    return;
+    return true;
   }
 
   // Get the value. Not null-terminated!
@@ -244,19 +277,19 @@ void Reader::_elementValue ( const char *v, int length )
   const std::string value ( v, v + length );
   if ( true == value.empty() )
   {
-    return;
+    return true;
   }
 
   // Get the current node.
   Node::RefPtr node ( this->_nodeStackTop() );
   if ( false == node.valid() )
   {
-    _stop = true;
-    return;
+    return false;
   }
 
   // We append to handle repeated calls for the pieces of the same value.
   node->value ( node->value() + value );
+  return true;
 }
 
 
@@ -351,13 +384,12 @@ void Reader::_nodeStackPop()
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Load contents of file and build the document. 
+//  Load contents of file and build the document. The file is mapped and 
+//  parsed in one pass, so there is no buffer.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-Tree::Node::RefPtr Reader::read ( const std::string &file,
-                                  IUnknown::RefPtr caller,
-                                  unsigned int bufferSize )
+Tree::Node::RefPtr Reader::read ( const std::string &file, IUnknown::RefPtr caller )
 {
   _threadCheck.throwIfDifferentThread();
 
@@ -375,16 +407,12 @@ Tree::Node::RefPtr Reader::read ( const std::string &file,
     return Node::RefPtr();
   }
 
-  // Open the file for reading.
-  std::ifstream in ( file.c_str(), std::ifstream::in | std::ifstream::binary );
-  if ( false == in.is_open() )
-  {
-    throw std::runtime_error ( Usul::Strings::format 
-      ( "Error 2816436608: Cannot open '", file, "' for reading" ) );
-  }
+  // Map the file instead of reading it. The parser goes through it once.
+  Usul::File::MappedFile::RefPtr mapped ( new Usul::File::MappedFile 
+    ( file, Usul::File::MappedFile::SEQUENTIAL ) );
 
   // Call the other one.
-  return this->read ( in, size, caller, bufferSize );
+  return this->read ( mapped->begin(), mapped->end(), caller );
 }
 
 
@@ -429,8 +457,9 @@ Tree::Node::RefPtr Reader::read (
   // Set the value handler.
   ::XML_SetCharacterDataHandler ( parser, &Reader::_elementValueCB );
 
-  // Set the user data.
+  // Set the user data. The handlers get the parser and ask it for this.
   ::XML_SetUserData ( parser, this );
+  ::XML_UseParserAsHandlerArg ( parser );
 
   // The buffers used below.
   typedef std::vector<char> Buffer;
@@ -441,14 +470,6 @@ Tree::Node::RefPtr Reader::read (
   // Loop through the file,
   while ( EOF != in.peek() )
   {
-    // See if we have been stopped.
-    if ( true == _stop )
-    {
-      const int line ( ::XML_GetCurrentLineNumber ( parser ) );
-      throw std::runtime_error ( Usul::Strings::format ( 
-        "Error 2340382839: Parser stopped near line ", line ) );
-    }
-
     // Determine how much to read. It will be the minimum of the 
     // buffer's size and the remaining bytes in the stream.
     // Note: using tellg() is unreliable.
@@ -484,7 +505,17 @@ Tree::Node::RefPtr Reader::read (
     const int isFinal ( EOF == in.peek() );
 
     // Parse the buffer.
-    if ( 0 == ::XML_Parse ( parser, chunk.c_str(), chunk.size(), isFinal ) )
+    const int parsed ( ::XML_Parse ( parser, chunk.c_str(), chunk.size(), isFinal ) );
+
+    // See if one of the handlers stopped. Expat calls that an error too.
+    if ( true == _stop )
+    {
+      const int line ( ::XML_GetCurrentLineNumber ( parser ) );
+      throw std::runtime_error ( Usul::Strings::format ( 
+        "Error 2340382839: Parser stopped near line ", line ) );
+    }
+
+    if ( 0 == parsed )
     {
       const int line ( ::XML_GetCurrentLineNumber ( parser ) );
       const int column ( ::XML_GetCurrentColumnNumber ( parser ) );
@@ -500,6 +531,97 @@ Tree::Node::RefPtr Reader::read (
     remaining -= static_cast < Usul::Types::UInt64 > ( readThisMuch );
   }
 
+  // Return the root if it worked.
+  return this->_finish();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Build the document from the bytes. Expat handles the line endings.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Tree::Node::RefPtr Reader::read ( const char *begin, const char *end, IUnknown::RefPtr )
+{
+  _threadCheck.throwIfDifferentThread();
+
+  // Initialize members.
+  _stop = false;
+  this->_nodeStackClear();
+  _root = Node::RefPtr();
+
+  // Empty input is ok.
+  if ( ( 0x0 == begin ) || ( end <= begin ) )
+  {
+    return Node::RefPtr();
+  }
+
+  // Make the parser.
+  ::XML_Parser parser ( ::XML_ParserCreate ( 0x0 ) );
+  if ( 0x0 == parser )
+  {
+    throw std::runtime_error ( "Error 2603497260: Failed to create XML parser" );
+  }
+
+  // Always delete the parser.
+  Usul::Scope::Caller::RefPtr deleteParser ( Usul::Scope::makeCaller (
+    boost::bind ( ::XML_ParserFree, boost::ref ( parser ) ) ) );
+
+  // Set the handlers and the user data. The handlers get the parser and
+  // ask it for this.
+  ::XML_SetElementHandler ( parser, 
+    &Reader::_elementStartCB, &Reader::_elementEndCB );
+  ::XML_SetCharacterDataHandler ( parser, &Reader::_elementValueCB );
+  ::XML_SetUserData ( parser, this );
+  ::XML_UseParserAsHandlerArg ( parser );
+
+  // Expat takes an int for the length, so pass large input in pieces.
+  const std::size_t pieceSize ( 64 * 1024 * 1024 );
+  while ( begin < end )
+  {
+    const std::size_t size ( Usul::Math::minimum<std::size_t> ( 
+      pieceSize, static_cast < std::size_t > ( end - begin ) ) );
+    const int isFinal ( ( begin + size ) == end );
+
+    const int parsed ( ::XML_Parse ( parser, begin, static_cast < int > ( size ), isFinal ) );
+
+    // See if one of the handlers stopped. Expat calls that an error too.
+    if ( true == _stop )
+    {
+      const int line ( ::XML_GetCurrentLineNumber ( parser ) );
+      throw std::runtime_error ( Usul::Strings::format ( 
+        "Error 3792260985: Parser stopped near line ", line ) );
+    }
+
+    if ( 0 == parsed )
+    {
+      const int line ( ::XML_GetCurrentLineNumber ( parser ) );
+      const int column ( ::XML_GetCurrentColumnNumber ( parser ) );
+      const char *s ( ::XML_ErrorString ( ::XML_GetErrorCode ( parser ) ) );
+      const std::string message ( ( 0x0 == s ) ? "unknown error" : s );
+
+      throw std::runtime_error ( Usul::Strings::format ( 
+        "Error 4014470786: XML parse error",
+        ", line ", line, ", column ", column, ", ", message ) );
+    }
+
+    begin += size;
+  }
+
+  // Return the root if it worked.
+  return this->_finish();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the root if it is valid.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Tree::Node::RefPtr Reader::_finish()
+{
   // Should be true.
   USUL_ASSERT ( 0 == this->_nodeStackSize() );
 
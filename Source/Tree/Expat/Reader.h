@@ -44,11 +44,10 @@ public:
   Reader();
   ~Reader();
 
-  // Read the file.
+  // Read the file. It is mapped, so there is no buffer size.
   Node::RefPtr    read ( 
                     const std::string &file,
-                    IUnknown::RefPtr caller = IUnknown::RefPtr(),
-                    unsigned int bufferSize = 2048 );
+                    IUnknown::RefPtr caller = IUnknown::RefPtr() );
 
   // Read the stream.
   Node::RefPtr    read ( 
@@ -57,21 +56,29 @@ public:
                     IUnknown::RefPtr caller = IUnknown::RefPtr(),
                     unsigned int bufferSize = 2048 );
 
+  // Read the bytes, like those of a mapped file, without copying them.
+  Node::RefPtr    read ( 
+                    const char *begin,
+                    const char *end,
+                    IUnknown::RefPtr caller = IUnknown::RefPtr() );
+
 private:
 
+  Node::RefPtr    _finish();
+
   void            _nodeStackClear();
   void            _nodeStackPop();
   void            _nodeStackPush ( Node::RefPtr );
   unsigned int    _nodeStackSize() const;
   Node::RefPtr    _nodeStackTop() const;
 
-  void            _elementEnd ( const char *name );
+  bool            _elementEnd ( const char *name );
   static void     _elementEndCB ( void *userData, const char *name );
 
-  void            _elementStart ( const char *name, const char **atts );
+  bool            _elementStart ( const char *name, const char **atts );
   static void     _elementStartCB ( void *userData, const char *name, const char **atts );
 
-  void            _elementValue ( const char *value, int length );
+  bool            _elementValue ( const char *value, int length );
   static void     _elementValueCB ( void *userData, const char *value, int length );
 
   Usul::Threads::Check _threadCheck;
@@ -16,11 +16,12 @@
 #include "Tree/IO/ReadRVHO.h"
 
 #include "Usul/Exceptions/Exceptions.h"
+#include "Usul/File/MappedFile.h"
+#include "Usul/IO/MemoryStream.h"
 
 #include "boost/bind.hpp"
 #include "boost/function.hpp"
 
-#include <fstream>
 #include <map>
 #include <stack>
 
@@ -400,17 +401,33 @@ Tree::Node::RefPtr ReadRVHO::read ( const std::string &file )
       ( "7681691400", "Empty file name given" );
   }
 
-  // Open file.
-  std::ifstream in ( file.c_str() );
-
-  // Handle bad stream.
-  if ( false == in.is_open() )
+  // Map the file instead of reading it.
+  Usul::File::MappedFile::RefPtr mapped;
+  try
+  {
+    mapped = Usul::File::MappedFile::RefPtr ( new Usul::File::MappedFile 
+      ( file, Usul::File::MappedFile::SEQUENTIAL ) );
+  }
+  catch ( const std::exception &e )
   {
     throw Usul::Exceptions::Error 
-      ( "2876437926", "failed to open file for reading: " + file );
+      ( "2876437926", "failed to open file for reading: " + file, e );
   }
 
   // Call other one.
+  return ReadRVHO::read ( mapped->begin(), mapped->end() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read the rvho bytes, like those of a mapped file, without copying them.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Tree::Node::RefPtr ReadRVHO::read ( const char *begin, const char *end )
+{
+  Usul::IO::MemoryStream in ( begin, end );
   return ReadRVHO::read ( in );
 }
 
@@ -36,6 +36,7 @@ struct TREE_EXPORT ReadRVHO
 
   static NodePtr    read ( const std::string &file );
   static NodePtr    read ( std::istream &stream );
+  static NodePtr    read ( const char *begin, const char *end );
 };
 
 
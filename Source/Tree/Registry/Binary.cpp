@@ -0,0 +1,379 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Binary snapshot of Usul's registry.
+//
+//  The file starts with the eight bytes "USULREG" and a format number.
+//  Then come the size and time of the text file it was made from, as 64-bit
+//  numbers. Then come the nodes, parents before children. Each node is its 
+//  name, its value, and the number of children. Strings are a length and 
+//  the characters. Other numbers are 32 bits. All are little-endian.
+//
+//  Encoded buffers do not have the size and time of the text file. They 
+//  are only in the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Tree/Registry/Binary.h"
+
+#include "Usul/Exceptions/Exceptions.h"
+#include "Usul/Registry/Database.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/filesystem.hpp"
+
+#include <cstring>
+#include <fstream>
+
+using namespace Tree::Registry;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions and data.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  typedef Tree::Registry::Binary::Buffer Buffer;
+  typedef Usul::Types::UInt32 UInt32;
+  typedef Usul::Types::UInt64 UInt64;
+
+  const char MAGIC[] = { 'U', 'S', 'U', 'L', 'R', 'E', 'G', 2 };
+  const std::size_t MAGIC_SIZE ( sizeof ( MAGIC ) );
+  const std::size_t SOURCE_SIZE ( 16 );
+  const std::size_t HEADER_SIZE ( MAGIC_SIZE + SOURCE_SIZE );
+
+  // Nodes deeper than this are assumed to be a bad file.
+  const unsigned int MAX_DEPTH ( 1024 );
+
+  inline void writeNumber ( UInt32 n, Buffer &out )
+  {
+    out.push_back ( static_cast < char > (   n         & 0xFF ) );
+    out.push_back ( static_cast < char > ( ( n >>  8 ) & 0xFF ) );
+    out.push_back ( static_cast < char > ( ( n >> 16 ) & 0xFF ) );
+    out.push_back ( static_cast < char > ( ( n >> 24 ) & 0xFF ) );
+  }
+
+  inline void writeNumber64 ( UInt64 n, Buffer &out )
+  {
+    Helper::writeNumber ( static_cast < UInt32 > ( n & 0xFFFFFFFF ), out );
+    Helper::writeNumber ( static_cast < UInt32 > ( n >> 32 ), out );
+  }
+
+  // The size and time of the text file, or zeros if there is none.
+  inline void writeSource ( const std::string &file, Buffer &out )
+  {
+    namespace fs = boost::filesystem;
+    const bool exists ( ( false == file.empty() ) && ( true == fs::exists ( file ) ) );
+    Helper::writeNumber64 ( static_cast < UInt64 > ( ( exists ) ? fs::file_size ( file ) : 0 ), out );
+    Helper::writeNumber64 ( static_cast < UInt64 > ( ( exists ) ? fs::last_write_time ( file ) : 0 ), out );
+  }
+
+  inline void writeString ( const std::string &s, Buffer &out )
+  {
+    Helper::writeNumber ( static_cast < UInt32 > ( s.size() ), out );
+    out.insert ( out.end(), s.begin(), s.end() );
+  }
+
+  void encode ( const Usul::Registry::Node &node, Buffer &out )
+  {
+    typedef Usul::Registry::Node::Children Children;
+
+    const Children children ( node.children() );
+    Helper::writeString ( node.name(), out );
+    Helper::writeString ( node.get ( std::string() ), out );
+    Helper::writeNumber ( static_cast < UInt32 > ( children.size() ), out );
+
+    for ( Children::const_iterator i = children.begin(); i != children.end(); ++i )
+    {
+      const Usul::Registry::Node::RefPtr child ( i->second );
+      if ( true == child.valid() )
+      {
+        Helper::encode ( *child, out );
+      }
+      else
+      {
+        // Keep the count right.
+        Helper::writeString ( i->first, out );
+        Helper::writeString ( std::string(), out );
+        Helper::writeNumber ( 0, out );
+      }
+    }
+  }
+
+  // Reads from the buffer and checks that it does not go past the end.
+  struct Reader
+  {
+    Reader ( const Buffer &b ) : _begin ( b.empty() ? 0x0 : &b[0] ), _size ( b.size() ), _pos ( 0 ){}
+
+    void check ( std::size_t n ) const
+    {
+      if ( n > ( _size - _pos ) )
+      {
+        throw Usul::Exceptions::Error ( "2614570942", "registry snapshot is truncated" );
+      }
+    }
+
+    UInt32 number()
+    {
+      this->check ( 4 );
+      const unsigned char *p ( reinterpret_cast < const unsigned char * > ( _begin + _pos ) );
+      _pos += 4;
+      return ( static_cast < UInt32 > ( p[0] )         |
+             ( static_cast < UInt32 > ( p[1] ) <<  8 ) |
+             ( static_cast < UInt32 > ( p[2] ) << 16 ) |
+             ( static_cast < UInt32 > ( p[3] ) << 24 ) );
+    }
+
+    void string ( std::string &s )
+    {
+      const UInt32 size ( this->number() );
+      this->check ( size );
+      s.assign ( _begin + _pos, size );
+      _pos += size;
+    }
+
+    void magic()
+    {
+      this->check ( MAGIC_SIZE );
+      if ( 0 != std::memcmp ( _begin, MAGIC, MAGIC_SIZE ) )
+      {
+        throw Usul::Exceptions::Error ( "1049713352", "not a registry snapshot, or an unknown format" );
+      }
+      _pos += MAGIC_SIZE;
+    }
+
+  private:
+
+    const char *_begin;
+    const std::size_t _size;
+    std::size_t _pos;
+  };
+
+  // Copy the values and children of one node to the other.
+  void merge ( const Usul::Registry::Node &from, Usul::Registry::Node &to )
+  {
+    typedef Usul::Registry::Node::Children Children;
+
+    to.set ( from.get ( std::string() ) );
+
+    const Children children ( from.children() );
+    for ( Children::const_iterator i = children.begin(); i != children.end(); ++i )
+    {
+      const Usul::Registry::Node::RefPtr child ( i->second );
+      if ( true == child.valid() )
+      {
+        Helper::merge ( *child, to[i->first] );
+      }
+    }
+  }
+
+  // Read the node's value and children. The name is already read.
+  void decode ( Reader &in, Usul::Registry::Node &node, unsigned int depth )
+  {
+    if ( depth > MAX_DEPTH )
+    {
+      throw Usul::Exceptions::Error ( "3963208420", "registry snapshot nodes are too deep" );
+    }
+
+    std::string value;
+    in.string ( value );
+    node.set ( value );
+
+    std::string name;
+    const UInt32 numChildren ( in.number() );
+    for ( UInt32 i = 0; i < numChildren; ++i )
+    {
+      in.string ( name );
+      Helper::decode ( in, node[name], depth + 1 );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Encode the node and its children.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Binary::encode ( const Usul::Registry::Node &node, Buffer &out )
+{
+  out.insert ( out.end(), Helper::MAGIC, Helper::MAGIC + Helper::MAGIC_SIZE );
+  Helper::encode ( node, out );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Decode into the node. Decode into a new node first, so that the given 
+//  one is not changed if the buffer is bad.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Binary::decode ( const Buffer &buffer, Usul::Registry::Node &node )
+{
+  Helper::Reader in ( buffer );
+  in.magic();
+
+  std::string name;
+  in.string ( name );
+
+  Usul::Registry::Node::RefPtr decoded ( new Usul::Registry::Node );
+  Helper::decode ( in, *decoded, 0 );
+
+  node.name ( name );
+  Helper::merge ( *decoded, node );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read the registry. Returns false if the database has no root.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Binary::read ( const std::string &file, Usul::Registry::Database &db )
+{
+  // Open the file at the end so that we know the size.
+  std::ifstream in ( file.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+  if ( false == in.is_open() )
+  {
+    throw Usul::Exceptions::Error ( "3307512849", "failed to open file for reading: " + file );
+  }
+
+  // Read it all at once.
+  const std::streamoff size ( in.tellg() );
+  Buffer buffer ( static_cast < Buffer::size_type > ( ( size > 0 ) ? size : 0 ) );
+  in.seekg ( 0, std::ios::beg );
+  if ( false == buffer.empty() )
+  {
+    in.read ( &buffer[0], static_cast < std::streamsize > ( buffer.size() ) );
+  }
+  if ( false == in.good() )
+  {
+    throw Usul::Exceptions::Error ( "1584216597", "failed to read file: " + file );
+  }
+
+  // The size and time of the text file are not part of the encoding.
+  Helper::Reader header ( buffer );
+  header.magic();
+  header.check ( Helper::SOURCE_SIZE );
+  buffer.erase ( buffer.begin() + Helper::MAGIC_SIZE, buffer.begin() + Helper::HEADER_SIZE );
+
+  Usul::Registry::Node::RefPtr root ( db.root() );
+  if ( false == root.valid() )
+    return false;
+
+  Binary::decode ( buffer, *root );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the encoded registry, with the size and time of the text file it
+//  is a snapshot of. Write to a temporary file and then rename it, so that 
+//  the snapshot is never half written.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Binary::write ( const std::string &file, const Buffer &buffer, const std::string &source )
+{
+  if ( ( buffer.size() < Helper::MAGIC_SIZE ) || ( 0 != std::memcmp ( &buffer[0], Helper::MAGIC, Helper::MAGIC_SIZE ) ) )
+  {
+    throw Usul::Exceptions::Error ( "1770442658", "buffer is not an encoded registry" );
+  }
+
+  Buffer header ( Helper::MAGIC, Helper::MAGIC + Helper::MAGIC_SIZE );
+  Helper::writeSource ( source, header );
+
+  const std::string temp ( file + ".tmp" );
+  {
+    std::ofstream out ( temp.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+    if ( false == out.is_open() )
+    {
+      throw Usul::Exceptions::Error ( "4149368210", "failed to open file for writing: " + temp );
+    }
+
+    out.write ( &header[0], static_cast < std::streamsize > ( header.size() ) );
+    out.write ( &buffer[Helper::MAGIC_SIZE], static_cast < std::streamsize > ( buffer.size() - Helper::MAGIC_SIZE ) );
+
+    out.close();
+    if ( true == out.fail() )
+    {
+      throw Usul::Exceptions::Error ( "2783049971", "failed to write file: " + temp );
+    }
+  }
+
+  boost::filesystem::rename ( temp, file );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the registry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Binary::write ( const std::string &file, Usul::Registry::Database &db, const std::string &source )
+{
+  Usul::Registry::Node::RefPtr root ( db.root() );
+  if ( false == root.valid() )
+    return;
+
+  Buffer buffer;
+  Binary::encode ( *root, buffer );
+  Binary::write ( file, buffer, source );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Was the snapshot made from the text file as it is now? Compares the 
+//  size and time of the text file with the ones in the snapshot. If there 
+//  is no text file then the snapshot is all there is.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Binary::isCurrent ( const std::string &snapshot, const std::string &source )
+{
+  namespace fs = boost::filesystem;
+  if ( false == fs::exists ( snapshot ) )
+    return false;
+  if ( false == fs::exists ( source ) )
+    return true;
+
+  Buffer header ( Helper::HEADER_SIZE, 0 );
+  {
+    std::ifstream in ( snapshot.c_str(), std::ios::in | std::ios::binary );
+    in.read ( &header[0], static_cast < std::streamsize > ( header.size() ) );
+    if ( false == in.good() )
+      return false;
+  }
+
+  Buffer expected ( Helper::MAGIC, Helper::MAGIC + Helper::MAGIC_SIZE );
+  Helper::writeSource ( source, expected );
+  return ( expected == header );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the name of the snapshot for the text file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::string Binary::snapshotFile ( const std::string &file )
+{
+  return file + ".bin";
+}
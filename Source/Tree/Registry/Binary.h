@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Binary snapshot of Usul's registry. It is read in one pass, without
+//  building a tree first. The text file is still the one people edit.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _TREE_REGISTRY_BINARY_H_
+#define _TREE_REGISTRY_BINARY_H_
+
+#include "Tree/Registry/Export.h"
+
+#include <string>
+#include <vector>
+
+namespace Usul { namespace Registry { class Database; class Node; } }
+
+
+namespace Tree {
+namespace Registry {
+
+
+struct TREE_REGISTRY_EXPORT Binary
+{
+  typedef std::vector < char > Buffer;
+
+  // Encode the node and its children.
+  static void           encode ( const Usul::Registry::Node &, Buffer & );
+
+  // Decode into the node. Nodes are added or changed, not removed. Throws
+  // if the buffer is bad, and then the node is not changed.
+  static void           decode ( const Buffer &, Usul::Registry::Node & );
+
+  // Read/write the registry. Reading throws if the file is bad, and then 
+  // the registry is not changed. It returns false if there is no registry.
+  // Writing records the size and time of the text file it is a snapshot of.
+  static bool           read  ( const std::string &file, Usul::Registry::Database & );
+  static void           write ( const std::string &file, const Buffer &, const std::string &source );
+  static void           write ( const std::string &file, Usul::Registry::Database &, const std::string &source );
+
+  // Was the snapshot made from the text file as it is now?
+  static bool           isCurrent ( const std::string &snapshot, const std::string &source );
+
+  // Return the name of the snapshot for the text file.
+  static std::string    snapshotFile ( const std::string &file );
+};
+
+
+} // namespace Registry
+} // namespace Tree
+
+
+#endif // _TREE_REGISTRY_BINARY_H_
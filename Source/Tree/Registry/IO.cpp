@@ -15,24 +15,183 @@
 
 #include "Tree/Registry/IO.h"
 #include "Tree/Expat/Reader.h"
+#include "Tree/Registry/Binary.h"
 #include "Tree/Registry/Builder.h"
 #include "Tree/Registry/Visitor.h"
 #include "Tree/IO/ReadRVHO.h"
 #include "Tree/IO/WriteRVHO.h"
 
+#include "Usul/Exceptions/Exceptions.h"
+#include "Usul/Functions/NoThrow.h"
 #include "Usul/Registry/Database.h"
 
+#include "boost/bind.hpp"
+#include "boost/filesystem.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <fstream>
+#include <map>
+
 using namespace Tree::Registry;
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Read the registry.
+//  Helper functions and data for writing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  typedef Tree::Registry::Binary::Buffer Buffer;
+  typedef std::map < std::string, Buffer > Written;
+  typedef boost::mutex Mutex;
+  typedef boost::lock_guard < Mutex > Lock;
+
+  // Never deleted because the writers are joined during static destruction.
+  struct State
+  {
+    State() : mutex(), written(), writing(), writers()
+    {
+    }
+
+    Mutex mutex;
+    Written written;
+    Mutex writing;
+    boost::thread_group writers;
+  };
+  State *_state ( 0x0 );
+
+  inline State &state()
+  {
+    if ( 0x0 == _state )
+    {
+      _state = new State;
+    }
+    return *_state;
+  }
+
+  // Is the encoded registry what we last wrote to this file?
+  inline bool isWritten ( const std::string &file, const Buffer &buffer )
+  {
+    State &s ( Helper::state() );
+    Lock lock ( s.mutex );
+    Written::const_iterator i ( s.written.find ( file ) );
+    return ( ( s.written.end() != i ) && ( buffer == i->second ) &&
+             ( true == boost::filesystem::exists ( file ) ) &&
+             ( true == boost::filesystem::exists ( Tree::Registry::Binary::snapshotFile ( file ) ) ) );
+  }
+
+  // Encode the whole registry, and copy it to a tree if the bytes are not 
+  // what we last wrote to the file. Returns null if they are the same.
+  Tree::Node::RefPtr copy ( const std::string &file, Usul::Registry::Database &db, Buffer &buffer )
+  {
+    Usul::Registry::Node::RefPtr root ( db.root() );
+    if ( true == root.valid() )
+    {
+      Tree::Registry::Binary::encode ( *root, buffer );
+    }
+
+    if ( true == Helper::isWritten ( file, buffer ) )
+      return Tree::Node::RefPtr();
+
+    Tree::Registry::Visitor::RefPtr visitor ( new Tree::Registry::Visitor );
+    db.accept ( visitor.get() );
+    return visitor->root();
+  }
+
+  // Write the text to a temporary file and then rename it, so that the 
+  // file is never half written if the program stops.
+  void writeText ( const std::string &file, Tree::Node::RefPtr root )
+  {
+    const std::string temp ( file + ".tmp" );
+    {
+      std::ofstream out ( temp.c_str() );
+      if ( false == out.is_open() )
+      {
+        throw Usul::Exceptions::Error ( "1489317542", "failed to open file for writing: " + temp );
+      }
+
+      Tree::IO::WriteRVHO::write ( root, out );
+
+      out.close();
+      if ( true == out.fail() )
+      {
+        throw Usul::Exceptions::Error ( "3702941358", "failed to write file: " + temp );
+      }
+    }
+
+    boost::filesystem::rename ( temp, file );
+  }
+
+  // Write the text and then the snapshot, which records the text file's 
+  // size and time.
+  void write ( const std::string &file, Tree::Node::RefPtr root, const Buffer &buffer )
+  {
+    State &s ( Helper::state() );
+    Lock writing ( s.writing );
+
+    // An earlier writer may have written the same thing.
+    if ( true == Helper::isWritten ( file, buffer ) )
+      return;
+
+    Helper::writeText ( file, root );
+    Tree::Registry::Binary::write ( Tree::Registry::Binary::snapshotFile ( file ), buffer, file );
+
+    Lock lock ( s.mutex );
+    s.written[file] = buffer;
+  }
+
+  // For the writer threads.
+  void writeNoThrow ( const std::string &file, Tree::Node::RefPtr root, const Buffer &buffer )
+  {
+    Usul::Functions::noThrow ( boost::bind ( &Helper::write, 
+      boost::cref ( file ), root, boost::cref ( buffer ) ), "2240691737" );
+  }
+
+  // Returns false if the snapshot could not be read.
+  bool readSnapshot ( const std::string &file, Usul::Registry::Database &db )
+  {
+    return Tree::Registry::Binary::read ( file, db );
+  }
+
+  // Make the state before there are threads. Wait for the writers at exit.
+  struct Init
+  {
+    Init()
+    {
+      Helper::state();
+    }
+    ~Init()
+    {
+      Helper::state().writers.join_all();
+    }
+  } _init;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read the registry. Use the snapshot unless the text file changed since
+//  the snapshot was made from it.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 void IO::read ( const std::string &file, Usul::Registry::Database &db )
 {
+  // Read the snapshot if we can. Fall back to the text file if it is bad.
+  const std::string snapshot ( Tree::Registry::Binary::snapshotFile ( file ) );
+  if ( true == Tree::Registry::Binary::isCurrent ( snapshot, file ) )
+  {
+    if ( true == Usul::Functions::noThrow ( boost::bind
+      ( &Helper::readSnapshot, boost::cref ( snapshot ), boost::ref ( db ) ), false, "1371905384" ) )
+    {
+      return;
+    }
+  }
+
   // Read the rvho file.
   Tree::Node::RefPtr root ( Tree::IO::ReadRVHO::read ( file ) );
   if ( false == root.valid() )
@@ -46,16 +205,52 @@ void IO::read ( const std::string &file, Usul::Registry::Database &db )
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Write the registry.
+//  Write the registry and its snapshot.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 void IO::write ( const std::string &file, Usul::Registry::Database &db )
 {
-  // Build the node tree.
-  Tree::Registry::Visitor::RefPtr visitor ( new Tree::Registry::Visitor );
-  db.accept ( visitor.get() );
+  // Copy the registry. Punt if it did not change.
+  Helper::Buffer buffer;
+  Tree::Node::RefPtr root ( Helper::copy ( file, db, buffer ) );
+  if ( false == root.valid() )
+    return;
 
   // Write it to disk.
-  Tree::IO::WriteRVHO::write ( visitor->root(), file );
+  Helper::write ( file, root, buffer );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copy the registry now and write it in another thread. Call wait() to
+//  be sure it is written, before the program exits.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void IO::writeLater ( const std::string &file, Usul::Registry::Database &db )
+{
+  // Copy the registry in this thread. Punt if it did not change.
+  Helper::Buffer buffer;
+  Tree::Node::RefPtr root ( Helper::copy ( file, db, buffer ) );
+  if ( false == root.valid() )
+    return;
+
+  // Write the copies in another thread.
+  Helper::State &s ( Helper::state() );
+  Helper::Lock lock ( s.mutex );
+  s.writers.create_thread ( boost::bind ( &Helper::writeNoThrow, file, root, buffer ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Wait for the registry writes to finish.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void IO::wait()
+{
+  Helper::state().writers.join_all();
 }
@@ -29,9 +29,19 @@ namespace Registry {
 
 struct TREE_REGISTRY_EXPORT IO
 {
-  // Read/write the registry.
+  // Read/write the registry. Reading uses the binary snapshot unless the
+  // text file changed. Writing encodes the whole registry and writes both 
+  // files, unless the bytes are the same as the last write to that file. 
+  // Each file is written to a temporary one that is then renamed.
   static void    read  ( const std::string &file, Usul::Registry::Database & );
   static void    write ( const std::string &file, Usul::Registry::Database & );
+
+  // Copy the registry now and write it in another thread.
+  static void    writeLater ( const std::string &file, Usul::Registry::Database & );
+
+  // Wait for the writes to finish. Call before the program exits, or a 
+  // write can be cut off.
+  static void    wait();
 };
 
 
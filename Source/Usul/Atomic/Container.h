@@ -24,10 +24,15 @@ namespace Usul {
 namespace Atomic {
 
 
-template < class ContainerType > struct Container : public Usul::Atomic::Object < ContainerType >
+template
+<
+  class ContainerType,
+  class MutexType_ = Usul::Threads::Mutex
+>
+struct Container : public Usul::Atomic::Object < ContainerType, MutexType_ >
 {
   // Typedefs
-  typedef Usul::Atomic::Object < ContainerType > BaseClass;
+  typedef Usul::Atomic::Object < ContainerType, MutexType_ > BaseClass;
   typedef typename BaseClass::ValueType ValueType;
   typedef typename BaseClass::Mutex Mutex;
   typedef typename BaseClass::Guard Guard;
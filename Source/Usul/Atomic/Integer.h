@@ -93,6 +93,26 @@ template < class IntegerType > struct Integer : public Usul::Atomic::Object < In
     return value;
   }
 
+  ValueType fetch_and_store ( ValueType v )
+  {
+    Guard guard ( this->mutex() );
+    ValueType value ( this->getReference() );
+    this->getReference() = v;
+    return value;
+  }
+
+  // Set to the value if it equals the comparand. Returns the old value.
+  ValueType compare_and_swap ( ValueType v, ValueType comparand )
+  {
+    Guard guard ( this->mutex() );
+    ValueType value ( this->getReference() );
+    if ( value == comparand )
+    {
+      this->getReference() = v;
+    }
+    return value;
+  }
+
 private:
 
   // Do not use these.
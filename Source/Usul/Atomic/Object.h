@@ -33,7 +33,7 @@ namespace Detail {
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-template < class ValueType_ > struct AtomicBase
+template < class ValueType_, class MutexType_ > struct AtomicBase
 {
   /////////////////////////////////////////////////////////////////////////////
   //
@@ -43,7 +43,7 @@ template < class ValueType_ > struct AtomicBase
 
   typedef ValueType_ ValueType;
   typedef ValueType value_type;
-  typedef Usul::Threads::Mutex Mutex;
+  typedef MutexType_ Mutex;
   typedef Usul::Threads::Guard<Mutex> Guard;
 
 
@@ -211,10 +211,15 @@ private:
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-template < class ValueType_ > struct Object : public Usul::Atomic::Detail::AtomicBase < ValueType_ >
+template
+<
+  class ValueType_,
+  class MutexType_ = Usul::Threads::Mutex
+>
+struct Object : public Usul::Atomic::Detail::AtomicBase < ValueType_, MutexType_ >
 {
   // Typedefs
-  typedef Usul::Atomic::Detail::AtomicBase<ValueType_> BaseClass;
+  typedef Usul::Atomic::Detail::AtomicBase<ValueType_,MutexType_> BaseClass;
   typedef typename BaseClass::ValueType ValueType;
   typedef typename BaseClass::Mutex Mutex;
   typedef typename BaseClass::Guard Guard;
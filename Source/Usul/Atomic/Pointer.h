@@ -0,0 +1,242 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Atomic slot for a reference-counting smart-pointer, without a mutex.
+//  Use it in place of Usul::Atomic::Object < X::RefPtr >.
+//
+//  The slot and the pointer are one 64-bit word. The high bits count how
+//  many readers have taken a reference from a batch that the slot added to
+//  the object when it was stored. A reader takes one with a single
+//  compare-and-swap, so it never touches an object that could be deleted.
+//  The reader that takes the last one of a batch adds the next batch. When
+//  the pointer is replaced, the references that were not taken are given
+//  back. Pointers have to fit in 48 bits, which they do for user-space
+//  addresses on the 64-bit systems we build for.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_ATOMIC_POINTER_CLASS_H_
+#define _USUL_ATOMIC_POINTER_CLASS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Atomic/Integer.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/thread/thread.hpp"
+
+#include <cstddef>
+
+
+namespace Usul {
+namespace Atomic {
+
+
+template < class PointerType_ > struct Pointer
+{
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Typedefs
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  typedef PointerType_ PointerType;
+  typedef PointerType ValueType;
+  typedef PointerType value_type;
+  typedef typename PointerType::element_type ElementType;
+  typedef Usul::Types::UInt64 Word;
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Constructors and destructor.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  Pointer() : _word ( 0 )
+  {
+  }
+  explicit Pointer ( const PointerType &p ) : _word ( Pointer::_make ( p ) )
+  {
+  }
+  Pointer ( const Pointer &p ) : _word ( Pointer::_make ( p._load() ) )
+  {
+  }
+  ~Pointer()
+  {
+    Pointer::_release ( _word );
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Set the new pointer and return the old one.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  PointerType fetchAndStore ( const PointerType &p )
+  {
+    const Word old ( _word.fetch_and_store ( Pointer::_make ( p ) ) );
+    PointerType answer ( Pointer::_pointer ( old ) );
+    Pointer::_release ( old );
+    return answer;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Assignment
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  Pointer &operator = ( const Pointer &p )
+  {
+    this->_store ( p._load() );
+    return *this;
+  }
+  Pointer &operator = ( const PointerType &p )
+  {
+    this->_store ( p );
+    return *this;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Typecast operator.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  operator PointerType () const
+  {
+    return this->_load();
+  }
+
+private:
+
+  enum
+  {
+    BATCH = 64,
+    SHIFT = ( ( 8 == sizeof ( void * ) ) ? 48 : 32 )
+  };
+
+  static Word _mask()
+  {
+    return ( ( static_cast < Word > ( 1 ) << SHIFT ) - 1 );
+  }
+
+  static ElementType *_pointer ( Word word )
+  {
+    return reinterpret_cast < ElementType * > ( static_cast < std::size_t > ( word & Pointer::_mask() ) );
+  }
+
+  static Word _count ( Word word )
+  {
+    return ( word >> SHIFT );
+  }
+
+  // Reference the object once for the slot and once for each reader.
+  static Word _make ( const PointerType &p )
+  {
+    ElementType *e ( const_cast < ElementType * > ( p.get() ) );
+    if ( 0x0 == e )
+      return 0;
+
+    for ( unsigned int i = 0; i <= BATCH; ++i )
+    {
+      e->ref();
+    }
+    return static_cast < Word > ( reinterpret_cast < std::size_t > ( e ) );
+  }
+
+  // Give back the references no reader took.
+  static void _release ( Word word )
+  {
+    ElementType *e ( Pointer::_pointer ( word ) );
+    if ( 0x0 == e )
+      return;
+
+    const Word remaining ( BATCH + 1 - Pointer::_count ( word ) );
+    for ( Word i = 0; i < remaining; ++i )
+    {
+      e->unref();
+    }
+  }
+
+  void _store ( const PointerType &p )
+  {
+    Pointer::_release ( _word.fetch_and_store ( Pointer::_make ( p ) ) );
+  }
+
+  PointerType _load() const
+  {
+    Word word ( _word );
+    while ( true )
+    {
+      ElementType *e ( Pointer::_pointer ( word ) );
+      if ( 0x0 == e )
+        return PointerType();
+
+      // Wait for the reader that took the last one to add more.
+      const Word count ( Pointer::_count ( word ) );
+      if ( count >= BATCH )
+      {
+        boost::this_thread::yield();
+        word = _word;
+        continue;
+      }
+
+      // Take one.
+      const Word next ( word + ( static_cast < Word > ( 1 ) << SHIFT ) );
+      const Word seen ( _word.compare_and_swap ( next, word ) );
+      if ( seen != word )
+      {
+        word = seen;
+        continue;
+      }
+
+      if ( BATCH == count + 1 )
+      {
+        this->_refill ( e, next );
+      }
+
+      // The answer has its own reference, so give back the one we took.
+      PointerType answer ( e );
+      e->unref ( false );
+      return answer;
+    }
+  }
+
+  // Add a batch and start counting again. If the pointer was replaced
+  // meanwhile then take them back.
+  void _refill ( ElementType *e, Word full ) const
+  {
+    for ( unsigned int i = 0; i < BATCH; ++i )
+    {
+      e->ref();
+    }
+    const Word empty ( full & Pointer::_mask() );
+    if ( full != _word.compare_and_swap ( empty, full ) )
+    {
+      for ( unsigned int i = 0; i < BATCH; ++i )
+      {
+        e->unref ( false );
+      }
+    }
+  }
+
+  mutable Usul::Atomic::Integer < Word > _word;
+};
+
+
+} // namespace Atomic
+} // namespace Usul
+
+
+#endif // _USUL_ATOMIC_POINTER_CLASS_H_
@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Atomic object for plain values that are read often and set rarely, like
+//  matrices and bounding spheres. Readers take no lock and write nothing.
+//  They copy the value, then try again if a writer changed it meanwhile.
+//  The value type has to be safe to copy while it is being written, so
+//  only use it for types without pointers or resources.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_ATOMIC_SEQUENCE_LOCK_CLASS_H_
+#define _USUL_ATOMIC_SEQUENCE_LOCK_CLASS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Atomic/Integer.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/Mutex.h"
+
+#include "boost/thread/thread.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+namespace Usul {
+namespace Atomic {
+namespace Detail {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Make sure the value is read before the sequence is read again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void readBarrier()
+{
+  #ifdef _MSC_VER
+  _ReadWriteBarrier();
+  #else
+  __sync_synchronize();
+  #endif
+}
+
+
+} // namespace Detail
+
+
+template < class ValueType_ > struct SeqLockObject
+{
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Typedefs
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  typedef ValueType_ ValueType;
+  typedef ValueType value_type;
+  typedef Usul::Threads::Mutex Mutex;
+  typedef Usul::Threads::Guard < Mutex > Guard;
+  typedef Usul::Atomic::Integer < unsigned long > Sequence;
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Constructors
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  SeqLockObject() : _sequence ( 0 ), _value(), _mutex()
+  {
+  }
+  explicit SeqLockObject ( const ValueType &v ) : _sequence ( 0 ), _value ( v ), _mutex()
+  {
+  }
+  SeqLockObject ( const SeqLockObject &v ) : _sequence ( 0 ), _value ( v._getCopy() ), _mutex()
+  {
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Set the new value and return the old one.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  ValueType fetchAndStore ( const ValueType &newValue )
+  {
+    Guard guard ( _mutex );
+    ValueType value ( _value );
+    this->_write ( newValue );
+    return value;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Assignment
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  SeqLockObject &operator = ( const SeqLockObject &v )
+  {
+    this->_setValue ( v._getCopy() );
+    return *this;
+  }
+  SeqLockObject &operator = ( const ValueType &v )
+  {
+    this->_setValue ( v );
+    return *this;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Typecast operator.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  operator ValueType () const
+  {
+    return this->_getCopy();
+  }
+
+private:
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Copy the value. The sequence is odd while a writer is busy, and it
+  //  changes when a writer is done.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  ValueType _getCopy() const
+  {
+    while ( true )
+    {
+      const unsigned long before ( _sequence );
+      if ( 0 == ( before & 1 ) )
+      {
+        const ValueType value ( _value );
+        Usul::Atomic::Detail::readBarrier();
+        if ( before == _sequence )
+        {
+          return value;
+        }
+      }
+      boost::this_thread::yield();
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Set the value.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  void _setValue ( const ValueType &v )
+  {
+    Guard guard ( _mutex );
+    this->_write ( v );
+  }
+
+  // The caller locks the mutex.
+  void _write ( const ValueType &v )
+  {
+    ++_sequence;
+    _value = v;
+    ++_sequence;
+  }
+
+  Sequence _sequence;
+  ValueType _value;
+  mutable Mutex _mutex;
+};
+
+
+} // namespace Atomic
+} // namespace Usul
+
+
+#endif // _USUL_ATOMIC_SEQUENCE_LOCK_CLASS_H_
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Like Usul::Atomic::Object but readers share the lock, so they do not
+//  wait for each other. Use it for values that are read often and set
+//  rarely. The lock is not recursive.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_ATOMIC_SHARED_OBJECT_CLASS_H_
+#define _USUL_ATOMIC_SHARED_OBJECT_CLASS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/ReadGuard.h"
+
+#include "boost/thread/shared_mutex.hpp"
+
+
+namespace Usul {
+namespace Atomic {
+
+
+template < class ValueType_ > struct SharedObject
+{
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Typedefs
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  typedef ValueType_ ValueType;
+  typedef ValueType value_type;
+  typedef boost::shared_mutex Mutex;
+  typedef Usul::Threads::Guard < Mutex > Guard;
+  typedef Usul::Threads::ReadGuard < Mutex > ReadGuard;
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Constructors
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  SharedObject() : _value(), _mutex()
+  {
+  }
+  explicit SharedObject ( const ValueType &v ) : _value ( v ), _mutex()
+  {
+  }
+  SharedObject ( const SharedObject &v ) : _value ( v._getCopy() ), _mutex()
+  {
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Get the mutex. Use with caution.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  Mutex &mutex() const
+  {
+    return _mutex;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Get a reference. Use with caution.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  const ValueType &getReference() const
+  {
+    return _value;
+  }
+  ValueType &getReference()
+  {
+    return _value;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Set the member variable if the predicate is true.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class Pred > bool setIf ( const ValueType &newValue, Pred pred )
+  {
+    Guard guard ( _mutex );
+    const bool result ( pred ( _value ) );
+    if ( result )
+    {
+      _value = newValue;
+    }
+    return result;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Set the new value and return the old one.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  ValueType fetchAndStore ( const ValueType &newValue )
+  {
+    Guard guard ( _mutex );
+    ValueType value ( _value );
+    _value = newValue;
+    return value;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Assignment
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  SharedObject &operator = ( const SharedObject &v )
+  {
+    this->_setValue ( v._getCopy() );
+    return *this;
+  }
+  SharedObject &operator = ( const ValueType &v )
+  {
+    this->_setValue ( v );
+    return *this;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Typecast operator.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  operator ValueType () const
+  {
+    return this->_getCopy();
+  }
+
+private:
+
+  ValueType _getCopy() const
+  {
+    ReadGuard guard ( _mutex );
+    return _value;
+  }
+
+  void _setValue ( const ValueType &v )
+  {
+    Guard guard ( _mutex );
+    _value = v;
+  }
+
+  ValueType _value;
+  mutable Mutex _mutex;
+};
+
+
+} // namespace Atomic
+} // namespace Usul
+
+
+#endif // _USUL_ATOMIC_SHARED_OBJECT_CLASS_H_
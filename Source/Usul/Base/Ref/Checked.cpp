@@ -0,0 +1,444 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reference-counted base class that checks for errors without locking.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Config/Config.h"
+#include "Usul/Base/Ref/Checked.h"
+#include "Usul/Errors/Assert.h"
+#include "Usul/Strings/Format.h"
+
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace Usul::Base::Ref;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions and data.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // The count after the object is marked for deletion. One less is the
+  // largest count allowed.
+  const Checked::RefCount DEAD ( std::numeric_limits < Checked::RefCount >::max() );
+
+  // Numbers the objects in the order they are made.
+  typedef Usul::Atomic::Integer < Usul::Types::UInt64 > Counter;
+  Counter nextNumber ( 0 );
+
+  // Return the name of the type.
+  inline std::string name ( const std::type_info *type )
+  {
+    const char *n ( ( 0x0 == type ) ? 0x0 : type->name() );
+    return std::string ( ( 0x0 == n ) ? "unknown type" : n );
+  }
+
+  inline void print ( const std::string &s )
+  {
+    if ( false == s.empty() )
+    {
+      #ifdef __APPLE__
+      ::fprintf( stderr, "%s\n", s.c_str() );
+      ::fflush( stderr );
+      #else
+      std::cout << s << std::flush;
+      #endif
+      #ifdef _MSC_VER
+      ::OutputDebugString ( s.c_str() );
+      #endif
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Lists of live objects. An object goes in the list picked by its address.
+//  There are many lists so that threads making objects seldom wait.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  const unsigned int NUM_SHARDS ( 64 );
+
+  typedef boost::mutex Mutex;
+  typedef boost::lock_guard < Mutex > Lock;
+
+  struct Shard
+  {
+    Shard() : mutex(), head ( 0x0 ), size ( 0 ){}
+    Mutex mutex;
+    Checked *head;
+    unsigned long size;
+    char padding[64]; // Keep the shards on different cache lines.
+  };
+
+  // Never deleted because objects may be freed during static destruction.
+  Shard *_shards ( 0x0 );
+
+  inline Shard *shards()
+  {
+    if ( 0x0 == _shards )
+    {
+      _shards = new Shard[NUM_SHARDS];
+    }
+    return _shards;
+  }
+
+  inline Shard &shard ( const void *address )
+  {
+    const std::size_t a ( reinterpret_cast < std::size_t > ( address ) );
+    return Helper::shards()[ ( ( a >> 4 ) ^ ( a >> 12 ) ) % NUM_SHARDS ];
+  }
+
+  // Make the lists before there are threads.
+  struct InitShards
+  {
+    InitShards()
+    {
+      Helper::shards();
+    }
+  } _initShards;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Report the objects that are still alive at exit.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef USUL_USE_INSTANCE_MANAGER
+
+namespace
+{
+  struct CheckLiveObjects
+  {
+    CheckLiveObjects(){}
+    ~CheckLiveObjects()
+    {
+      std::ostringstream out;
+      const unsigned long count ( Usul::Base::Ref::Checked::writeLiveObjects ( out ) );
+      if ( count > 0 )
+      {
+        USUL_ASSERT ( false ); // Heads up.
+        Helper::print ( Usul::Strings::format ( count, " objects remaining:\n", out.str() ) );
+      }
+    }
+  } checkLiveObjects;
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Checked::Checked() :
+  _refCount ( 0 ),
+  _objectNumber ( Helper::nextNumber++ ),
+  _type ( 0x0 ),
+  _prev ( 0x0 ),
+  _next ( 0x0 )
+{
+  this->_addLive();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copy constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Checked::Checked ( const Checked & ) :
+  _refCount ( 0 ),
+  _objectNumber ( Helper::nextNumber++ ),
+  _type ( 0x0 ),
+  _prev ( 0x0 ),
+  _next ( 0x0 )
+{
+  this->_addLive();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Checked::~Checked()
+{
+  const RefCount count ( _refCount );
+
+  if ( Helper::DEAD != count )
+  {
+    Helper::print ( Usul::Strings::format (
+      "Error 1480271685: Deleting object ", this,
+      " of type '", Helper::name ( _type ), "'",
+      " which has not been marked for deletion",
+      '\n' ) );
+
+    if ( 0 != count )
+    {
+      Helper::print ( Usul::Strings::format (
+        "Error 3306914276: Deleting object ", this, " with reference count ",
+        static_cast < Usul::Types::UInt64 > ( count ), '\n' ) );
+    }
+  }
+
+  this->_removeLive();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  We define this function to make sure the compiler does not.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Checked &Checked::operator = ( const Checked & )
+{
+  return *this;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add this object to the live objects.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Checked::_addLive()
+{
+  #ifdef USUL_USE_INSTANCE_MANAGER
+  Helper::Shard &s ( Helper::shard ( this ) );
+  Helper::Lock lock ( s.mutex );
+  _next = s.head;
+  if ( 0x0 != _next )
+  {
+    _next->_prev = this;
+  }
+  s.head = this;
+  ++s.size;
+  #endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove this object from the live objects.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Checked::_removeLive()
+{
+  #ifdef USUL_USE_INSTANCE_MANAGER
+  Helper::Shard &s ( Helper::shard ( this ) );
+  Helper::Lock lock ( s.mutex );
+  if ( 0x0 != _prev )
+  {
+    _prev->_next = _next;
+  }
+  else
+  {
+    s.head = _next;
+  }
+  if ( 0x0 != _next )
+  {
+    _next->_prev = _prev;
+  }
+  _prev = 0x0;
+  _next = 0x0;
+  --s.size;
+  #endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the objects that are alive now. Returns how many there are.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned long Checked::writeLiveObjects ( std::ostream &out )
+{
+  unsigned long total ( 0 );
+  Helper::Shard *shards ( Helper::shards() );
+  for ( unsigned int i = 0; i < Helper::NUM_SHARDS; ++i )
+  {
+    Helper::Shard &s ( shards[i] );
+    Helper::Lock lock ( s.mutex );
+    for ( const Checked *c = s.head; 0x0 != c; c = c->_next )
+    {
+      // The constructor only sees this class, so an object that was never 
+      // referenced has no type yet. It is alive, so ask it.
+      const std::type_info *type ( ( 0x0 == c->_type ) ? &typeid ( *c ) : c->_type );
+      out << "\tAddress: " << c
+          << ", Number: " << c->_objectNumber
+          << ", Type: " << Helper::name ( type )
+          << ", References: " << static_cast < Usul::Types::UInt64 > ( c->_refCount )
+          << '\n';
+    }
+    total += s.size;
+  }
+  return total;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Increment the reference count.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Checked::ref()
+{
+  // One atomic step. Undo it if the count was bad before.
+  const RefCount count ( _refCount++ );
+
+  // Are we already marked for deletion?
+  if ( Helper::DEAD == count )
+  {
+    --_refCount;
+    throw std::runtime_error ( Usul::Strings::format (
+      "Error 2745609148: Address ", this, ", type '", Helper::name ( _type ),
+      "', attempting to reference an object that has been marked for deletion" ) );
+  }
+
+  // Did we roll over?
+  if ( Helper::DEAD - 1 == count )
+  {
+    --_refCount;
+    throw std::runtime_error ( Usul::Strings::format (
+      "Error 3541183209: Address ", this, ", type '", this->_typeName(),
+      "', attempting to increment a reference count of ",
+      static_cast < Usul::Types::UInt64 > ( count ), " will overflow" ) );
+  }
+
+  // Now the object is fully made, so this is the real type.
+  if ( 0 == count )
+  {
+    _type = &typeid ( *this );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Decrement the reference count.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Checked::unref ( bool allowDelete )
+{
+  // One atomic step. Undo it if the count was bad before.
+  const RefCount count ( --_refCount );
+
+  // Were we already marked for deletion?
+  if ( Helper::DEAD - 1 == count )
+  {
+    ++_refCount;
+    throw std::runtime_error ( Usul::Strings::format (
+      "Error 1207387325: Address ", this, ", type '", Helper::name ( _type ),
+      "', attempting to dereference an object that has been marked for deletion" ) );
+  }
+
+  // Did we roll over?
+  if ( Helper::DEAD == count )
+  {
+    ++_refCount;
+    throw std::runtime_error ( Usul::Strings::format
+      ( "Error 4225620841: Address ", this, ", type '", this->_typeName(),
+      "', attempting to decrement a reference count that is already zero" ) );
+  }
+
+  if ( ( 0 != count ) || ( false == allowDelete ) )
+    return;
+
+  // Mark the object. If another thread referenced it in between then it
+  // is not ours to delete.
+  if ( 0 != _refCount.compare_and_swap ( Helper::DEAD, 0 ) )
+    return;
+
+  try
+  {
+    delete this;
+  }
+
+  catch ( std::exception &e )
+  {
+    const std::string message ( ( 0x0 == e.what() ) ?
+      std::string() : Usul::Strings::format ( ", ", e.what() ) );
+    throw std::runtime_error ( Usul::Strings::format (
+      "Error 2101870418: deleting address ", this, " caused an exception", message ) );
+  }
+
+  catch ( ... )
+  {
+    throw std::runtime_error ( Usul::Strings::format (
+      "Error 3658270351: deleting address ", this, " caused an exception" ) );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the reference count.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Checked::RefCount Checked::refCount() const
+{
+  const RefCount count ( _refCount );
+  return ( ( Helper::DEAD == count ) ? 0 : count );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the type name.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::string Checked::typeName() const
+{
+  return Helper::name ( &typeid ( *this ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the type name for a message. Only call virtual functions while
+//  the object is alive.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::string Checked::_typeName() const
+{
+  return ( ( Helper::DEAD == _refCount ) ? Helper::name ( _type ) : this->typeName() );
+}
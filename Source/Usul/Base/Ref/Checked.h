@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reference-counted base class that checks for errors, like Careful, but
+//  without a mutex per object. The count is atomic. Live objects are kept
+//  in lists that are split by address, so threads seldom share a lock. The
+//  type is kept when the object is first referenced, for messages about it
+//  after it is deleted. Live objects that were never referenced are listed
+//  with the type they have then. The name is only made when it is needed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_BASE_CHECKED_REFERENCE_COUNTED_CLASS_H_
+#define _USUL_BASE_CHECKED_REFERENCE_COUNTED_CLASS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/Atomic/Integer.h"
+#include "Usul/Types/Types.h"
+
+#include <iosfwd>
+#include <string>
+#include <typeinfo>
+
+
+namespace Usul {
+namespace Base {
+namespace Ref {
+
+
+class USUL_EXPORT Checked
+{
+public:
+
+  typedef unsigned long RefCount;
+
+  void                    ref();
+  void                    unref ( bool allowDelete = true );
+
+  RefCount                refCount() const;
+
+  virtual std::string     typeName() const;
+
+  // Write the objects that are alive now. Returns how many there are.
+  static unsigned long    writeLiveObjects ( std::ostream & );
+
+protected:
+
+  Checked();
+  Checked ( const Checked &r );
+  Checked &operator = ( const Checked &r );
+  virtual ~Checked();
+
+private:
+
+  typedef Usul::Atomic::Integer < RefCount > AtomicRefCount;
+
+  void                    _addLive();
+  void                    _removeLive();
+  std::string             _typeName() const;
+
+  AtomicRefCount _refCount;
+  Usul::Types::UInt64 _objectNumber;
+  const std::type_info *_type;
+  Checked *_prev;
+  Checked *_next;
+};
+
+
+} // namespace Ref
+} // namespace Base
+} // namespace Usul
+
+
+#endif // _USUL_BASE_CHECKED_REFERENCE_COUNTED_CLASS_H_
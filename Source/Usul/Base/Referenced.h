@@ -23,6 +23,9 @@
 #ifdef USUL_BASE_REFERENCED_CAREFUL
 #include "Usul/Base/Ref/Careful.h"
 #endif
+#ifdef USUL_BASE_REFERENCED_CHECKED
+#include "Usul/Base/Ref/Checked.h"
+#endif
 #ifdef USUL_BASE_REFERENCED_MULTI_THREADED
 #include "Usul/Base/Ref/MultiThreaded.h"
 #endif
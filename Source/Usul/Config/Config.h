@@ -62,7 +62,8 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Turn on/off use of an instance-manager in Usul::Base::Ref::Careful.
+//  Turn on/off use of an instance-manager in Usul::Base::Ref::Careful and
+//  the list of live objects in Usul::Base::Ref::Checked.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -91,6 +92,12 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef _DEBUG
+#define USUL_BASE_REFERENCED_BASE_CLASS \
+  Usul::Base::Ref::Checked
+#define USUL_BASE_REFERENCED_CHECKED
+#endif
+
+#if 0
 #define USUL_BASE_REFERENCED_BASE_CLASS \
   Usul::Base::Ref::Careful
 #define USUL_BASE_REFERENCED_CAREFUL
@@ -219,4 +226,46 @@
 #endif // USUL_PLUGIN_POSTFIX_DEBUG
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Does the compiler have rvalue references? USUL_MOVE is std::move when it
+//  does, and a copy when it does not.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#if ( __cplusplus >= 201103L ) || defined ( __GXX_EXPERIMENTAL_CXX0X__ ) || ( defined ( _MSC_VER ) && ( _MSC_VER >= 1600 ) )
+#define USUL_HAS_RVALUE_REFERENCES
+#endif
+
+#ifdef USUL_HAS_RVALUE_REFERENCES
+#include <utility>
+#define USUL_MOVE(x) std::move ( x )
+#else
+#define USUL_MOVE(x) ( x )
+#endif
+
+#if ( __cplusplus >= 201103L ) || ( defined ( _MSC_VER ) && ( _MSC_VER >= 1900 ) )
+#define USUL_NO_THROW noexcept
+#else
+#define USUL_NO_THROW throw()
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Can we use SSE2 or AVX intrinsics? All 64-bit x86 processors have SSE2.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined ( __SSE2__ ) || defined ( _M_X64 ) || ( defined ( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+#define USUL_HAS_SSE2
+#endif
+
+// Only when the compiler is told it can use AVX, because not all processors
+// have it.
+#if defined ( __AVX__ )
+#define USUL_HAS_AVX
+#endif
+
+
 #endif // _USUL_DLL_CONFIG_H_
@@ -18,15 +18,129 @@
 #define _USUL_CONVERT_COMMON_CONVERSIONS_H_
 
 #include "Usul/Convert/Generic.h"
+#include "Usul/IO/TextNumber.h"
 #include "Usul/IO/TextReader.h"
 #include "Usul/IO/TextWriter.h"
 #include "Usul/Types/Types.h"
 
-#include <algorithm>
 #include <sstream>
 #include <string>
 
 
+namespace Usul {
+namespace Convert {
+namespace Detail {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Append the number.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void append ( std::string &to, short i )              { Usul::IO::Text::Detail::appendInteger ( to, static_cast < Usul::Types::LongLong > ( i ) ); }
+inline void append ( std::string &to, int i )                { Usul::IO::Text::Detail::appendInteger ( to, static_cast < Usul::Types::LongLong > ( i ) ); }
+inline void append ( std::string &to, long i )               { Usul::IO::Text::Detail::appendInteger ( to, static_cast < Usul::Types::LongLong > ( i ) ); }
+inline void append ( std::string &to, long long i )          { Usul::IO::Text::Detail::appendInteger ( to, static_cast < Usul::Types::LongLong > ( i ) ); }
+inline void append ( std::string &to, unsigned short u )     { Usul::IO::Text::Detail::appendInteger ( to, static_cast < Usul::Types::ULongLong > ( u ), false ); }
+inline void append ( std::string &to, unsigned int u )       { Usul::IO::Text::Detail::appendInteger ( to, static_cast < Usul::Types::ULongLong > ( u ), false ); }
+inline void append ( std::string &to, unsigned long u )      { Usul::IO::Text::Detail::appendInteger ( to, static_cast < Usul::Types::ULongLong > ( u ), false ); }
+inline void append ( std::string &to, unsigned long long u ) { Usul::IO::Text::Detail::appendInteger ( to, static_cast < Usul::Types::ULongLong > ( u ), false ); }
+inline void append ( std::string &to, float f )              { Usul::IO::Text::Detail::appendReal ( to, f ); }
+inline void append ( std::string &to, double d )             { Usul::IO::Text::Detail::appendReal ( to, d ); }
+inline void append ( std::string &to, long double d )        { Usul::IO::Text::Detail::appendReal ( to, d ); }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parse the number after any white space. Like a stream, this stops at
+//  the first character that is not part of the number. Unlike a stream,
+//  the value is left alone when there is no number.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > inline const char *parse ( const char *begin, const char *end, T &t )
+{
+  begin = Usul::IO::Text::Detail::skipSpace ( begin, end );
+  return Usul::IO::Text::Detail::NumberType < T > ::parse ( begin, end, t );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  How the numbers are laid out in the text.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct Scalar
+{
+  template < class T > static void write ( std::string &to, const T &t )
+  {
+    Detail::append ( to, t );
+  }
+  template < class T > static void read ( const char *begin, const char *end, T &t )
+  {
+    Detail::parse ( begin, end, t );
+  }
+};
+
+template < unsigned int Size > struct Vector
+{
+  template < class T > static void write ( std::string &to, const T &v )
+  {
+    for ( unsigned int i = 0; i < Size; ++i )
+    {
+      if ( i > 0 )
+      {
+        to += ' ';
+      }
+      Detail::append ( to, v[i] );
+    }
+  }
+  template < class T > static void read ( const char *begin, const char *end, T &v )
+  {
+    for ( unsigned int i = 0; i < Size; ++i )
+    {
+      const char *stop ( Detail::parse ( begin, end, v[i] ) );
+      if ( begin == stop )
+        return;
+      begin = stop;
+    }
+  }
+};
+
+struct Matrix44
+{
+  // Row by row, like the stream writer.
+  template < class T > static void write ( std::string &to, const T &m )
+  {
+    for ( unsigned int i = 0; i < 16; ++i )
+    {
+      if ( i > 0 )
+      {
+        to += ' ';
+      }
+      Detail::append ( to, m ( i / 4, i % 4 ) );
+    }
+  }
+  template < class T > static void read ( const char *begin, const char *end, T &m )
+  {
+    for ( unsigned int i = 0; i < 16; ++i )
+    {
+      const char *stop ( Detail::parse ( begin, end, m ( i / 4, i % 4 ) ) );
+      if ( begin == stop )
+        return;
+      begin = stop;
+    }
+  }
+};
+
+
+} // namespace Detail
+} // namespace Convert
+} // namespace Usul
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  String conversion for boolean.
@@ -171,6 +285,68 @@ namespace Usul \
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Macro for defining converters to-from std::string for numbers and
+//  things made of numbers. These do not use a stream or the locale.
+//  Floating-point numbers are written with the shortest text that reads
+//  back as the same number, denormals and negative zero included.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define USUL_CONVERT_DEFINE_NUMBER_CONVERTER(the_type,the_layout) \
+namespace Usul \
+{ \
+  namespace Convert \
+  { \
+    template <> struct Type < the_type, std::string > \
+    { \
+      typedef Type < the_type, std::string > ThisType; \
+      static void convert ( const the_type &from, std::string &to ) \
+      { \
+        to.clear(); \
+        the_layout::write ( to, from ); \
+      } \
+      static std::string convert ( const the_type &from ) \
+      { \
+        std::string to; \
+        ThisType::convert ( from, to ); \
+        return to; \
+      } \
+    }; \
+    template <> struct Type < std::string, the_type > \
+    { \
+      typedef Type < std::string, the_type > ThisType; \
+      static void convert ( const std::string &from, the_type &to ) \
+      { \
+        the_layout::read ( from.c_str(), from.c_str() + from.size(), to ); \
+      } \
+      static the_type convert ( const std::string &from ) \
+      { \
+        the_type to = the_type(); \
+        ThisType::convert ( from, to ); \
+        return to; \
+      } \
+    }; \
+  } \
+}
+
+#define USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR(the_type) \
+  USUL_CONVERT_DEFINE_NUMBER_CONVERTER ( the_type, Usul::Convert::Detail::Scalar )
+
+#define USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2(the_type) \
+  USUL_CONVERT_DEFINE_NUMBER_CONVERTER ( the_type, Usul::Convert::Detail::Vector<2> )
+
+#define USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3(the_type) \
+  USUL_CONVERT_DEFINE_NUMBER_CONVERTER ( the_type, Usul::Convert::Detail::Vector<3> )
+
+#define USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4(the_type) \
+  USUL_CONVERT_DEFINE_NUMBER_CONVERTER ( the_type, Usul::Convert::Detail::Vector<4> )
+
+#define USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4(the_type) \
+  USUL_CONVERT_DEFINE_NUMBER_CONVERTER ( the_type, Usul::Convert::Detail::Matrix44 )
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Macros for defining converters.
@@ -204,21 +380,22 @@ namespace Usul \
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+// Characters are text, not numbers, so they still use the stream.
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( char );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( short );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( int );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( long );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::LongLong );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( short );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( int );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( long );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( Usul::Types::LongLong );
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::UChar );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::UShort );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::UInt );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::ULong );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::ULongLong );
-
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::Float32 );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::Float64 );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Types::LongDouble );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( Usul::Types::UShort );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( Usul::Types::UInt );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( Usul::Types::ULong );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( Usul::Types::ULongLong );
+
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( Usul::Types::Float32 );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( Usul::Types::Float64 );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_SCALAR ( Usul::Types::LongDouble );
 
 
 #endif // _USUL_CONVERT_COMMON_CONVERSIONS_H_
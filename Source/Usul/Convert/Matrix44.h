@@ -22,18 +22,18 @@
 
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44c );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44s );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44i );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44l );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44s );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44i );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44l );
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44uc );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44us );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44ui );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44ul );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44us );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44ui );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44ul );
 
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44f );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44d );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Matrix44ld );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44f );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44d );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_MATRIX_4_4 ( Usul::Math::Matrix44ld );
 
 
 #endif // _USUL_CONVERT_STRING_MATRIX_4_4_H_
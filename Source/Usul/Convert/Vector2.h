@@ -22,18 +22,18 @@
 
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2c );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2s );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2i );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2l );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2s );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2i );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2l );
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2uc );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2us );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2ui );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2ul );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2us );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2ui );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2ul );
 
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2f );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2d );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec2ld );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2f );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2d );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_2 ( Usul::Math::Vec2ld );
 
 
 #endif // _USUL_CONVERT_STRING_VECTOR_2_H_
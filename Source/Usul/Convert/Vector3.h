@@ -22,18 +22,18 @@
 
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3c );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3s );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3i );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3l );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3s );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3i );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3l );
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3uc );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3us );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3ui );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3ul );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3us );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3ui );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3ul );
 
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3f );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3d );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec3ld );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3f );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3d );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_3 ( Usul::Math::Vec3ld );
 
 
 #endif // _USUL_CONVERT_STRING_VECTOR_3_H_
@@ -22,18 +22,18 @@
 
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4c );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4s );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4i );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4l );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4s );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4i );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4l );
 
 USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4uc );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4us );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4ui );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4ul );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4us );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4ui );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4ul );
 
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4f );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4d );
-USUL_CONVERT_DEFINE_STRING_CONVERTER ( Usul::Math::Vec4ld );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4f );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4d );
+USUL_CONVERT_DEFINE_NUMBER_CONVERTER_VECTOR_4 ( Usul::Math::Vec4ld );
 
 
 #endif // _USUL_CONVERT_STRING_VECTOR_4_H_
@@ -29,6 +29,8 @@
 #include "Usul/MPL/SameType.h"
 #include "Usul/Strings/Format.h"
 
+#include <cstddef>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
@@ -202,28 +204,28 @@ namespace Usul
           return;
         }
 
-        // Make space in the vector.
-        to.reserve ( count );
+        // Make sure the points are all there.
+        const unsigned char *end ( &from[0] + from.size() );
+        const unsigned char *points ( USUL_UNSAFE_CAST ( const unsigned char *, values ) );
+        if ( ( static_cast < std::size_t > ( end - points ) / ( 2 * sizeof ( Usul::Types::Float64 ) ) ) < count )
+        {
+          throw std::invalid_argument 
+	    ( Usul::Strings::format 
+	      ( "Error 1722083264: Character vector size ", from.size(), 
+		" is too small for ", count, " points" ) );
+        }
 
-        // Loop through the points.
-        for ( Usul::Types::UInt32 i = 0; i < count; ++i )
+        // Copy the points and then convert them all at once.
+        to.resize ( count );
+        Usul::Types::Float64 *numbers ( &to[0][0] );
+        std::memcpy ( numbers, points, count * 2 * sizeof ( Usul::Types::Float64 ) );
+        if ( 0 == endian )
+        {
+          Usul::Endian::FromBigToSystem::convert ( numbers, count * 2 );
+        }
+        else
         {
-          Usul::Types::Float64 x ( *values ); ++values;
-          Usul::Types::Float64 y ( *values ); ++values;
-
-          if ( 0 == endian )
-          {
-            Usul::Endian::FromBigToSystem::convert ( x );
-            Usul::Endian::FromBigToSystem::convert ( y );
-          }
-
-          else
-          {
-            Usul::Endian::FromLittleToSystem::convert ( x );
-            Usul::Endian::FromLittleToSystem::convert ( y );
-          }
-
-          to.push_back ( Usul::Math::Vec2d ( x, y ) );
+          Usul::Endian::FromLittleToSystem::convert ( numbers, count * 2 );
         }
       }
 
@@ -16,9 +16,16 @@
 #ifndef _USUL_LIBRARY_ENDIAN_H_
 #define _USUL_LIBRARY_ENDIAN_H_
 
+#include "Usul/Config/Config.h"
 #include "Usul/Types/Types.h"
 #include "Usul/Cast/Cast.h"
 
+#include <cstddef>
+
+#ifdef USUL_HAS_SSE2
+# include <emmintrin.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  For 1025, which, in binary is:
@@ -174,6 +181,61 @@ inline void _reverseBytes ( Usul::Types::UInt64 &n )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reverse the bytes of each number in 16 bytes of data.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef USUL_HAS_SSE2
+
+inline __m128i _reverseBlock ( __m128i v, const Usul::Types::UInt16 * )
+{
+  return _mm_or_si128 ( _mm_slli_epi16 ( v, 8 ), _mm_srli_epi16 ( v, 8 ) );
+}
+inline __m128i _reverseBlock ( __m128i v, const Usul::Types::UInt32 * )
+{
+  v = _reverseBlock ( v, static_cast < const Usul::Types::UInt16 * > ( 0x0 ) );
+  v = _mm_shufflelo_epi16 ( v, _MM_SHUFFLE ( 2, 3, 0, 1 ) );
+  return _mm_shufflehi_epi16 ( v, _MM_SHUFFLE ( 2, 3, 0, 1 ) );
+}
+inline __m128i _reverseBlock ( __m128i v, const Usul::Types::UInt64 * )
+{
+  v = _reverseBlock ( v, static_cast < const Usul::Types::UInt16 * > ( 0x0 ) );
+  v = _mm_shufflelo_epi16 ( v, _MM_SHUFFLE ( 0, 1, 2, 3 ) );
+  return _mm_shufflehi_epi16 ( v, _MM_SHUFFLE ( 0, 1, 2, 3 ) );
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reverse the bytes of each integer in the array. With SSE2 we do 16 
+//  bytes at a time, and then the rest one at a time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class UInt > inline void _reverseArray ( UInt *n, std::size_t count )
+{
+  std::size_t i ( 0 );
+
+  #ifdef USUL_HAS_SSE2
+  const std::size_t perBlock ( 16 / sizeof ( UInt ) );
+  for ( ; ( i + perBlock ) <= count; i += perBlock )
+  {
+    __m128i *block ( reinterpret_cast < __m128i * > ( n + i ) );
+    _mm_storeu_si128 ( block, _reverseBlock ( _mm_loadu_si128 ( block ), n ) );
+  }
+  #endif
+
+  for ( ; i < count; ++i )
+  {
+    Usul::Endian::Detail::_reverseBytes ( n[i] );
+  }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Template definition and specialization for reversing the bytes.
@@ -181,6 +243,27 @@ inline void _reverseBytes ( Usul::Types::UInt64 &n )
 ///////////////////////////////////////////////////////////////////////////////
 
 template < unsigned int Size > struct ReverseBytes;
+template <> struct ReverseBytes < sizeof ( Usul::Types::UInt8 ) >
+{
+  void operator () ( Usul::Types::UInt8 & ) const
+  {
+  }
+  void operator () ( Usul::Types::Int8 & ) const
+  {
+  }
+  void operator () ( char & ) const
+  {
+  }
+  void operator () ( Usul::Types::UInt8 *, std::size_t ) const
+  {
+  }
+  void operator () ( Usul::Types::Int8 *, std::size_t ) const
+  {
+  }
+  void operator () ( char *, std::size_t ) const
+  {
+  }
+};
 template <> struct ReverseBytes < sizeof ( Usul::Types::UInt16 ) >
 {
   void operator () ( Usul::Types::UInt16 &n ) const
@@ -191,6 +274,14 @@ template <> struct ReverseBytes < sizeof ( Usul::Types::UInt16 ) >
   {
     Usul::Endian::Detail::_reverseBytes ( Usul::Cast::unsafe<Usul::Types::UInt16&,Usul::Types::Int16&> ( n ) );
   }
+  void operator () ( Usul::Types::UInt16 *n, std::size_t count ) const
+  {
+    Usul::Endian::Detail::_reverseArray ( n, count );
+  }
+  void operator () ( Usul::Types::Int16 *n, std::size_t count ) const
+  {
+    Usul::Endian::Detail::_reverseArray ( reinterpret_cast < Usul::Types::UInt16 * > ( n ), count );
+  }
 };
 template <> struct ReverseBytes < sizeof ( Usul::Types::UInt32 ) >
 {
@@ -206,6 +297,18 @@ template <> struct ReverseBytes < sizeof ( Usul::Types::UInt32 ) >
   {
     Usul::Endian::Detail::_reverseBytes ( Usul::Cast::unsafe<Usul::Types::UInt32&,Usul::Types::Float32&> ( n ) );
   }
+  void operator () ( Usul::Types::UInt32 *n, std::size_t count ) const
+  {
+    Usul::Endian::Detail::_reverseArray ( n, count );
+  }
+  void operator () ( Usul::Types::Int32 *n, std::size_t count ) const
+  {
+    Usul::Endian::Detail::_reverseArray ( reinterpret_cast < Usul::Types::UInt32 * > ( n ), count );
+  }
+  void operator () ( Usul::Types::Float32 *n, std::size_t count ) const
+  {
+    Usul::Endian::Detail::_reverseArray ( reinterpret_cast < Usul::Types::UInt32 * > ( n ), count );
+  }
 };
 template <> struct ReverseBytes < sizeof ( Usul::Types::UInt64 ) >
 {
@@ -221,6 +324,18 @@ template <> struct ReverseBytes < sizeof ( Usul::Types::UInt64 ) >
   {
     Usul::Endian::Detail::_reverseBytes ( Usul::Cast::unsafe<Usul::Types::UInt64&,Usul::Types::Float64&> ( n ) );
   }
+  void operator () ( Usul::Types::UInt64 *n, std::size_t count ) const
+  {
+    Usul::Endian::Detail::_reverseArray ( n, count );
+  }
+  void operator () ( Usul::Types::Int64 *n, std::size_t count ) const
+  {
+    Usul::Endian::Detail::_reverseArray ( reinterpret_cast < Usul::Types::UInt64 * > ( n ), count );
+  }
+  void operator () ( Usul::Types::Float64 *n, std::size_t count ) const
+  {
+    Usul::Endian::Detail::_reverseArray ( reinterpret_cast < Usul::Types::UInt64 * > ( n ), count );
+  }
 };
 
 
@@ -246,6 +361,19 @@ template < class Type > inline void reverseBytes ( Type &n )
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reverse the bytes of each number in the array.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class Type > inline void reverseBytes ( Type *n, std::size_t count )
+{
+  typedef Usul::Endian::Detail::ReverseBytes < sizeof ( Type ) > ReverseBytes;
+  ReverseBytes () ( n, count );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Convert the bytes.
@@ -254,12 +382,26 @@ template < class Type > inline void reverseBytes ( Type &n )
 
 struct FromSystemToBig
 {
+  #ifdef USUL_LITTLE_ENDIAN
+  enum { REVERSES = true };
+  #else
+  enum { REVERSES = false };
+  #endif
   template < class T > static void convert ( T &t )
   {
     #ifdef USUL_LITTLE_ENDIAN
     Usul::Endian::reverseBytes ( t );
     #endif
   }
+  template < class T > static void convert ( T *t, std::size_t count )
+  {
+    #ifdef USUL_LITTLE_ENDIAN
+    Usul::Endian::reverseBytes ( t, count );
+    #else
+    static_cast < void > ( t );
+    static_cast < void > ( count );
+    #endif
+  }
   template < class T > void operator () ( T &t )
   {
     this->convert ( t );
@@ -275,12 +417,26 @@ struct FromSystemToBig
 
 struct FromSystemToLittle
 {
+  #ifdef USUL_BIG_ENDIAN
+  enum { REVERSES = true };
+  #else
+  enum { REVERSES = false };
+  #endif
   template < class T > static void convert ( T &t )
   {
     #ifdef USUL_BIG_ENDIAN
     Usul::Endian::reverseBytes ( t );
     #endif
   }
+  template < class T > static void convert ( T *t, std::size_t count )
+  {
+    #ifdef USUL_BIG_ENDIAN
+    Usul::Endian::reverseBytes ( t, count );
+    #else
+    static_cast < void > ( t );
+    static_cast < void > ( count );
+    #endif
+  }
   template < class T > void operator () ( T &t )
   {
     this->convert ( t );
@@ -296,12 +452,26 @@ struct FromSystemToLittle
 
 struct FromBigToSystem
 {
+  #ifdef USUL_LITTLE_ENDIAN
+  enum { REVERSES = true };
+  #else
+  enum { REVERSES = false };
+  #endif
   template < class T > static void convert ( T &t )
   {
     #ifdef USUL_LITTLE_ENDIAN
     Usul::Endian::reverseBytes ( t );
     #endif
   }
+  template < class T > static void convert ( T *t, std::size_t count )
+  {
+    #ifdef USUL_LITTLE_ENDIAN
+    Usul::Endian::reverseBytes ( t, count );
+    #else
+    static_cast < void > ( t );
+    static_cast < void > ( count );
+    #endif
+  }
   template < class T > void operator () ( T &t )
   {
     this->convert ( t );
@@ -317,12 +487,26 @@ struct FromBigToSystem
 
 struct FromLittleToSystem
 {
+  #ifdef USUL_BIG_ENDIAN
+  enum { REVERSES = true };
+  #else
+  enum { REVERSES = false };
+  #endif
   template < class T > static void convert ( T &t )
   {
     #ifdef USUL_BIG_ENDIAN
     Usul::Endian::reverseBytes ( t );
     #endif
   }
+  template < class T > static void convert ( T *t, std::size_t count )
+  {
+    #ifdef USUL_BIG_ENDIAN
+    Usul::Endian::reverseBytes ( t, count );
+    #else
+    static_cast < void > ( t );
+    static_cast < void > ( count );
+    #endif
+  }
   template < class T > void operator () ( T &t )
   {
     this->convert ( t );
@@ -338,9 +522,13 @@ struct FromLittleToSystem
 
 struct FromSystemToSystem
 {
+  enum { REVERSES = false };
   template < class T > static void convert ( T &t )
   {
   }
+  template < class T > static void convert ( T *, std::size_t )
+  {
+  }
   template < class T > void operator () ( T &t )
   {
   }
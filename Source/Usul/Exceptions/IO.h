@@ -0,0 +1,53 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Exceptions for reading and writing.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_EXCEPTIONS_IO_H_
+#define _USUL_EXCEPTIONS_IO_H_
+
+#include <stdexcept>
+#include <string>
+
+
+namespace Usul {
+namespace Exceptions {
+namespace IO {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Reached the end of the file before reading everything.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class UnexpectedEndOfFile : public std::runtime_error
+{
+public:
+
+  typedef std::runtime_error BaseClass;
+  UnexpectedEndOfFile() : BaseClass ( "Message 2398826420: Unexpected end of file reached" )
+  {
+  }
+  UnexpectedEndOfFile ( const std::string &message ) : BaseClass ( message )
+  {
+  }
+};
+
+
+} // namespace IO
+} // namespace Exceptions
+} // namespace Usul
+
+
+#endif // _USUL_EXCEPTIONS_IO_H_
@@ -0,0 +1,252 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read-only file that is mapped into memory.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/File/MappedFile.h"
+#include "Usul/Functions/NoThrow.h"
+#include "Usul/Strings/Format.h"
+#include "Usul/System/LastError.h"
+
+#include "boost/bind.hpp"
+
+#ifdef _MSC_VER
+# include "windows.h"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <limits>
+#include <stdexcept>
+
+using namespace Usul::File;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // Throw with the system's message appended.
+  inline void fail ( const std::string &id, const std::string &what, const std::string &name )
+  {
+    const std::string message ( ( true == Usul::System::LastError::has() ) ?
+      ( std::string ( ". System error: " ) + Usul::System::LastError::message() ) : std::string() );
+    throw std::runtime_error ( Usul::Strings::format ( "Error ", id, ": ", what, name, message ) );
+  }
+
+  // Make sure the size fits in the address space.
+  inline std::size_t length ( Usul::Types::UInt64 size, const std::string &name )
+  {
+    if ( size > static_cast < Usul::Types::UInt64 > ( std::numeric_limits < std::size_t >::max() ) )
+    {
+      throw std::runtime_error ( Usul::Strings::format
+        ( "Error 3010836465: File '", name, "' is too big to map into memory" ) );
+    }
+    return static_cast < std::size_t > ( size );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MappedFile::MappedFile ( const std::string &name, unsigned int hints ) : BaseClass ( name ),
+  _bytes ( 0x0 ),
+  _length ( 0 )
+{
+  // Initialize last error.
+  Usul::System::LastError::init();
+
+  #ifdef _MSC_VER
+
+  // Windows only has a hint for reading in order.
+  const DWORD flags ( ( SEQUENTIAL == ( hints & SEQUENTIAL ) ) ?
+    FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL );
+  HANDLE file ( ::CreateFileA ( name.c_str(), GENERIC_READ, FILE_SHARE_READ,
+    0x0, OPEN_EXISTING, flags, 0x0 ) );
+  if ( INVALID_HANDLE_VALUE == file )
+  {
+    Helper::fail ( "2290485373", "Failed to open file: ", name );
+  }
+
+  LARGE_INTEGER size;
+  if ( FALSE == ::GetFileSizeEx ( file, &size ) )
+  {
+    ::CloseHandle ( file );
+    Helper::fail ( "1841961406", "Failed to get size of file: ", name );
+  }
+
+  // Empty files cannot be mapped.
+  if ( 0 == size.QuadPart )
+  {
+    ::CloseHandle ( file );
+    return;
+  }
+
+  // The view keeps the file open after the handles are closed.
+  HANDLE mapping ( ::CreateFileMappingA ( file, 0x0, PAGE_READONLY, 0, 0, 0x0 ) );
+  ::CloseHandle ( file );
+  if ( 0x0 == mapping )
+  {
+    Helper::fail ( "3926537011", "Failed to map file: ", name );
+  }
+
+  const std::size_t length ( Helper::length ( static_cast < Usul::Types::UInt64 > ( size.QuadPart ), name ) );
+  const void *view ( ::MapViewOfFile ( mapping, FILE_MAP_READ, 0, 0, length ) );
+  ::CloseHandle ( mapping );
+  if ( 0x0 == view )
+  {
+    Helper::fail ( "1227961394", "Failed to map view of file: ", name );
+  }
+
+  _bytes = static_cast < const char * > ( view );
+  _length = length;
+
+  #else
+
+  const int file ( ::open ( name.c_str(), O_RDONLY ) );
+  if ( -1 == file )
+  {
+    Helper::fail ( "2290485373", "Failed to open file: ", name );
+  }
+
+  struct stat info;
+  if ( -1 == ::fstat ( file, &info ) )
+  {
+    ::close ( file );
+    Helper::fail ( "1841961406", "Failed to get size of file: ", name );
+  }
+
+  // Empty files cannot be mapped.
+  if ( 0 == info.st_size )
+  {
+    ::close ( file );
+    return;
+  }
+
+  // The mapping keeps the file open after it is closed.
+  const std::size_t length ( Helper::length ( static_cast < Usul::Types::UInt64 > ( info.st_size ), name ) );
+  void *view ( ::mmap ( 0x0, length, PROT_READ, MAP_PRIVATE, file, 0 ) );
+  ::close ( file );
+  if ( MAP_FAILED == view )
+  {
+    Helper::fail ( "3926537011", "Failed to map file: ", name );
+  }
+
+  // The hints are only advice, so errors are ignored.
+  if ( SEQUENTIAL == ( hints & SEQUENTIAL ) )
+  {
+    ::madvise ( view, length, MADV_SEQUENTIAL );
+  }
+  if ( WILL_NEED == ( hints & WILL_NEED ) )
+  {
+    ::madvise ( view, length, MADV_WILLNEED );
+  }
+
+  _bytes = static_cast < const char * > ( view );
+  _length = length;
+
+  #endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+MappedFile::~MappedFile()
+{
+  Usul::Functions::noThrow ( boost::bind ( &MappedFile::_unmap, this ), "1649232290" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Unmap the file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void MappedFile::_unmap()
+{
+  if ( 0x0 == _bytes )
+    return;
+
+  #ifdef _MSC_VER
+  ::UnmapViewOfFile ( _bytes );
+  #else
+  ::munmap ( const_cast < char * > ( _bytes ), _length );
+  #endif
+
+  _bytes = 0x0;
+  _length = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the first byte.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const char *MappedFile::begin() const
+{
+  return _bytes;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return one past the last byte.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const char *MappedFile::end() const
+{
+  return ( _bytes + _length );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is the file empty?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool MappedFile::empty() const
+{
+  return ( 0 == _length );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of bytes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+std::size_t MappedFile::length() const
+{
+  return _length;
+}
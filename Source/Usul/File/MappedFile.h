@@ -0,0 +1,84 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Read-only file that is mapped into memory. The bytes are valid for as
+//  long as the object lives, so keep the smart pointer while using them.
+//  Pages are read by the system as they are touched, and they do not use
+//  up the heap.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_FILE_MAPPED_FILE_CLASS_H_
+#define _USUL_FILE_MAPPED_FILE_CLASS_H_
+
+#include "Usul/File/BaseFile.h"
+
+#include <cstddef>
+
+
+namespace Usul {
+namespace File {
+
+
+class USUL_EXPORT MappedFile : public Usul::File::BaseFile
+{
+public:
+
+  // Useful typedefs.
+  typedef Usul::File::BaseFile BaseClass;
+
+  // Smart-pointer definitions.
+  USUL_REFERENCED_CLASS ( MappedFile );
+
+  // Tell the system how the bytes will be used. These can be combined.
+  enum Hints
+  {
+    NORMAL     = 0,
+    SEQUENTIAL = 1, // Read ahead aggressively and drop pages behind.
+    WILL_NEED  = 2  // Start reading the whole file now.
+  };
+
+  // Constructor. Throws if the file cannot be mapped.
+  MappedFile ( const std::string &name, unsigned int hints = NORMAL );
+
+  // The bytes of the file. Both are null for an empty file.
+  const char *                begin() const;
+  const char *                end() const;
+
+  // Is the file empty?
+  bool                        empty() const;
+
+  // The number of bytes when the file was mapped.
+  std::size_t                 length() const;
+
+protected:
+
+  // Use reference counting.
+  virtual ~MappedFile();
+
+private:
+
+  // No copying or assignment.
+  MappedFile ( const MappedFile & );
+  MappedFile &operator = ( const MappedFile & );
+
+  void                        _unmap();
+
+  const char *_bytes;
+  std::size_t _length;
+};
+
+
+} // namespace File
+} // namespace Usul
+
+
+#endif // _USUL_FILE_MAPPED_FILE_CLASS_H_
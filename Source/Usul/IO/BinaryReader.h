@@ -22,6 +22,8 @@
 #include "Usul/Cast/Cast.h"
 #include "Usul/MPL/SameType.h"
 
+#include <cstddef>
+#include <cstdio>
 #include <stdexcept>
 #include <string>
 
@@ -78,17 +80,23 @@ template < class EndianPolicy_ > struct Reader
   {
     Usul::IO::Binary::Reader<EndianPolicy>::read ( stream, t[0], t[1], t[2], t[3] );
   }
+  template < class Stream, class T > static void array ( Stream &stream, T *t, std::size_t count )
+  {
+    // Read all the bytes and then convert them in place.
+    if ( ( 0x0 == t ) || ( 0 == count ) )
+      return;
+    stream.read ( reinterpret_cast < char * > ( t ), count * sizeof ( T ) );
+    if ( true == stream.fail() )
+      throw Usul::Exceptions::IO::UnexpectedEndOfFile ( "Error 3168420873: Unexpected end of file reached" );
+    EndianPolicy::convert ( t, count );
+  }
   template < class Stream, class T > static void vector ( Stream &stream, T &v )
   {
-    // Only works properly when not converting to a particular endian.
-    USUL_ASSERT_SAME_TYPE ( Usul::Endian::FromSystemToSystem, EndianPolicy );
-
-    typedef typename T::value_type ValueType;
-
-    // Vector must already be sized.
+    // Vector must already be sized. When converting, the elements have to
+    // be numbers. For vectors of points, pass the first number to array().
     if ( false == v.empty() )
     {
-      stream.read ( reinterpret_cast < char * > ( &v[0] ), v.size() * sizeof ( ValueType ) );
+      Usul::IO::Binary::Reader<EndianPolicy>::array ( stream, &v[0], v.size() );
     }
   }
 };
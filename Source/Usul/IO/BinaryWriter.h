@@ -18,9 +18,14 @@
 
 #include "Usul/Config/Config.h"
 #include "Usul/Endian/Endian.h"
+#include "Usul/Types/Types.h"
 #include "Usul/Cast/Cast.h"
 #include "Usul/MPL/SameType.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 
 namespace Usul {
 namespace IO {
@@ -73,16 +78,40 @@ template < class EndianPolicy_ > struct Writer
   {
     Usul::IO::Binary::Writer<EndianPolicy>::write ( stream, t[0], t[1], t[2], t[3] );
   }
-  template < class Stream, class T > static void vector ( Stream &stream, const T &v )
+  template < class Stream, class T > static void array ( Stream &stream, const T *t, std::size_t count )
   {
-    // Only works properly when not converting to a particular endian.
-    USUL_ASSERT_SAME_TYPE ( Usul::Endian::FromSystemToSystem, EndianPolicy );
+    if ( ( 0x0 == t ) || ( 0 == count ) )
+      return;
 
-    typedef typename T::value_type ValueType;
+    // No need to copy when the bytes are already in order.
+    if ( false == EndianPolicy::REVERSES )
+    {
+      stream.write ( reinterpret_cast < const char * > ( t ), count * sizeof ( T ) );
+      return;
+    }
 
+    // Convert a block at a time on the stack and write it.
+    Usul::Types::UInt64 buffer[2048];
+    T *block ( reinterpret_cast < T * > ( buffer ) );
+    const std::size_t bytes ( sizeof ( buffer ) );
+    const std::size_t blockSize ( bytes / sizeof ( T ) );
+    while ( count > 0 )
+    {
+      const std::size_t size ( std::min ( count, blockSize ) );
+      std::memcpy ( block, t, size * sizeof ( T ) );
+      EndianPolicy::convert ( block, size );
+      stream.write ( reinterpret_cast < const char * > ( block ), size * sizeof ( T ) );
+      t += size;
+      count -= size;
+    }
+  }
+  template < class Stream, class T > static void vector ( Stream &stream, const T &v )
+  {
+    // When converting, the elements have to be numbers. For vectors of 
+    // points, pass the first number to array().
     if ( false == v.empty() )
     {
-      stream.write ( reinterpret_cast < const char * > ( &v[0] ), sizeof ( ValueType ) * v.size() );
+      Usul::IO::Binary::Writer<EndianPolicy>::array ( stream, &v[0], v.size() );
     }
   }
 };
@@ -0,0 +1,108 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Input stream that reads bytes that are already in memory, like a mapped
+//  file, without copying them. The bytes have to outlive the stream.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_IO_MEMORY_STREAM_H_
+#define _USUL_IO_MEMORY_STREAM_H_
+
+#include "Usul/Config/Config.h"
+
+#include <istream>
+#include <streambuf>
+
+
+namespace Usul {
+namespace IO {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Stream buffer that points at the bytes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class MemoryBuffer : public std::streambuf
+{
+public:
+
+  MemoryBuffer ( const char *begin, const char *end ) : std::streambuf()
+  {
+    // The get area is never written to.
+    char *b ( const_cast < char * > ( begin ) );
+    char *e ( const_cast < char * > ( end ) );
+    this->setg ( b, b, e );
+  }
+
+protected:
+
+  virtual pos_type seekoff ( off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode which )
+  {
+    if ( 0 == ( which & std::ios_base::in ) )
+      return pos_type ( off_type ( -1 ) );
+
+    const char *base ( ( std::ios_base::beg == dir ) ? this->eback() :
+                       ( std::ios_base::cur == dir ) ? this->gptr() : this->egptr() );
+    const off_type position ( ( base - this->eback() ) + offset );
+    if ( ( position < 0 ) || ( position > ( this->egptr() - this->eback() ) ) )
+      return pos_type ( off_type ( -1 ) );
+
+    this->setg ( this->eback(), this->eback() + position, this->egptr() );
+    return pos_type ( position );
+  }
+
+  virtual pos_type seekpos ( pos_type position, std::ios_base::openmode which )
+  {
+    return this->seekoff ( off_type ( position ), std::ios_base::beg, which );
+  }
+
+private:
+
+  // No copying or assignment.
+  MemoryBuffer ( const MemoryBuffer & );
+  MemoryBuffer &operator = ( const MemoryBuffer & );
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Input stream class.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class MemoryStream : public std::istream
+{
+public:
+
+  MemoryStream ( const char *begin, const char *end ) : std::istream ( 0x0 ),
+    _buffer ( begin, end )
+  {
+    this->rdbuf ( &_buffer );
+  }
+
+private:
+
+  // No copying or assignment.
+  MemoryStream ( const MemoryStream & );
+  MemoryStream &operator = ( const MemoryStream & );
+
+  MemoryBuffer _buffer;
+};
+
+
+} // namespace IO
+} // namespace Usul
+
+
+#endif // _USUL_IO_MEMORY_STREAM_H_
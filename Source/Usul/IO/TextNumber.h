@@ -0,0 +1,432 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  For parsing and writing one number without a stream. It does not 
+//  depend on the locale or the job threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_IO_TEXT_NUMBER_H_
+#define _USUL_IO_TEXT_NUMBER_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Types/Types.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <clocale>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#if __cplusplus >= 201703L
+# include <charconv>
+#endif
+
+
+namespace Usul {
+namespace IO {
+namespace Text {
+namespace Detail {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The same characters as isspace() in the "C" locale.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline bool isSpace ( char c )
+{
+  return ( ( ' ' == c ) || ( ( c >= '\t' ) && ( c <= '\r' ) ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the first character that is not white space.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline const char *skipSpace ( const char *i, const char *end )
+{
+  while ( ( i < end ) && ( true == Detail::isSpace ( *i ) ) )
+  {
+    ++i;
+  }
+  return i;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parse an integer. Like a stream, a minus sign is allowed for unsigned
+//  types and the value wraps. Returns where it stopped, or the start if
+//  there is no number or it does not fit in the type.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > inline const char *parseInteger ( const char *begin, const char *end, T &value )
+{
+  typedef Usul::Types::UInt64 UInt64;
+  typedef std::numeric_limits < T > Limits;
+
+  const char *i ( begin );
+  const bool negative ( ( i < end ) && ( '-' == *i ) );
+  if ( ( i < end ) && ( ( '-' == *i ) || ( '+' == *i ) ) )
+  {
+    ++i;
+  }
+
+  // The largest the digits can be. Signed types go one lower than they 
+  // go higher.
+  const UInt64 limit ( static_cast < UInt64 > ( Limits::max() ) + 
+    ( ( ( true == negative ) && ( true == Limits::is_signed ) ) ? 1 : 0 ) );
+
+  const char *digits ( i );
+  UInt64 answer ( 0 );
+  bool overflow ( false );
+  while ( ( i < end ) && ( *i >= '0' ) && ( *i <= '9' ) )
+  {
+    const UInt64 digit ( static_cast < UInt64 > ( *i - '0' ) );
+    overflow = ( ( true == overflow ) || ( answer > ( ( limit - digit ) / 10 ) ) );
+    answer = answer * 10 + digit;
+    ++i;
+  }
+
+  if ( ( digits == i ) || ( true == overflow ) )
+    return begin;
+
+  value = static_cast < T > ( ( true == negative ) ? ( 0 - answer ) : answer );
+  return i;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Convert the C string with the C library, which rounds correctly.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cpp_lib_to_chars
+
+inline void cToReal ( const char *s, char **stop, float &value )
+{
+  #if defined ( _MSC_VER ) && ( _MSC_VER < 1800 )
+  // There is no strtof(). Rounding twice is only off when the text is
+  // almost exactly half way between two floats.
+  value = static_cast < float > ( ::strtod ( s, stop ) );
+  #else
+  value = ::strtof ( s, stop );
+  #endif
+}
+inline void cToReal ( const char *s, char **stop, double &value )
+{
+  value = ::strtod ( s, stop );
+}
+inline void cToReal ( const char *s, char **stop, long double &value )
+{
+  #if defined ( _MSC_VER ) && ( _MSC_VER < 1800 )
+  // Same as a double with this compiler.
+  value = ::strtod ( s, stop );
+  #else
+  value = ::strtold ( s, stop );
+  #endif
+}
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parse a floating-point number. Returns where it stopped, or the start if
+//  there is no number. Uses std::from_chars when the library has it.
+//  Otherwise the number is copied and given to the C library, with the
+//  decimal point of the current locale. Both round correctly. Numbers that 
+//  are too big or too small for the type are not numbers, but denormals are.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > inline const char *parseReal ( const char *begin, const char *end, T &value )
+{
+  // Unlike a stream, std::from_chars does not take a plus sign.
+  const char *i ( begin );
+  if ( ( i < end ) && ( '+' == *i ) && ( ( i + 1 ) < end ) && ( '-' != *( i + 1 ) ) )
+  {
+    ++i;
+  }
+
+  #ifdef __cpp_lib_to_chars
+
+  // Unlike a stream, std::from_chars takes "inf" and "nan".
+  const char *first ( ( ( i < end ) && ( '-' == *i ) ) ? ( i + 1 ) : i );
+  if ( ( first >= end ) || ( ( '.' != *first ) && ( ( *first < '0' ) || ( *first > '9' ) ) ) )
+    return begin;
+
+  T answer ( 0 );
+  const std::from_chars_result result ( std::from_chars ( i, end, answer ) );
+  if ( std::errc() != result.ec )
+    return begin;
+
+  value = answer;
+  return result.ptr;
+
+  #else
+
+  // Find the end of the number the same way std::from_chars does, so that
+  // the C library never sees "inf", "nan", hex, or text past the end.
+  const char *first ( i );
+  if ( ( i < end ) && ( '-' == *i ) )
+  {
+    ++i;
+  }
+  const char *digits ( i );
+  while ( ( i < end ) && ( *i >= '0' ) && ( *i <= '9' ) )
+  {
+    ++i;
+  }
+  std::size_t numDigits ( i - digits );
+  if ( ( i < end ) && ( '.' == *i ) )
+  {
+    const char *fraction ( ++i );
+    while ( ( i < end ) && ( *i >= '0' ) && ( *i <= '9' ) )
+    {
+      ++i;
+    }
+    numDigits += ( i - fraction );
+  }
+  if ( 0 == numDigits )
+    return begin;
+
+  // The exponent is only used if it has digits.
+  if ( ( i < end ) && ( ( 'e' == *i ) || ( 'E' == *i ) ) )
+  {
+    const char *e ( i + 1 );
+    if ( ( e < end ) && ( ( '-' == *e ) || ( '+' == *e ) ) )
+    {
+      ++e;
+    }
+    const char *exponent ( e );
+    while ( ( e < end ) && ( *e >= '0' ) && ( *e <= '9' ) )
+    {
+      ++e;
+    }
+    if ( exponent != e )
+    {
+      i = e;
+    }
+  }
+
+  // Copy it so that it ends in a null, on the stack unless it is long.
+  const std::size_t length ( i - first );
+  char buffer[128];
+  std::string text;
+  char *copy ( buffer );
+  if ( length >= sizeof ( buffer ) )
+  {
+    text.assign ( first, i );
+    copy = &text[0];
+  }
+  else
+  {
+    std::copy ( first, i, buffer );
+    buffer[length] = '\0';
+  }
+
+  // The C library uses the locale's decimal point.
+  const ::lconv *conventions ( ::localeconv() );
+  const char point ( ( ( 0x0 != conventions ) && ( 0x0 != conventions->decimal_point ) && 
+    ( '\0' != conventions->decimal_point[0] ) ) ? conventions->decimal_point[0] : '.' );
+  std::replace ( copy, copy + length, '.', point );
+
+  T answer ( 0 );
+  char *stop ( 0x0 );
+  errno = 0;
+  Detail::cToReal ( copy, &stop, answer );
+  if ( ( copy + length ) != stop )
+    return begin;
+
+  // Like std::from_chars, a number that does not fit is not one. Denormals
+  // also set the range error, but they are not zero or infinite.
+  if ( ( ERANGE == errno ) && ( ( 0 == answer ) || 
+       ( answer > std::numeric_limits < T >::max() ) || 
+       ( answer < -std::numeric_limits < T >::max() ) ) )
+  {
+    return begin;
+  }
+
+  value = answer;
+  return i;
+
+  #endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Generic number type is intentionally not defined.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > struct NumberType
+{
+  static const char *parse ( const char *, const char *, T & );
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Append the integer's digits.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void appendInteger ( std::string &to, Usul::Types::ULongLong u, bool negative )
+{
+  char buffer[32];
+  char *end ( buffer + sizeof ( buffer ) );
+  char *begin ( end );
+  do
+  {
+    *--begin = static_cast < char > ( '0' + ( u % 10 ) );
+    u /= 10;
+  }
+  while ( u > 0 );
+  if ( true == negative )
+  {
+    *--begin = '-';
+  }
+  to.append ( begin, end );
+}
+inline void appendInteger ( std::string &to, Usul::Types::LongLong i )
+{
+  // Negate as unsigned so that the smallest value works.
+  const bool negative ( i < 0 );
+  const Usul::Types::ULongLong u ( static_cast < Usul::Types::ULongLong > ( i ) );
+  Detail::appendInteger ( to, ( ( true == negative ) ? ( 0 - u ) : u ), negative );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Append the shortest text that reads back as the same number. Always
+//  uses a '.' no matter what the locale is.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > inline void appendReal ( std::string &to, T t )
+{
+  char buffer[64];
+
+  #ifdef __cpp_lib_to_chars
+
+  const std::to_chars_result result ( std::to_chars ( buffer, buffer + sizeof ( buffer ), t ) );
+  char *end ( result.ptr );
+
+  #else
+
+  // Try the digits the type always keeps. If that does not read back the
+  // same then use three more, which is always enough for the type to 
+  // round-trip, because the C library prints and parses correctly rounded.
+  char *end ( buffer );
+  const int fewest ( std::numeric_limits < T >::digits10 );
+  for ( int digits = fewest; end == buffer; digits += 3 )
+  {
+    #if defined ( _MSC_VER ) && ( _MSC_VER < 1900 )
+    const int size ( ::_snprintf ( buffer, sizeof ( buffer ), "%.*Lg", digits, static_cast < long double > ( t ) ) );
+    #else
+    const int size ( ::snprintf ( buffer, sizeof ( buffer ), "%.*Lg", digits, static_cast < long double > ( t ) ) );
+    #endif
+    end = buffer + ( ( size > 0 ) ? std::min < int > ( size, sizeof ( buffer ) - 1 ) : 0 );
+
+    // The locale's decimal point may not be a '.'.
+    const ::lconv *conventions ( ::localeconv() );
+    const char point ( ( ( 0x0 != conventions ) && ( 0x0 != conventions->decimal_point ) ) ? conventions->decimal_point[0] : '.' );
+    if ( ( '.' != point ) && ( '\0' != point ) )
+    {
+      std::replace ( buffer, end, point, '.' );
+    }
+
+    // Not-a-number never compares equal, so just keep it.
+    T answer ( 0 );
+    const bool same ( ( end == Detail::parseReal ( buffer, end, answer ) ) && ( answer == t ) );
+    if ( ( false == same ) && ( t == t ) && ( fewest == digits ) )
+    {
+      end = buffer;
+    }
+  }
+
+  #endif
+
+  to.append ( buffer, end );
+}
+
+
+} // namespace Detail
+} // namespace Text
+} // namespace IO
+} // namespace Usul
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Macros to make the number parsers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#define USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER(the_type) \
+namespace Usul { namespace IO { namespace Text { namespace Detail \
+{ \
+  template <> struct NumberType < the_type > \
+  { \
+    static const char *parse ( const char *begin, const char *end, the_type &v ) \
+    { \
+      return Detail::parseInteger ( begin, end, v ); \
+    } \
+  }; \
+} } } }
+
+#define USUL_IO_TEXT_DEFINE_PARSER_TYPE_REAL(the_type) \
+namespace Usul { namespace IO { namespace Text { namespace Detail \
+{ \
+  template <> struct NumberType < the_type > \
+  { \
+    static const char *parse ( const char *begin, const char *end, the_type &v ) \
+    { \
+      return Detail::parseReal ( begin, end, v ); \
+    } \
+  }; \
+} } } }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Declare known numbers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER ( short );
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER ( int );
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER ( long );
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER ( long long );
+
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER ( unsigned short );
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER ( unsigned int );
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER ( unsigned long );
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_INTEGER ( unsigned long long );
+
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_REAL ( float );
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_REAL ( double );
+USUL_IO_TEXT_DEFINE_PARSER_TYPE_REAL ( long double );
+
+
+#endif // _USUL_IO_TEXT_NUMBER_H_
@@ -0,0 +1,310 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  For parsing long lists of numbers from text without a stream. The
+//  numbers are counted first so that the container is sized once. Very
+//  long lists are split up and parsed by the job threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_IO_TEXT_PARSER_H_
+#define _USUL_IO_TEXT_PARSER_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/IO/TextNumber.h"
+#include "Usul/Jobs/Parallel.h"
+#include "Usul/Math/Vector2.h"
+#include "Usul/Math/Vector3.h"
+#include "Usul/Math/Vector4.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace Usul {
+namespace IO {
+namespace Text {
+namespace Detail {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of words in the text.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline std::size_t countWords ( const char *i, const char *end )
+{
+  std::size_t count ( 0 );
+  bool inWord ( false );
+  for ( ; i < end; ++i )
+  {
+    const bool space ( Detail::isSpace ( *i ) );
+    count += ( ( false == space ) && ( false == inWord ) ) ? 1 : 0;
+    inWord = !space;
+  }
+  return count;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  What the sequence holds. Scalars are one number each and vectors are
+//  as many numbers as they have components.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > struct ElementType
+{
+  typedef T ScalarType;
+  enum { SIZE = 1 };
+  static ScalarType &get ( T &t, unsigned int )
+  {
+    return t;
+  }
+};
+template < class T, class I, class E > struct ElementType < Usul::Math::Vector2 < T, I, E > >
+{
+  typedef T ScalarType;
+  enum { SIZE = 2 };
+  static ScalarType &get ( Usul::Math::Vector2 < T, I, E > &v, unsigned int i )
+  {
+    return v[i];
+  }
+};
+template < class T, class I, class E > struct ElementType < Usul::Math::Vector3 < T, I, E > >
+{
+  typedef T ScalarType;
+  enum { SIZE = 3 };
+  static ScalarType &get ( Usul::Math::Vector3 < T, I, E > &v, unsigned int i )
+  {
+    return v[i];
+  }
+};
+template < class T, class I, class E > struct ElementType < Usul::Math::Vector4 < T, I, E > >
+{
+  typedef T ScalarType;
+  enum { SIZE = 4 };
+  static ScalarType &get ( Usul::Math::Vector4 < T, I, E > &v, unsigned int i )
+  {
+    return v[i];
+  }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parses one piece of the text into the container, starting with the
+//  given number. Records the number of the first word that is not a
+//  number, if any.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class ContainerType > struct ParsePieces
+{
+  typedef typename ContainerType::value_type ValueType;
+  typedef Detail::ElementType < ValueType > Element;
+  typedef typename Element::ScalarType ScalarType;
+  typedef std::vector < const char * > Bounds;
+  typedef std::vector < std::size_t > Sizes;
+
+  ParsePieces ( const Bounds &bounds, const Sizes &starts, Sizes &bad, ContainerType &c ) :
+    _bounds ( bounds ), _starts ( starts ), _bad ( bad ), _c ( c ){}
+
+  void operator () ( std::size_t begin, std::size_t end )
+  {
+    for ( std::size_t piece = begin; piece < end; ++piece )
+    {
+      this->_parse ( piece );
+    }
+  }
+
+private:
+
+  void _parse ( std::size_t piece )
+  {
+    // Stop at the end of the last whole element.
+    const std::size_t numWords ( _c.size() * Element::SIZE );
+    const char *stop ( _bounds[piece + 1] );
+
+    std::size_t word ( _starts[piece] );
+    const char *i ( Detail::skipSpace ( _bounds[piece], stop ) );
+    while ( ( i < stop ) && ( word < numWords ) )
+    {
+      ScalarType &s ( Element::get ( _c[word / Element::SIZE], static_cast < unsigned int > ( word % Element::SIZE ) ) );
+      const char *next ( Detail::NumberType < ScalarType >::parse ( i, stop, s ) );
+
+      // The whole word has to be the number.
+      if ( ( i == next ) || ( ( next < stop ) && ( false == Detail::isSpace ( *next ) ) ) )
+      {
+        _bad[piece] = word;
+        return;
+      }
+
+      i = Detail::skipSpace ( next, stop );
+      ++word;
+    }
+  }
+
+  const Bounds &_bounds;
+  const Sizes &_starts;
+  Sizes &_bad;
+  ContainerType &_c;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Counts the words in the pieces.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct CountPieces
+{
+  typedef std::vector < const char * > Bounds;
+  typedef std::vector < std::size_t > Sizes;
+
+  CountPieces ( const Bounds &bounds, Sizes &counts ) : _bounds ( bounds ), _counts ( counts ){}
+
+  void operator () ( std::size_t begin, std::size_t end )
+  {
+    for ( std::size_t piece = begin; piece < end; ++piece )
+    {
+      _counts[piece] = Detail::countWords ( _bounds[piece], _bounds[piece + 1] );
+    }
+  }
+
+private:
+
+  const Bounds &_bounds;
+  Sizes &_counts;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Text shorter than this is parsed by the calling thread.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const std::size_t PARALLEL_MIN_LENGTH ( 1024 * 1024 );
+const std::size_t PARALLEL_MIN_PIECE  ( 256 * 1024 );
+
+
+} // namespace Detail
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Text parser class.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct Parser
+{
+  // Parse one number. Returns where it stopped, or the start if there is
+  // no number. Leading white space is not skipped.
+  template < class T > static const char *number ( const char *begin, const char *end, T &t )
+  {
+    return Detail::NumberType < T > ::parse ( begin, end, t );
+  }
+
+  // Replace the contents of the container with the numbers in the text.
+  // Like the stream reader, this stops at the first word that is not a
+  // number. Numbers left over after the last whole element are dropped.
+  template < class ContainerType > static void sequence ( const char *begin, const char *end, ContainerType &c )
+  {
+    typedef typename ContainerType::value_type ValueType;
+    typedef Detail::ElementType < ValueType > Element;
+    typedef std::vector < const char * > Bounds;
+    typedef std::vector < std::size_t > Sizes;
+
+    c.clear();
+    if ( ( 0x0 == begin ) || ( end <= begin ) )
+      return;
+
+    // Split long text into pieces that end in white space, so that no
+    // number is cut in two.
+    const std::size_t length ( end - begin );
+    const std::size_t numWorkers ( ( length < Detail::PARALLEL_MIN_LENGTH ) ? 1 :
+      Usul::Jobs::Detail::parallelWorkers ( Usul::Jobs::Queue::RefPtr() ) );
+    const std::size_t numPieces ( std::max < std::size_t > ( 1,
+      std::min ( numWorkers * 4, length / Detail::PARALLEL_MIN_PIECE ) ) );
+
+    Bounds bounds ( 1, begin );
+    for ( std::size_t piece = 1; piece < numPieces; ++piece )
+    {
+      const char *i ( std::max ( bounds.back(), begin + ( length * piece ) / numPieces ) );
+      while ( ( i < end ) && ( false == Detail::isSpace ( *i ) ) )
+      {
+        ++i;
+      }
+      bounds.push_back ( i );
+    }
+    bounds.push_back ( end );
+
+    // Count the words so the container is sized once.
+    Sizes counts ( numPieces, 0 );
+    Detail::CountPieces count ( bounds, counts );
+    if ( numPieces > 1 )
+    {
+      Usul::Jobs::parallelFor ( 0, numPieces, count, 1 );
+    }
+    else
+    {
+      count ( 0, 1 );
+    }
+
+    // Where each piece starts.
+    Sizes starts ( numPieces, 0 );
+    for ( std::size_t piece = 1; piece < numPieces; ++piece )
+    {
+      starts[piece] = starts[piece - 1] + counts[piece - 1];
+    }
+    const std::size_t numWords ( starts.back() + counts.back() );
+
+    c.resize ( numWords / Element::SIZE );
+
+    // Parse the pieces.
+    Sizes bad ( numPieces, numWords );
+    Detail::ParsePieces < ContainerType > parse ( bounds, starts, bad, c );
+    if ( numPieces > 1 )
+    {
+      Usul::Jobs::parallelFor ( 0, numPieces, parse, 1 );
+    }
+    else
+    {
+      parse ( 0, 1 );
+    }
+
+    // Keep what came before the first bad word.
+    const std::size_t firstBad ( *std::min_element ( bad.begin(), bad.end() ) );
+    if ( firstBad < numWords )
+    {
+      c.resize ( firstBad / Element::SIZE );
+    }
+  }
+
+  template < class ContainerType > static void sequence ( const std::string &s, ContainerType &c )
+  {
+    Parser::sequence ( s.c_str(), s.c_str() + s.size(), c );
+  }
+};
+
+
+} // namespace Text
+} // namespace IO
+} // namespace Usul
+
+
+#endif // _USUL_IO_TEXT_PARSER_H_
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A group of jobs that can be waited on or cancelled together.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Config/Config.h"
+#include "Usul/Jobs/Group.h"
+#include "Usul/Functions/NoThrow.h"
+#include "Usul/System/Clock.h"
+
+using namespace Usul::Jobs;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Group::Group() : BaseClass(),
+  _jobs()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Group::~Group()
+{
+  USUL_TRY_BLOCK
+  {
+    _jobs.clear();
+  }
+  USUL_DEFINE_CATCH_BLOCKS ( "3165830407" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Group::add ( BaseJob::RefPtr job )
+{
+  if ( true == job.valid() )
+  {
+    _jobs.push_back ( job );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel all the jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Group::cancel()
+{
+  JobList jobs ( _jobs );
+  for ( JobList::iterator i = jobs.begin(); i != jobs.end(); ++i )
+  {
+    BaseJob::RefPtr job ( *i );
+    job->cancel();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove all the jobs from the group.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Group::clear()
+{
+  _jobs.clear();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Have all the jobs finished?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Group::isFinished() const
+{
+  const JobList jobs ( _jobs );
+  for ( JobList::const_iterator i = jobs.begin(); i != jobs.end(); ++i )
+  {
+    if ( false == (*i)->isFinished() )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int Group::size() const
+{
+  return _jobs.size();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Block until all the jobs finish.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Group::wait ( Usul::Types::UInt64 timeout )
+{
+  const Usul::Types::UInt64 start ( Usul::System::Clock::milliseconds() );
+
+  JobList jobs ( _jobs );
+  for ( JobList::iterator i = jobs.begin(); i != jobs.end(); ++i )
+  {
+    // Wait for what is left of the timeout.
+    Usul::Types::UInt64 remaining ( 0 );
+    if ( timeout > 0 )
+    {
+      const Usul::Types::UInt64 elapsed ( Usul::System::Clock::milliseconds() - start );
+      if ( elapsed >= timeout )
+      {
+        return this->isFinished();
+      }
+      remaining = timeout - elapsed;
+    }
+
+    BaseJob::RefPtr job ( *i );
+    if ( false == job->wait ( remaining ) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  A group of jobs that can be waited on or cancelled together.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_JOBS_GROUP_H_
+#define _USUL_JOBS_GROUP_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/Atomic/Container.h"
+#include "Usul/Base/Referenced.h"
+#include "Usul/Jobs/Job.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/noncopyable.hpp"
+
+#include <vector>
+
+
+namespace Usul {
+namespace Jobs {
+
+
+class USUL_EXPORT Group :
+  public Usul::Base::Referenced,
+  public boost::noncopyable
+{
+public:
+
+  typedef Usul::Base::Referenced BaseClass;
+  typedef BaseJob::JobList JobList;
+  typedef Usul::Atomic::Container < JobList > Jobs;
+
+  USUL_REFERENCED_CLASS ( Group );
+
+  Group();
+
+  // Add the job to the group. This does not add it to a queue.
+  void                  add ( BaseJob::RefPtr );
+
+  // Cancel all the jobs.
+  void                  cancel();
+
+  // Remove all the jobs from the group.
+  void                  clear();
+
+  // Have all the jobs finished?
+  bool                  isFinished() const;
+
+  // Return the number of jobs.
+  unsigned int          size() const;
+
+  // Block until all the jobs finish. Pass zero to wait forever.
+  // Returns false if it timed out.
+  bool                  wait ( Usul::Types::UInt64 timeout = 0 );
+
+protected:
+
+  virtual ~Group();
+
+private:
+
+  Jobs _jobs;
+};
+
+
+} // namespace Jobs
+} // namespace Usul
+
+
+#endif // _USUL_JOBS_GROUP_H_
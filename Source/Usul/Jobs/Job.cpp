@@ -16,6 +16,13 @@
 #include "Usul/Config/Config.h"
 #include "Usul/Jobs/Job.h"
 #include "Usul/Atomic/Integer.h"
+#include "Usul/Errors/Assert.h"
+
+#include "boost/thread/thread_time.hpp"
+#include "boost/thread/tss.hpp"
+
+#include <algorithm>
+#include <new>
 
 using namespace Usul::Jobs;
 
@@ -31,12 +38,150 @@ namespace Helper
 {
   typedef Usul::Atomic::Integer < Usul::Jobs::BaseJob::ID > ID;
   ID _nextId ( 1 );
-  inline ID getNextId()
+  inline Usul::Jobs::BaseJob::ID getNextId()
+  {
+    // Has to be one atomic operation. Jobs with the same id are 
+    // considered equal and one of them would be lost from the queue.
+    return _nextId++;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Free memory for jobs. Blocks are grouped by size, rounded up. Each thread 
+//  keeps its own lists so there is no locking. A job freed in another 
+//  thread than the one that made it goes to the freeing thread's list.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // Sizes are rounded up to a multiple of this. Larger jobs are not pooled.
+  const std::size_t POOL_GRANULE ( 64 );
+  const std::size_t POOL_NUM_SIZES ( 8 );
+
+  // How many free blocks of each size a thread keeps.
+  const unsigned int POOL_MAX_FREE ( 256 );
+
+  struct Block
+  {
+    Block *next;
+  };
+
+  struct Pool
+  {
+    Pool()
+    {
+      std::fill ( heads, heads + POOL_NUM_SIZES, static_cast < Block * > ( 0x0 ) );
+      std::fill ( counts, counts + POOL_NUM_SIZES, 0 );
+    }
+
+    ~Pool()
+    {
+      for ( std::size_t i = 0; i < POOL_NUM_SIZES; ++i )
+      {
+        while ( 0x0 != heads[i] )
+        {
+          Block *block ( heads[i] );
+          heads[i] = block->next;
+          ::operator delete ( block );
+        }
+      }
+    }
+
+    Block *heads[POOL_NUM_SIZES];
+    unsigned int counts[POOL_NUM_SIZES];
+  };
+
+  // Never deleted because jobs may be freed during static destruction.
+  boost::thread_specific_ptr < Pool > *_pools ( 0x0 );
+
+  inline Pool &pool()
+  {
+    if ( 0x0 == _pools )
+    {
+      _pools = new boost::thread_specific_ptr < Pool >;
+    }
+    Pool *p ( _pools->get() );
+    if ( 0x0 == p )
+    {
+      p = new Pool;
+      _pools->reset ( p );
+    }
+    return *p;
+  }
+
+  // Return the list for the size, or POOL_NUM_SIZES if it is not pooled.
+  inline std::size_t poolIndex ( std::size_t size )
+  {
+    const std::size_t index ( ( size + POOL_GRANULE - 1 ) / POOL_GRANULE );
+    return ( ( index > 0 && index <= POOL_NUM_SIZES ) ? ( index - 1 ) : POOL_NUM_SIZES );
+  }
+
+  // Make the pool before there are threads.
+  struct InitPool
+  {
+    InitPool()
+    {
+      Helper::pool();
+    }
+  } _initPool;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Allocate memory for a job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void *BaseJob::operator new ( std::size_t size )
+{
+  const std::size_t index ( Helper::poolIndex ( size ) );
+  if ( index >= Helper::POOL_NUM_SIZES )
+    return ::operator new ( size );
+
+  Helper::Pool &pool ( Helper::pool() );
+  Helper::Block *block ( pool.heads[index] );
+  if ( 0x0 == block )
+    return ::operator new ( ( index + 1 ) * Helper::POOL_GRANULE );
+
+  pool.heads[index] = block->next;
+  --pool.counts[index];
+  return block;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Free memory for a job. The size is that of the most derived class.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void BaseJob::operator delete ( void *memory, std::size_t size )
+{
+  if ( 0x0 == memory )
+    return;
+
+  const std::size_t index ( Helper::poolIndex ( size ) );
+  if ( index >= Helper::POOL_NUM_SIZES )
   {
-    ID id ( _nextId );
-    ++_nextId;
-    return id;
+    ::operator delete ( memory );
+    return;
   }
+
+  Helper::Pool &pool ( Helper::pool() );
+  if ( pool.counts[index] >= Helper::POOL_MAX_FREE )
+  {
+    ::operator delete ( memory );
+    return;
+  }
+
+  Helper::Block *block ( static_cast < Helper::Block * > ( memory ) );
+  block->next = pool.heads[index];
+  pool.heads[index] = block;
+  ++pool.counts[index];
 }
 
 
@@ -47,8 +192,20 @@ namespace Helper
 ///////////////////////////////////////////////////////////////////////////////
 
 BaseJob::BaseJob ( Priority p ) : BaseClass(),
-  _handle ( p, Helper::getNextId() ),
-  _cancelled ( false )
+  _id ( Helper::getNextId() ),
+  _priority ( p ),
+  _deadline ( 0 ),
+  _cancelled ( false ),
+  _queueIndex ( 0 ),
+  _queued ( 0 ),
+  _restarts ( 0 ),
+  _mutex(),
+  _finishedCondition(),
+  _finished ( false ),
+  _deferred ( false ),
+  _numPredecessors ( 0 ),
+  _successors(),
+  _queueLink()
 {
 }
 
@@ -72,7 +229,7 @@ BaseJob::~BaseJob()
 
 BaseJob::ID BaseJob::id() const
 {
-  return _handle.id();
+  return _id;
 }
 
 
@@ -84,7 +241,31 @@ BaseJob::ID BaseJob::id() const
 
 BaseJob::Priority BaseJob::priority() const
 {
-  return _handle.priority();
+  return _priority;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the job's deadline.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Usul::Types::UInt64 BaseJob::deadlineGet() const
+{
+  return _deadline;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the job's deadline.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void BaseJob::deadlineSet ( Usul::Types::UInt64 deadline )
+{
+  _deadline = deadline;
 }
 
 
@@ -96,7 +277,7 @@ BaseJob::Priority BaseJob::priority() const
 
 BaseJob::Handle BaseJob::handle() const
 {
-  return _handle;
+  return Handle ( this->priority(), this->id() );
 }
 
 
@@ -133,3 +314,177 @@ bool BaseJob::isCancelled() const
 {
   return _cancelled;
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Has a queue finished running this job?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool BaseJob::isFinished() const
+{
+  Guard guard ( _mutex );
+  return _finished;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is this job waiting for one or more predecessors?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool BaseJob::isWaiting() const
+{
+  Guard guard ( _mutex );
+  return ( _numPredecessors > 0 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  This job will not start until the given job has finished.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void BaseJob::after ( BaseJob::RefPtr predecessor )
+{
+  // Handle bad input.
+  if ( ( false == predecessor.valid() ) || ( this == predecessor.get() ) )
+    return;
+
+  // Lock the predecessor first so that it cannot finish in between.
+  Guard guard1 ( predecessor->_mutex );
+  if ( true == predecessor->_finished )
+    return;
+
+  Guard guard2 ( _mutex );
+  predecessor->_successors.push_back ( BaseJob::RefPtr ( this ) );
+  ++_numPredecessors;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The given job will start after this one finishes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+BaseJob::RefPtr BaseJob::then ( BaseJob::RefPtr successor )
+{
+  if ( true == successor.valid() )
+  {
+    successor->after ( BaseJob::RefPtr ( this ) );
+  }
+  return successor;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Block until a queue finishes running this job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool BaseJob::wait ( Usul::Types::UInt64 timeout )
+{
+  Guard guard ( _mutex );
+
+  if ( 0 == timeout )
+  {
+    while ( false == _finished )
+    {
+      _finishedCondition.wait ( _mutex );
+    }
+    return true;
+  }
+
+  const boost::system_time end ( boost::get_system_time() + 
+    boost::posix_time::milliseconds ( timeout ) );
+  while ( false == _finished )
+  {
+    if ( false == _finishedCondition.timed_wait ( _mutex, end ) )
+    {
+      return _finished;
+    }
+  }
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Called by the queue when it adds this job. Returns false if the job has
+//  to wait for its predecessors. It will be added to the same queue when 
+//  they finish.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool BaseJob::_isReadyToQueue ( const QueueLinkPtr &link )
+{
+  Guard guard ( _mutex );
+  if ( _numPredecessors > 0 )
+  {
+    _deferred = true;
+    _queueLink = link;
+    return false;
+  }
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Called when one of the predecessors finished. Returns true if this job
+//  was deferred by a queue and can now be added.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool BaseJob::_predecessorFinished ( bool cancelled )
+{
+  // Cancelling a job cancels the jobs that depend on it.
+  if ( true == cancelled )
+  {
+    this->cancel();
+  }
+
+  Guard guard ( _mutex );
+  USUL_ASSERT ( _numPredecessors > 0 );
+  --_numPredecessors;
+
+  if ( ( 0 == _numPredecessors ) && ( true == _deferred ) )
+  {
+    _deferred = false;
+    return true;
+  }
+  return false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Called by the queue when this job is done. Wakes up the waiting threads 
+//  and appends the successors that are now ready.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void BaseJob::_finish ( JobList &ready )
+{
+  JobList successors;
+  {
+    Guard guard ( _mutex );
+    _finished = true;
+    successors.swap ( _successors );
+    _finishedCondition.notify_all();
+  }
+
+  const bool cancelled ( this->isCancelled() );
+  for ( JobList::iterator i = successors.begin(); i != successors.end(); ++i )
+  {
+    if ( true == (*i)->_predecessorFinished ( cancelled ) )
+    {
+      ready.push_back ( USUL_MOVE ( *i ) );
+    }
+  }
+}
@@ -18,15 +18,22 @@
 
 #include "Usul/Config/Config.h"
 #include "Usul/Atomic/Bool.h"
+#include "Usul/Atomic/Integer.h"
 #include "Usul/Base/Referenced.h"
 #include "Usul/Export/Export.h"
 #include "Usul/Functions/NoThrow.h"
 #include "Usul/Jobs/Handle.h"
 #include "Usul/Scope/Caller.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/Mutex.h"
+#include "Usul/Types/Types.h"
 
 #include "boost/bind.hpp"
 #include "boost/noncopyable.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/condition_variable.hpp"
 
+#include <cstddef>
 #include <vector>
 
 
@@ -34,6 +41,9 @@ namespace Usul {
 namespace Jobs {
 
 
+class Queue;
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Base job class.
@@ -50,11 +60,28 @@ public:
   typedef Usul::Jobs::Handle Handle;
   typedef Handle::ID ID;
   typedef Handle::Priority Priority;
+  typedef Usul::Threads::Mutex Mutex;
+  typedef Usul::Threads::Guard < Mutex > Guard;
   USUL_REFERENCED_CLASS ( BaseJob );
+  typedef std::vector < BaseJob::RefPtr > JobList;
+
+  // This job will not start until the given job has finished. Declare the
+  // predecessors before adding this job to a queue. Adding a job that is 
+  // still waiting defers it; it goes into that same queue when the last 
+  // predecessor finishes, or is cancelled if the queue is gone by then. 
+  // Has no effect if the given job already finished.
+  void              after ( BaseJob::RefPtr predecessor );
 
   // Set the flag for "cancelled" to true.
   void              cancel();
 
+  // Get/set the time by which this job should start, in microseconds from 
+  // Usul::System::Clock::microseconds(). Zero, the default, means there is 
+  // none. Set it before adding the job. Only queues that use deadlines look 
+  // at it.
+  Usul::Types::UInt64 deadlineGet() const;
+  void              deadlineSet ( Usul::Types::UInt64 );
+
   // Execute this job.
   virtual void      execute();
 
@@ -67,10 +94,30 @@ public:
   // Have we been cancelled?
   bool              isCancelled() const;
 
-  // Return this job's priority.
+  // Has a queue finished running this job?
+  bool              isFinished() const;
+
+  // Is this job waiting for one or more predecessors?
+  bool              isWaiting() const;
+
+  // Jobs are made and freed often, so they come from a pool. Each thread 
+  // keeps the memory of the jobs it frees and reuses it for new ones.
+  static void *     operator new ( std::size_t );
+  static void       operator delete ( void *, std::size_t );
+
+  // Return this job's priority. Use Queue::prioritize() to change it.
   Priority          priority() const;
 
-  // Predicate class so that we can use RefPtr in std::set.
+  // The given job will start after this one finishes. Returns the given 
+  // job so that calls can be chained.
+  BaseJob::RefPtr   then ( BaseJob::RefPtr successor );
+
+  // Block until a queue finishes running this job. Pass zero to wait 
+  // forever. Returns false if it timed out.
+  bool              wait ( Usul::Types::UInt64 timeout = 0 );
+
+  // Predicate class so that we can use RefPtr in std::set. Compares the 
+  // ids because the priority can change while the job is in a set.
   struct Less
   {
     bool operator () ( const RefPtr &left, const RefPtr &right ) const
@@ -81,19 +128,54 @@ public:
       if ( false == right.valid() )
         return false;
 
-      return ( left->handle() < right->handle() );
+      return ( left->id() < right->id() );
     }
   };
 
 protected:
 
+  friend class Queue;
+  friend class PriorityQueue;
+
+  // Lets a deferred job get back to the queue it was added to without 
+  // keeping that queue alive. The queue clears the pointer when it dies.
+  struct QueueLink : public boost::noncopyable
+  {
+    QueueLink ( Queue *q ) : mutex(), queue ( q ){}
+    Mutex mutex;
+    Queue *queue;
+  };
+  typedef boost::shared_ptr < QueueLink > QueueLinkPtr;
+
   BaseJob ( Priority p = 0 );
   virtual ~BaseJob();
 
+  // Called by the queue. Returns the successors that are now ready.
+  void              _finish ( JobList &ready );
+
+  // Called by the queue. Returns false if the job has to wait, and 
+  // remembers the queue so that the job can be added to it later.
+  bool              _isReadyToQueue ( const QueueLinkPtr & );
+
+  // Returns true if this job was deferred and is now ready.
+  bool              _predecessorFinished ( bool cancelled );
+
 private:
 
-  const Handle _handle;
+  const ID _id;
+  Usul::Atomic::Integer < Priority > _priority;
+  Usul::Atomic::Integer < Usul::Types::UInt64 > _deadline;
   Usul::Atomic::Bool _cancelled;
+  unsigned int _queueIndex;
+  Usul::Atomic::Integer < unsigned int > _queued;
+  unsigned int _restarts;
+  mutable Mutex _mutex;
+  boost::condition_variable_any _finishedCondition;
+  bool _finished;
+  bool _deferred;
+  unsigned int _numPredecessors;
+  JobList _successors;
+  QueueLinkPtr _queueLink;
 };
 
 
@@ -114,12 +196,9 @@ public:
 
   virtual void execute()
   {
-    this->ref();
-    Usul::Scope::Caller::RefPtr unref ( Usul::Scope::makeCaller 
-      ( boost::bind ( &SimpleJob::unref, this, false ) ) );
-    {
-      _function ( BaseClass::RefPtr ( this ) );
-    }
+    // Keep a reference while running without deleting when it goes away.
+    BaseClass::NoDeleteRefPtr hold ( this );
+    _function ( BaseClass::RefPtr ( this ) );
   }
 
 protected:
@@ -18,6 +18,7 @@
 
 #include "Usul/Config/Config.h"
 #include "Usul/Export/Export.h"
+#include "Usul/Jobs/Metrics.h"
 #include "Usul/Jobs/Queue.h"
 #include "Usul/Atomic/Container.h"
 
@@ -36,11 +37,18 @@ public:
 
   typedef Usul::Jobs::Queue::RefPtr QueuePtr;
   typedef Usul::Atomic::Container < std::map < std::string, QueuePtr > > Queues;
+  typedef std::map < std::string, Metrics::Snapshot > Snapshots;
 
   // Singleton interface.
   static Manager &      instance();
   static void           destroy();
 
+  // Get a copy of the metrics for each named queue.
+  Snapshots             metrics() const;
+
+  // Start the metrics over for all the queues.
+  void                  metricsReset();
+
   // Return the queue, which may be null.
   QueuePtr &            operator [] ( const std::string & );
 
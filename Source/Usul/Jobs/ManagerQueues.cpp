@@ -146,3 +146,56 @@ void Manager::remove ( const std::string &name )
   Queues::ValueType &queues ( _queues.getReference() );
   queues.erase ( name );
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get a copy of the metrics for each named queue.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Manager::Snapshots Manager::metrics() const
+{
+  // Copy the queues so that we do not hold the lock while asking them.
+  Queues::ValueType queues;
+  {
+    Queues::Guard guard ( _queues.mutex() );
+    queues = _queues.getReference();
+  }
+
+  Snapshots snapshots;
+  for ( Queues::ValueType::const_iterator i = queues.begin(); i != queues.end(); ++i )
+  {
+    QueuePtr queue ( i->second );
+    if ( true == queue.valid() )
+    {
+      snapshots[i->first] = queue->metrics();
+    }
+  }
+  return snapshots;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Start the metrics over for all the queues.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Manager::metricsReset()
+{
+  Queues::ValueType queues;
+  {
+    Queues::Guard guard ( _queues.mutex() );
+    queues = _queues.getReference();
+  }
+
+  for ( Queues::ValueType::iterator i = queues.begin(); i != queues.end(); ++i )
+  {
+    QueuePtr queue ( i->second );
+    if ( true == queue.valid() )
+    {
+      queue->metricsReset();
+    }
+  }
+}
@@ -0,0 +1,385 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Records how long jobs wait and run, how deep the queue gets, and how
+//  jobs end.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Config/Config.h"
+#include "Usul/Jobs/Metrics.h"
+#include "Usul/System/Clock.h"
+
+#include <algorithm>
+#include <ostream>
+
+using namespace Usul::Jobs;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // Return the bucket for the value.
+  inline unsigned int bucket ( Metrics::UInt64 value )
+  {
+    unsigned int index ( 0 );
+    while ( ( value > 0 ) && ( index < Metrics::Histogram::NUM_BUCKETS - 1 ) )
+    {
+      value >>= 1;
+      ++index;
+    }
+    return index;
+  }
+
+  // Return the bucket for the priority.
+  inline unsigned int priority ( Metrics::Priority p )
+  {
+    const Metrics::Priority clamped ( std::min < Metrics::Priority > ( 
+      std::max < Metrics::Priority > ( p, Metrics::MIN_PRIORITY ), Metrics::MAX_PRIORITY ) );
+    return static_cast < unsigned int > ( clamped - Metrics::MIN_PRIORITY );
+  }
+
+  // Write the histogram's summary in milliseconds.
+  inline void write ( std::ostream &out, const char *name, const Metrics::Histogram &h )
+  {
+    out << name
+        << " avg " << h.average() / 1000.0
+        << " p50 " << h.percentile ( 0.50 ) / 1000.0
+        << " p99 " << h.percentile ( 0.99 ) / 1000.0
+        << " max " << h.maximum / 1000.0;
+  }
+
+  // Write the stats on one line.
+  inline void write ( std::ostream &out, const Metrics::Stats &s )
+  {
+    out << "finished " << s.finished
+        << ", cancelled " << s.cancelled
+        << ", restarted " << s.restarted
+        << ", failed " << s.failed
+        << ", dropped " << s.dropped
+        << ", missed " << s.missed << ", ";
+    Helper::write ( out, "latency", s.latency );
+    out << ", ";
+    Helper::write ( out, "duration", s.duration );
+    out << '\n';
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Histogram constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Metrics::Histogram::Histogram() :
+  count ( 0 ),
+  total ( 0 ),
+  maximum ( 0 )
+{
+  std::fill ( buckets, buckets + NUM_BUCKETS, 0 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the value.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Metrics::Histogram::add ( UInt64 value )
+{
+  ++count;
+  total += value;
+  maximum = std::max ( maximum, value );
+  ++buckets[Helper::bucket ( value )];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the other histogram.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Metrics::Histogram::add ( const Histogram &h )
+{
+  count += h.count;
+  total += h.total;
+  maximum = std::max ( maximum, h.maximum );
+  for ( unsigned int i = 0; i < NUM_BUCKETS; ++i )
+  {
+    buckets[i] += h.buckets[i];
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the average.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+double Metrics::Histogram::average() const
+{
+  return ( ( count > 0 ) ? ( static_cast < double > ( total ) / count ) : 0.0 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the upper bound of the bucket that holds the given fraction.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Metrics::UInt64 Metrics::Histogram::percentile ( double fraction ) const
+{
+  if ( 0 == count )
+    return 0;
+
+  const UInt64 wanted ( static_cast < UInt64 > ( fraction * count + 0.5 ) );
+  UInt64 sum ( 0 );
+  for ( unsigned int i = 0; i < NUM_BUCKETS; ++i )
+  {
+    sum += buckets[i];
+    if ( ( sum >= wanted ) && ( sum > 0 ) )
+    {
+      const UInt64 bound ( ( 0 == i ) ? 0 : ( ( static_cast < UInt64 > ( 1 ) << i ) - 1 ) );
+      return std::min ( bound, maximum );
+    }
+  }
+  return maximum;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Stats constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Metrics::Stats::Stats() :
+  latency(),
+  duration(),
+  finished ( 0 ),
+  cancelled ( 0 ),
+  restarted ( 0 ),
+  failed ( 0 ),
+  dropped ( 0 ),
+  missed ( 0 )
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the other stats.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Metrics::Stats::add ( const Stats &s )
+{
+  latency.add ( s.latency );
+  duration.add ( s.duration );
+  finished += s.finished;
+  cancelled += s.cancelled;
+  restarted += s.restarted;
+  failed += s.failed;
+  dropped += s.dropped;
+  missed += s.missed;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Snapshot constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Metrics::Snapshot::Snapshot() :
+  time ( 0 ),
+  since ( 0 ),
+  threads ( 0 ),
+  depth ( 0 ),
+  running ( 0 ),
+  peakDepth ( 0 ),
+  depths(),
+  all(),
+  priorities()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the other snapshot. The depths are those of the whole queue, so the 
+//  peak is the larger one.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Metrics::Snapshot::add ( const Snapshot &s )
+{
+  time = std::max ( time, s.time );
+  since = ( ( 0 == since ) ? s.since : std::min ( since, s.since ) );
+  peakDepth = std::max ( peakDepth, s.peakDepth );
+  depths.add ( s.depths );
+  all.add ( s.all );
+  for ( PriorityStats::const_iterator i = s.priorities.begin(); i != s.priorities.end(); ++i )
+  {
+    priorities[i->first].add ( i->second );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write a summary.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Metrics::Snapshot::write ( std::ostream &out ) const
+{
+  out << "threads " << threads
+      << ", queued " << depth
+      << ", running " << running
+      << ", peak queued " << peakDepth
+      << ", over " << ( time - since ) / 1000.0 << " ms\n";
+
+  out << "  all: ";
+  Helper::write ( out, all );
+
+  for ( PriorityStats::const_iterator i = priorities.begin(); i != priorities.end(); ++i )
+  {
+    out << "  priority " << i->first << ": ";
+    Helper::write ( out, i->second );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Metrics::Metrics() :
+  _mutex(),
+  _since ( Usul::System::Clock::microseconds() ),
+  _peakDepth ( 0 ),
+  _depths()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Metrics::~Metrics()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Record a job that missed its deadline.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Metrics::missed ( Priority priority )
+{
+  Guard guard ( _mutex );
+  ++_priorities[Helper::priority ( priority )].missed;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Record a job that ran.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Metrics::record ( Priority priority, UInt64 latency, UInt64 duration, unsigned int depth, Outcome outcome )
+{
+  Guard guard ( _mutex );
+
+  _peakDepth = std::max ( _peakDepth, depth );
+  _depths.add ( depth );
+
+  Stats &stats ( _priorities[Helper::priority ( priority )] );
+  stats.latency.add ( latency );
+  stats.duration.add ( duration );
+
+  switch ( outcome )
+  {
+    case FINISHED:  ++stats.finished;  break;
+    case CANCELLED: ++stats.cancelled; break;
+    case RESTARTED: ++stats.restarted; break;
+    case FAILED:    ++stats.failed;    break;
+    case DROPPED:   ++stats.dropped;   break;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Start over.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Metrics::reset()
+{
+  Guard guard ( _mutex );
+  _since = Usul::System::Clock::microseconds();
+  _peakDepth = 0;
+  _depths = Histogram();
+  std::fill ( _priorities, _priorities + NUM_PRIORITIES, Stats() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copy the metrics.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Metrics::Snapshot Metrics::snapshot() const
+{
+  Snapshot s;
+  Stats priorities[NUM_PRIORITIES];
+  {
+    Guard guard ( _mutex );
+    s.since = _since;
+    s.peakDepth = _peakDepth;
+    s.depths = _depths;
+    std::copy ( _priorities, _priorities + NUM_PRIORITIES, priorities );
+  }
+
+  // Only list the priorities that were used. The totals are their sum.
+  for ( unsigned int i = 0; i < NUM_PRIORITIES; ++i )
+  {
+    const Stats &stats ( priorities[i] );
+    if ( ( stats.latency.count > 0 ) || ( stats.missed > 0 ) )
+    {
+      s.priorities[static_cast < Priority > ( i ) + MIN_PRIORITY] = stats;
+      s.all.add ( stats );
+    }
+  }
+
+  s.time = Usul::System::Clock::microseconds();
+  return s;
+}
@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Records how long jobs wait and run, how deep the queue gets, and how
+//  jobs end. Each lane of a queue has one, so threads taking jobs from 
+//  different lanes do not share a lock, and the queue adds them up when 
+//  asked. Recording never allocates. Times are in microseconds.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_JOBS_METRICS_H_
+#define _USUL_JOBS_METRICS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/Jobs/Handle.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/Mutex.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/noncopyable.hpp"
+
+#include <iosfwd>
+#include <map>
+
+
+namespace Usul {
+namespace Jobs {
+
+
+class USUL_EXPORT Metrics : public boost::noncopyable
+{
+public:
+
+  typedef Usul::Types::UInt64 UInt64;
+  typedef Usul::Jobs::Handle::Priority Priority;
+  typedef Usul::Threads::Mutex Mutex;
+  typedef Usul::Threads::Guard < Mutex > Guard;
+
+  // How a job ended.
+  enum Outcome
+  {
+    FINISHED,
+    CANCELLED,
+    RESTARTED,
+    FAILED,
+    DROPPED
+  };
+
+  // Counts values in power-of-two buckets. Bucket zero holds zero and
+  // bucket i holds values in [ 2^(i-1), 2^i ). The last bucket holds the
+  // rest.
+  struct USUL_EXPORT Histogram
+  {
+    enum { NUM_BUCKETS = 32 };
+
+    Histogram();
+
+    void                add ( UInt64 );
+    void                add ( const Histogram & );
+
+    // Return the average, or zero if empty.
+    double              average() const;
+
+    // Return the upper bound of the bucket that holds the given fraction
+    // of the values. For example, 0.99 returns the 99th percentile.
+    UInt64              percentile ( double fraction ) const;
+
+    UInt64 count;
+    UInt64 total;
+    UInt64 maximum;
+    UInt64 buckets[NUM_BUCKETS];
+  };
+
+  // What happened to the jobs.
+  struct USUL_EXPORT Stats
+  {
+    Stats();
+
+    void                add ( const Stats & );
+
+    Histogram latency;
+    Histogram duration;
+    UInt64 finished;
+    UInt64 cancelled;
+    UInt64 restarted;
+    UInt64 failed;
+    UInt64 dropped;
+    UInt64 missed;
+  };
+  typedef std::map < Priority, Stats > PriorityStats;
+
+  // Priorities are counted in a fixed set of buckets. The first and last
+  // buckets also hold the priorities beyond them.
+  enum
+  {
+    MIN_PRIORITY = -8,
+    MAX_PRIORITY = 7,
+    NUM_PRIORITIES = MAX_PRIORITY - MIN_PRIORITY + 1
+  };
+
+  // A copy of the metrics at one time. Take snapshots at intervals to
+  // see how the queue changes.
+  struct USUL_EXPORT Snapshot
+  {
+    Snapshot();
+
+    // Add the other one, as if they were recorded together.
+    void                add ( const Snapshot & );
+
+    // Write a summary. Times are in milliseconds.
+    void                write ( std::ostream & ) const;
+
+    UInt64 time;
+    UInt64 since;
+    unsigned int threads;
+    unsigned int depth;
+    unsigned int running;
+    unsigned int peakDepth;
+    Histogram depths;
+    Stats all;
+    PriorityStats priorities;
+  };
+
+  Metrics();
+  ~Metrics();
+
+  // Record a job that missed its deadline. It may still run.
+  void                  missed ( Priority );
+
+  // Record a job that ran. The latency is the time from being queued to
+  // starting. The depth is the size of the queue when it started.
+  void                  record ( Priority, UInt64 latency, UInt64 duration, unsigned int depth, Outcome );
+
+  // Start over.
+  void                  reset();
+
+  // Copy the metrics. The queue fills in its current state.
+  Snapshot              snapshot() const;
+
+private:
+
+  mutable Mutex _mutex;
+  UInt64 _since;
+  unsigned int _peakDepth;
+  Histogram _depths;
+  Stats _priorities[NUM_PRIORITIES];
+};
+
+
+} // namespace Jobs
+} // namespace Usul
+
+
+#endif // _USUL_JOBS_METRICS_H_
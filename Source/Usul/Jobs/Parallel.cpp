@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parallel loops that use a job-queue's threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Config/Config.h"
+#include "Usul/Jobs/Parallel.h"
+#include "Usul/Atomic/Bool.h"
+#include "Usul/Atomic/Integer.h"
+#include "Usul/Atomic/Object.h"
+#include "Usul/Base/Referenced.h"
+#include "Usul/Jobs/Manager.h"
+#include "Usul/Scope/Caller.h"
+#include "Usul/Strings/Format.h"
+
+#include "boost/bind.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+using namespace Usul::Jobs;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper class that hands out the chunks.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  class Work : public Usul::Base::Referenced
+  {
+  public:
+
+    typedef Usul::Base::Referenced BaseClass;
+
+    USUL_REFERENCED_CLASS ( Work );
+
+    Work ( std::size_t begin, std::size_t end, std::size_t grain, Detail::ParallelBody body ) : BaseClass(),
+      _begin ( begin ),
+      _end ( end ),
+      _grain ( grain ),
+      _body ( body ),
+      _next ( 0 ),
+      _failed ( false ),
+      _message()
+    {
+    }
+
+    // Throw if one of the threads failed.
+    void check() const
+    {
+      if ( true == _failed )
+      {
+        const std::string message ( _message );
+        throw std::runtime_error ( message );
+      }
+    }
+
+    // Take chunks until there are none left.
+    void run ( unsigned int worker )
+    {
+      try
+      {
+        while ( false == _failed )
+        {
+          const std::size_t chunk ( _next++ );
+          if ( chunk >= this->_numChunks() )
+            return;
+
+          const std::size_t first ( _begin + chunk * _grain );
+          const std::size_t last ( std::min ( first + _grain, _end ) );
+          _body ( first, last, worker );
+        }
+      }
+      catch ( const std::exception &e )
+      {
+        this->_fail ( Usul::Strings::format ( "Error 3524617063: Parallel loop failed, ", e.what() ) );
+      }
+      catch ( ... )
+      {
+        this->_fail ( "Error 1781296650: Parallel loop failed, unknown exception" );
+      }
+    }
+
+  protected:
+
+    virtual ~Work()
+    {
+    }
+
+    void _fail ( const std::string &message )
+    {
+      // Keep the first message.
+      Usul::Atomic::Object < std::string >::Guard guard ( _message.mutex() );
+      if ( false == _failed )
+      {
+        _message.getReference() = message;
+        _failed = true;
+      }
+    }
+
+    std::size_t _numChunks() const
+    {
+      return ( ( _end - _begin ) + _grain - 1 ) / _grain;
+    }
+
+  private:
+
+    const std::size_t _begin;
+    const std::size_t _end;
+    const std::size_t _grain;
+    Detail::ParallelBody _body;
+    Usul::Atomic::Integer < std::size_t > _next;
+    Usul::Atomic::Bool _failed;
+    Usul::Atomic::Object < std::string > _message;
+  };
+
+  // Called by the helper jobs.
+  inline void help ( Work::RefPtr work, unsigned int worker, BaseJob::RefPtr )
+  {
+    work->run ( worker );
+  }
+
+  // Remove the helpers that did not start and wait for the others.
+  inline void finish ( Queue::RefPtr queue, BaseJob::JobList &helpers )
+  {
+    for ( BaseJob::JobList::iterator i = helpers.begin(); i != helpers.end(); ++i )
+    {
+      BaseJob::RefPtr job ( *i );
+      if ( false == queue->remove ( job ) )
+      {
+        job->wait();
+      }
+    }
+    helpers.clear();
+  }
+
+  // Helpers go to the front of the queue.
+  const BaseJob::Priority HELPER_PRIORITY ( std::numeric_limits < BaseJob::Priority >::min() );
+
+  // Chunks per thread when picking the grain, so that threads that finish
+  // early can take more.
+  const std::size_t CHUNKS_PER_WORKER ( 4 );
+
+  // Smallest grain that is picked.
+  const std::size_t MIN_GRAIN ( 256 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the given queue, or the default one.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Queue::RefPtr Detail::parallelQueue ( Queue::RefPtr queue )
+{
+  if ( true == queue.valid() )
+  {
+    return queue;
+  }
+  return Queue::RefPtr ( Usul::Jobs::Manager::instance()["worker_queue"] );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the most threads that will work on a loop, including the caller.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int Detail::parallelWorkers ( Queue::RefPtr queue )
+{
+  queue = Detail::parallelQueue ( queue );
+  return ( ( true == queue.valid() ) ? queue->numThreads() + 1 : 1 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Run the loop.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Detail::parallelRun ( Queue::RefPtr queue, std::size_t begin, std::size_t end, std::size_t grain, ParallelBody body )
+{
+  if ( end <= begin )
+    return;
+
+  queue = Detail::parallelQueue ( queue );
+  const std::size_t size ( end - begin );
+  const std::size_t numWorkers ( Detail::parallelWorkers ( queue ) );
+
+  // Pick the grain from the size of the range and the number of threads.
+  if ( 0 == grain )
+  {
+    grain = std::max ( Helper::MIN_GRAIN, size / ( numWorkers * Helper::CHUNKS_PER_WORKER ) );
+  }
+
+  // Small loops, or no threads, run here.
+  const std::size_t numChunks ( ( size + grain - 1 ) / grain );
+  if ( ( numChunks < 2 ) || ( numWorkers < 2 ) )
+  {
+    body ( begin, end, 0 );
+    return;
+  }
+
+  Helper::Work::RefPtr work ( new Helper::Work ( begin, end, grain, body ) );
+
+  // Add a helper job for each thread that would have something to do.
+  // Make sure they are finished with before we return.
+  BaseJob::JobList helpers;
+  Usul::Scope::Caller::RefPtr finish ( Usul::Scope::makeCaller
+    ( boost::bind ( &Helper::finish, queue, boost::ref ( helpers ) ) ) );
+  const std::size_t numHelpers ( std::min ( numWorkers, numChunks ) - 1 );
+  for ( std::size_t i = 0; i < numHelpers; ++i )
+  {
+    BaseJob::RefPtr job ( Usul::Jobs::makeJob ( Helper::HELPER_PRIORITY,
+      boost::bind ( &Helper::help, work, static_cast < unsigned int > ( i + 1 ), _1 ) ) );
+    helpers.push_back ( job );
+    queue->add ( job );
+  }
+
+  // The calling thread works too.
+  work->run ( 0 );
+
+  // Wait for the helpers and then report any error.
+  Helper::finish ( queue, helpers );
+  work->check();
+}
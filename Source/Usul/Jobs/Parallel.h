@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Parallel loops that use a job-queue's threads.
+//
+//  The range is cut into chunks. The calling thread and some helper jobs
+//  take chunks until there are none left, so the work gets done even if
+//  the queue's threads are busy. Helpers that have not started by then are
+//  removed from the queue. The functions are called from more than one
+//  thread at the same time. If one of them throws then the remaining
+//  chunks are skipped and a std::runtime_error is thrown in the calling
+//  thread.
+//
+//  When no queue is given the "worker_queue" from the job manager is used.
+//  If there is no such queue then it all runs in the calling thread.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_JOBS_PARALLEL_H_
+#define _USUL_JOBS_PARALLEL_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/Jobs/Queue.h"
+
+#include "boost/function.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+
+namespace Usul {
+namespace Jobs {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Implementation details.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  // Called with the chunk and the index of the thread working on it.
+  typedef boost::function3 < void, std::size_t, std::size_t, unsigned int > ParallelBody;
+
+  // Return the given queue, or the default one.
+  USUL_EXPORT Queue::RefPtr parallelQueue ( Queue::RefPtr );
+
+  // Return the most threads that will work on a loop, including the caller.
+  USUL_EXPORT unsigned int parallelWorkers ( Queue::RefPtr );
+
+  // Run the loop. Pass zero for the grain to pick a size from the length
+  // of the range and the number of threads.
+  USUL_EXPORT void parallelRun ( Queue::RefPtr, std::size_t begin, std::size_t end, std::size_t grain, ParallelBody );
+
+  // Calls a loop body that does not need the thread index.
+  template < class Function > struct ForBody
+  {
+    ForBody ( Function f ) : _f ( f ){}
+    void operator () ( std::size_t begin, std::size_t end, unsigned int )
+    {
+      _f ( begin, end );
+    }
+  private:
+    Function _f;
+  };
+
+  // Accumulates into the value for the thread.
+  template < class T, class Function > struct ReduceBody
+  {
+    ReduceBody ( Function f, std::vector < T > &values ) : _f ( f ), _values ( values ){}
+    void operator () ( std::size_t begin, std::size_t end, unsigned int worker )
+    {
+      _f ( begin, end, _values.at ( worker ) );
+    }
+  private:
+    Function _f;
+    std::vector < T > &_values;
+  };
+
+  // Sorts one piece of the sequence.
+  template < class Iterator, class Compare > struct SortPiece
+  {
+    SortPiece ( Iterator first, const std::vector < std::size_t > &bounds, Compare comp ) :
+      _first ( first ), _bounds ( bounds ), _comp ( comp ){}
+    void operator () ( std::size_t begin, std::size_t end )
+    {
+      for ( std::size_t i = begin; i < end; ++i )
+      {
+        std::sort ( _first + _bounds[i], _first + _bounds[i + 1], _comp );
+      }
+    }
+  private:
+    Iterator _first;
+    const std::vector < std::size_t > &_bounds;
+    Compare _comp;
+  };
+
+  // Merges neighboring pieces that are each already sorted.
+  template < class Iterator, class Compare > struct MergePieces
+  {
+    MergePieces ( Iterator first, const std::vector < std::size_t > &bounds, std::size_t width, Compare comp ) :
+      _first ( first ), _bounds ( bounds ), _width ( width ), _comp ( comp ){}
+    void operator () ( std::size_t begin, std::size_t end )
+    {
+      const std::size_t last ( _bounds.size() - 1 );
+      for ( std::size_t i = begin; i < end; ++i )
+      {
+        const std::size_t a ( i * 2 * _width );
+        const std::size_t b ( std::min ( a + _width, last ) );
+        const std::size_t c ( std::min ( a + 2 * _width, last ) );
+        if ( b < c )
+        {
+          std::inplace_merge ( _first + _bounds[a], _first + _bounds[b], _first + _bounds[c], _comp );
+        }
+      }
+    }
+  private:
+    Iterator _first;
+    const std::vector < std::size_t > &_bounds;
+    std::size_t _width;
+    Compare _comp;
+  };
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Call f ( first, last ) for chunks of the range [begin, end).
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class Function >
+inline void parallelFor ( std::size_t begin, std::size_t end, Function f, std::size_t grain = 0, Queue::RefPtr queue = Queue::RefPtr() )
+{
+  Detail::parallelRun ( queue, begin, end, grain, Detail::ForBody < Function > ( f ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Call f ( first, last, value ) for chunks of the range [begin, end). Each
+//  thread has its own value, which starts as the identity. The values are
+//  combined with join ( a, b ), which should be associative. They are
+//  combined in the order of the threads, not the order of the range.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T, class Function, class Join >
+inline T parallelReduce ( std::size_t begin, std::size_t end, const T &identity, Function f, Join join, std::size_t grain = 0, Queue::RefPtr queue = Queue::RefPtr() )
+{
+  queue = Detail::parallelQueue ( queue );
+
+  std::vector < T > values ( Detail::parallelWorkers ( queue ), identity );
+  Detail::parallelRun ( queue, begin, end, grain, Detail::ReduceBody < T, Function > ( f, values ) );
+
+  T answer ( identity );
+  for ( typename std::vector < T >::const_iterator i = values.begin(); i != values.end(); ++i )
+  {
+    answer = join ( answer, *i );
+  }
+  return answer;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Sort the sequence. Each thread sorts a piece and then the pieces are
+//  merged in pairs. Like std::sort, this is not stable.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class Iterator, class Compare >
+inline void parallelSort ( Iterator first, Iterator last, Compare comp, Queue::RefPtr queue = Queue::RefPtr() )
+{
+  queue = Detail::parallelQueue ( queue );
+
+  // Not worth it for short sequences.
+  const std::size_t size ( last - first );
+  const std::size_t numPieces ( std::min < std::size_t > ( Detail::parallelWorkers ( queue ), size / 1024 ) );
+  if ( numPieces < 2 )
+  {
+    std::sort ( first, last, comp );
+    return;
+  }
+
+  // Where the pieces start.
+  std::vector < std::size_t > bounds ( numPieces + 1 );
+  for ( std::size_t i = 0; i <= numPieces; ++i )
+  {
+    bounds[i] = ( size * i ) / numPieces;
+  }
+
+  // Sort each piece.
+  Usul::Jobs::parallelFor ( 0, numPieces, Detail::SortPiece < Iterator, Compare > ( first, bounds, comp ), 1, queue );
+
+  // Merge them until there is one.
+  for ( std::size_t width = 1; width < numPieces; width *= 2 )
+  {
+    const std::size_t numMerges ( ( numPieces + 2 * width - 1 ) / ( 2 * width ) );
+    Usul::Jobs::parallelFor ( 0, numMerges, Detail::MergePieces < Iterator, Compare > ( first, bounds, width, comp ), 1, queue );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Sort the sequence with operator <.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class Iterator >
+inline void parallelSort ( Iterator first, Iterator last, Queue::RefPtr queue = Queue::RefPtr() )
+{
+  typedef typename std::iterator_traits < Iterator >::value_type ValueType;
+  Usul::Jobs::parallelSort ( first, last, std::less < ValueType > (), queue );
+}
+
+
+} // namespace Jobs
+} // namespace Usul
+
+
+#endif // _USUL_JOBS_PARALLEL_H_
@@ -0,0 +1,475 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Binary heap of jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Config/Config.h"
+#include "Usul/Jobs/PriorityQueue.h"
+#include "Usul/Errors/Assert.h"
+
+#include <stdexcept>
+
+using namespace Usul::Jobs;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PriorityQueue::PriorityQueue() :
+  _entries(),
+  _deadlines ( false )
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copy constructor. The copy has the same order so the indices are valid.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PriorityQueue::PriorityQueue ( const PriorityQueue &q ) :
+  _entries ( q._entries ),
+  _deadlines ( q._deadlines )
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Assignment.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PriorityQueue &PriorityQueue::operator = ( const PriorityQueue &q )
+{
+  _entries = q._entries;
+  _deadlines = q._deadlines;
+  return *this;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PriorityQueue::~PriorityQueue()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the entry at the index.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const PriorityQueue::Entry &PriorityQueue::at ( unsigned int index ) const
+{
+  return _entries.at ( index );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove all the jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::clear()
+{
+  for ( Entries::iterator i = _entries.begin(); i != _entries.end(); ++i )
+  {
+    i->job->_queued = 0;
+  }
+  _entries.clear();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the use of deadlines.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PriorityQueue::deadlinesGet() const
+{
+  return _deadlines;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the use of deadlines.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::deadlinesSet ( bool state )
+{
+  if ( state != _deadlines )
+  {
+    _deadlines = state;
+    this->rebuild();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is the job in this queue?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PriorityQueue::contains ( const BaseJob::RefPtr &job ) const
+{
+  if ( false == job.valid() )
+    return false;
+
+  const unsigned int index ( job->_queueIndex );
+  return ( ( index < _entries.size() ) && ( _entries[index].job.get() == job.get() ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is the queue empty?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PriorityQueue::empty() const
+{
+  return _entries.empty();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove the job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PriorityQueue::erase ( const BaseJob::RefPtr &job )
+{
+  if ( false == this->contains ( job ) )
+    return false;
+
+  this->_remove ( job->_queueIndex );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the job's entry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const PriorityQueue::Entry *PriorityQueue::find ( const BaseJob::RefPtr &job ) const
+{
+  return ( ( true == this->contains ( job ) ) ? &_entries[job->_queueIndex] : 0x0 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the first entry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const PriorityQueue::Entry &PriorityQueue::first() const
+{
+  if ( true == _entries.empty() )
+  {
+    throw std::runtime_error ( "Error 2903584617: Priority queue is empty" );
+  }
+  return _entries.front();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the key without re-ordering.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::key ( unsigned int index, Key k )
+{
+  _entries.at ( index ).key = k;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove and return the first job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+BaseJob::RefPtr PriorityQueue::pop()
+{
+  if ( true == _entries.empty() )
+  {
+    throw std::runtime_error ( "Error 2903584617: Priority queue is empty" );
+  }
+
+  // Put the first one last, then take its reference without copying.
+  const unsigned int last ( _entries.size() - 1 );
+  if ( 0 != last )
+  {
+    this->_swap ( 0, last );
+  }
+  BaseJob::RefPtr job ( USUL_MOVE ( _entries.back().job ) );
+  _entries.pop_back();
+  job->_queued = 0;
+
+  if ( false == _entries.empty() )
+  {
+    this->_move ( 0 );
+  }
+  return job;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PriorityQueue::push ( BaseJob::RefPtr job, Key k, Time t )
+{
+  if ( false == job.valid() )
+    return false;
+
+  // The job may be in another lane's queue, which is not locked. Its index 
+  // belongs to that queue, so claim the job before touching it.
+  if ( 0 != job->_queued.fetch_and_store ( 1 ) )
+    return false;
+
+  const Time deadline ( job->deadlineGet() );
+  _entries.push_back ( Entry ( USUL_MOVE ( job ), k, t, deadline ) );
+  const unsigned int index ( _entries.size() - 1 );
+  this->_place ( index );
+  this->_siftUp ( index );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Re-order the whole heap.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::rebuild()
+{
+  const unsigned int num ( _entries.size() );
+  for ( unsigned int i = 0; i < num; ++i )
+  {
+    this->_place ( i );
+  }
+  for ( unsigned int i = num / 2; i > 0; --i )
+  {
+    this->_siftDown ( i - 1 );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int PriorityQueue::size() const
+{
+  return _entries.size();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Change the key of the job and move it to its new place.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PriorityQueue::update ( const BaseJob::RefPtr &job, Key k )
+{
+  if ( false == this->contains ( job ) )
+    return false;
+
+  _entries[job->_queueIndex].key = k;
+  this->_move ( job->_queueIndex );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Change the deadline of the job and move it to its new place.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PriorityQueue::updateDeadline ( const BaseJob::RefPtr &job, Time deadline )
+{
+  if ( false == this->contains ( job ) )
+    return false;
+
+  _entries[job->_queueIndex].deadline = deadline;
+  this->_move ( job->_queueIndex );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Does the entry at the first index come before the one at the second?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool PriorityQueue::_less ( unsigned int a, unsigned int b ) const
+{
+  const Entry &left ( _entries[a] );
+  const Entry &right ( _entries[b] );
+  if ( ( true == _deadlines ) && ( left.deadline != right.deadline ) )
+  {
+    // Zero means no deadline, which comes last.
+    if ( 0 == left.deadline )
+      return false;
+    if ( 0 == right.deadline )
+      return true;
+    return ( left.deadline < right.deadline );
+  }
+  if ( left.key != right.key )
+  {
+    return ( left.key < right.key );
+  }
+  return ( left.job->id() < right.job->id() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Tell the job where it is.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::_place ( unsigned int index )
+{
+  _entries[index].job->_queueIndex = index;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Remove the entry at the index.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::_remove ( unsigned int index )
+{
+  USUL_ASSERT ( index < _entries.size() );
+
+  const unsigned int last ( _entries.size() - 1 );
+  if ( index != last )
+  {
+    this->_swap ( index, last );
+  }
+  _entries.back().job->_queued = 0;
+  _entries.pop_back();
+
+  if ( index < _entries.size() )
+  {
+    this->_move ( index );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Move the entry up or down to its place.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::_move ( unsigned int index )
+{
+  const BaseJob *job ( _entries[index].job.get() );
+  this->_siftUp ( index );
+  this->_siftDown ( job->_queueIndex );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Move the entry down until its children are larger.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::_siftDown ( unsigned int index )
+{
+  const unsigned int num ( _entries.size() );
+  while ( true )
+  {
+    const unsigned int left ( 2 * index + 1 );
+    const unsigned int right ( left + 1 );
+    unsigned int smallest ( index );
+
+    if ( ( left < num ) && ( true == this->_less ( left, smallest ) ) )
+      smallest = left;
+    if ( ( right < num ) && ( true == this->_less ( right, smallest ) ) )
+      smallest = right;
+
+    if ( smallest == index )
+      return;
+
+    this->_swap ( index, smallest );
+    index = smallest;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Move the entry up until its parent is smaller.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::_siftUp ( unsigned int index )
+{
+  while ( index > 0 )
+  {
+    const unsigned int parent ( ( index - 1 ) / 2 );
+    if ( false == this->_less ( index, parent ) )
+      return;
+
+    this->_swap ( index, parent );
+    index = parent;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Swap the entries and tell the jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void PriorityQueue::_swap ( unsigned int a, unsigned int b )
+{
+  std::swap ( _entries[a], _entries[b] );
+  this->_place ( a );
+  this->_place ( b );
+}
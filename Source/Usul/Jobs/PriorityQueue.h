@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Binary heap of jobs. Each job knows where it is in the heap so that it
+//  can be removed or moved when its key changes in logarithmic time.
+//  A job can only be in one of these at a time, which is checked without 
+//  locking the other ones. Otherwise not thread-safe; the owner has to lock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_JOBS_PRIORITY_QUEUE_H_
+#define _USUL_JOBS_PRIORITY_QUEUE_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/Jobs/Job.h"
+#include "Usul/Types/Types.h"
+
+#include <vector>
+
+
+namespace Usul {
+namespace Jobs {
+
+
+class USUL_EXPORT PriorityQueue
+{
+public:
+
+  typedef BaseJob::Priority Key;
+  typedef Usul::Types::UInt64 Time;
+
+  // A smaller key comes first. Jobs with equal keys are in the order of
+  // their ids, which is the order they were made. When using deadlines, 
+  // the earliest deadline comes before the key is compared, and a zero 
+  // deadline comes after all the others.
+  struct Entry
+  {
+    Entry ( BaseJob::RefPtr j, Key k, Time t, Time d ) : job ( USUL_MOVE ( j ) ), key ( k ), time ( t ), deadline ( d ){}
+    BaseJob::RefPtr job;
+    Key key;
+    Time time;
+    Time deadline;
+  };
+  typedef std::vector < Entry > Entries;
+
+  PriorityQueue();
+  PriorityQueue ( const PriorityQueue & );
+  PriorityQueue &operator = ( const PriorityQueue & );
+  ~PriorityQueue();
+
+  // Return the entry at the index. The order is that of the heap.
+  const Entry &         at ( unsigned int index ) const;
+
+  // Remove all the jobs.
+  void                  clear();
+
+  // Get/set the use of deadlines. Setting re-orders the heap.
+  bool                  deadlinesGet() const;
+  void                  deadlinesSet ( bool );
+
+  // Is the job in this queue?
+  bool                  contains ( const BaseJob::RefPtr & ) const;
+
+  // Is the queue empty?
+  bool                  empty() const;
+
+  // Remove the job. Returns false if it was not found.
+  bool                  erase ( const BaseJob::RefPtr & );
+
+  // Return the job's entry, or null if the job is not in this queue.
+  const Entry *         find ( const BaseJob::RefPtr & ) const;
+
+  // Return the first entry. The queue must not be empty.
+  const Entry &         first() const;
+
+  // Set the key of the entry at the index without re-ordering.
+  // Call rebuild() after setting the keys.
+  void                  key ( unsigned int index, Key );
+
+  // Remove and return the first job. The queue must not be empty.
+  BaseJob::RefPtr       pop();
+
+  // Add the job with its current deadline. Returns false if it is already 
+  // in this or any other queue.
+  bool                  push ( BaseJob::RefPtr, Key, Time );
+
+  // Re-order the whole heap. Linear time.
+  void                  rebuild();
+
+  // Return the number of jobs.
+  unsigned int          size() const;
+
+  // Change the key of the job and move it to its new place.
+  // Returns false if the job was not found.
+  bool                  update ( const BaseJob::RefPtr &, Key );
+
+  // Change the deadline of the job and move it to its new place.
+  // Returns false if the job was not found.
+  bool                  updateDeadline ( const BaseJob::RefPtr &, Time );
+
+private:
+
+  bool                  _less ( unsigned int, unsigned int ) const;
+
+  void                  _move ( unsigned int );
+
+  void                  _place ( unsigned int );
+
+  void                  _remove ( unsigned int );
+
+  void                  _siftDown ( unsigned int );
+  void                  _siftUp ( unsigned int );
+
+  void                  _swap ( unsigned int, unsigned int );
+
+  Entries _entries;
+  bool _deadlines;
+};
+
+
+} // namespace Jobs
+} // namespace Usul
+
+
+#endif // _USUL_JOBS_PRIORITY_QUEUE_H_
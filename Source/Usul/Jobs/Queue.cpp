@@ -1,4 +1,3 @@
-
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Copyright (c) 2009, Perry L Miller IV
@@ -15,47 +14,107 @@
 
 #include "Usul/Config/Config.h"
 #include "Usul/Jobs/Queue.h"
+#include "Usul/Jobs/Timer.h"
 #include "Usul/Errors/Assert.h"
 #include "Usul/Exceptions/Exceptions.h"
 #include "Usul/Functions/NoThrow.h"
-#include "Usul/Registry/Database.h"
-#include "Usul/Scope/Caller.h"
 #include "Usul/System/Clock.h"
-#include "Usul/System/Sleep.h"
 #include "Usul/Threads/ThreadId.h"
 
 #include "boost/bind.hpp"
 #include "boost/thread/thread.hpp"
-#include "boost/thread/thread_time.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
 using namespace Usul::Jobs;
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // Priority used when a lane has no queued jobs.
+  const Queue::Priority EMPTY_LANE ( std::numeric_limits < Queue::Priority >::max() );
+
+  // The lanes are owned by the queue, not the thread-local pointer.
+  inline void noDelete ( Queue::Lane * )
+  {
+  }
+
+  // Return the job's priority.
+  inline Queue::Priority currentPriority ( BaseJob::RefPtr job )
+  {
+    return job->priority();
+  }
+
+  // Make the lanes.
+  inline Queue::Lanes makeLanes ( unsigned int num )
+  {
+    Queue::Lanes lanes;
+    lanes.reserve ( ( num > 0 ) ? num : 1 );
+    do
+    {
+      lanes.push_back ( Queue::LanePtr ( new Queue::Lane ) );
+    }
+    while ( lanes.size() < num );
+    return lanes;
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Lane constructor
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Queue::Lane::Lane() :
+  queued(),
+  running(),
+  first ( Helper::EMPTY_LANE ),
+  metrics()
+{
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Constructor
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-Queue::Queue ( unsigned int numThreads ) : 
+Queue::Queue ( unsigned int numThreads, bool workStealing ) :
   _threads(),
   _started ( false ),
   _cancelled ( false ),
-  _sleep ( 10 ),
-  _queued(),
-  _running()
+  _lanes ( Helper::makeLanes ( ( true == workStealing ) ? numThreads : 1 ) ),
+  _currentLane ( &Helper::noDelete ),
+  _nextLane ( 0 ),
+  _numQueued ( 0 ),
+  _numIdle ( 0 ),
+  _mutex(),
+  _jobAdded(),
+  _jobFinished(),
+  _epoch ( Usul::System::Clock::microseconds() ),
+  _aging ( 0 ),
+  _deadlines ( false ),
+  _missed ( Queue::MISSED_RUN ),
+  _restartDelay ( RestartDelay ( 1, 1000 ) ),
+  _hasNotify ( false ),
+  _notify(),
+  _link ( new BaseJob::QueueLink ( this ) )
 {
   if ( numThreads > 0 )
   {
     _threads.getReference().resize ( numThreads );
   }
-
-  Usul::Registry::Database &reg ( Usul::Registry::Database::instance() );
-  Usul::Registry::Node &section ( reg["main_window"]["worker_thread"]["sleep_duration"] );
-  _sleep = section.get<unsigned long> ( _sleep, true );
 }
 
 
@@ -69,11 +128,22 @@ Queue::~Queue()
 {
   USUL_TRY_BLOCK
   {
+    // Deferred jobs that become ready from now on are not added to us.
+    {
+      BaseJob::Guard guard ( _link->mutex );
+      _link->queue = 0x0;
+    }
+
     // Clear the queued jobs.
-    _queued.clear();
+    this->clear();
 
-    // Cancel the running threads.
-    _cancelled = true;
+    // Cancel the running threads. Set the flag while locked so that no
+    // thread misses the wake-up.
+    {
+      Guard guard ( _mutex );
+      _cancelled = true;
+      _jobAdded.notify_all();
+    }
 
     // Copy the threads and clear our member.
     ThreadList threads;
@@ -95,15 +165,21 @@ Queue::~Queue()
       }
     }
 
-    // It's possible for the threads to finish and some jobs to still be in the
-    // running set. This is rare, but causes a structured exception upon exit.
-    while ( this->numRunning() > 0 )
+    // Jobs executed by other threads (see executeNextJob) may still be
+    // running. Wait for them to be removed.
     {
-      Usul::System::Sleep::milliseconds ( 10 );
+      Guard guard ( _mutex );
+      while ( this->numRunning() > 0 )
+      {
+        _jobFinished.wait ( _mutex );
+      }
     }
 
+    // The jobs that were running may have queued their successors.
+    this->clear();
+
     // When we get to here there should not be any running jobs.
-    USUL_ASSERT ( true == _running.empty() );
+    USUL_ASSERT ( 0 == this->numRunning() );
   }
   USUL_DEFINE_CATCH_BLOCKS ( "2639042759" );
 }
@@ -121,14 +197,128 @@ void Queue::add ( BaseJob::RefPtr job )
   if ( false == job.valid() )
     return;
 
-  // Insert the new job.
+  // A job that is waiting for its predecessors gets added when they finish.
+  if ( false == job->_isReadyToQueue ( _link ) )
+    return;
+
+  // Insert the new job. The queue takes our reference.
   {
-    AtomicJobSet::Guard guard ( _queued.mutex() );
-    _queued.getReference().insert ( job );
+    const Usul::Types::UInt64 now ( Usul::System::Clock::microseconds() );
+    const PriorityQueue::Key key ( this->_key ( job->priority(), now ) );
+    Lane &lane ( this->_laneForAdd() );
+    AtomicPriorityQueue::Guard guard ( lane.queued.mutex() );
+    if ( true == lane.queued.getReference().push ( USUL_MOVE ( job ), key, now ) )
+    {
+      ++_numQueued;
+      this->_updateFirst ( lane );
+    }
   }
 
   // Make sure the threads are started.
   this->_startThreads();
+
+  // Wake up one of the idle threads, if there are any.
+  if ( _numIdle > 0 )
+  {
+    Guard guard ( _mutex );
+    _jobAdded.notify_one();
+  }
+
+  // Tell the owner.
+  if ( true == _hasNotify )
+  {
+    Callback notify;
+    {
+      Guard guard ( _notify.mutex() );
+      notify = _notify.getReference();
+    }
+    if ( false == notify.empty() )
+    {
+      notify();
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the function that is called after a job is added.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::notifySet ( Callback notify )
+{
+  _notify = notify;
+  _hasNotify = ( false == notify.empty() );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the delay before a restarted job is queued again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::restartDelaySet ( const RestartDelay &delay )
+{
+  _restartDelay = delay;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the delay before a restarted job is queued again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Queue::RestartDelay Queue::restartDelayGet() const
+{
+  return _restartDelay;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Queue the job again after it restarted. The delay doubles each time so 
+//  that a job waiting on something does not keep a thread busy.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::_restartJob ( BaseJob &job )
+{
+  const RestartDelay delay ( _restartDelay );
+  const unsigned int restarts ( job._restarts++ );
+  // The timer would keep a dying queue alive, so skip the delay then.
+  if ( ( 0 == delay.first ) || ( true == _cancelled ) )
+  {
+    this->add ( BaseJob::RefPtr ( &job ) );
+    return;
+  }
+
+  // Stop doubling before it overflows.
+  const unsigned int doublings ( std::min ( restarts, 30u ) );
+  const Usul::Types::UInt64 wait ( std::min ( delay.first << doublings, std::max ( delay.first, delay.second ) ) );
+  Usul::Jobs::Timer::instance().schedule ( Queue::RefPtr ( this ), BaseJob::RefPtr ( &job ), wait );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the lane that a new job goes into. Jobs added from one of our
+//  threads go into that thread's lane. Others are spread across the lanes.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Queue::Lane &Queue::_laneForAdd()
+{
+  Lane *lane ( _currentLane.get() );
+  if ( 0x0 != lane )
+  {
+    return *lane;
+  }
+
+  const unsigned long index ( _nextLane++ );
+  return *( _lanes.at ( index % _lanes.size() ) );
 }
 
 
@@ -140,9 +330,23 @@ void Queue::add ( BaseJob::RefPtr job )
 
 void Queue::clear()
 {
-  AtomicJobSet::Guard guard ( _queued.mutex() );
-  JobSet &queue ( _queued.getReference() );
-  queue.clear();
+  BaseJob::JobList removed;
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    Lane &lane ( **i );
+    AtomicPriorityQueue::Guard guard ( lane.queued.mutex() );
+    PriorityQueue &queue ( lane.queued.getReference() );
+    for ( unsigned int j = 0; j < queue.size(); ++j )
+    {
+      removed.push_back ( queue.at ( j ).job );
+    }
+    _numQueued -= queue.size();
+    queue.clear();
+    this->_updateFirst ( lane );
+  }
+
+  // Not while a lane is locked because it wakes up the waiting threads.
+  this->_cancelJobs ( removed );
 }
 
 
@@ -154,9 +358,228 @@ void Queue::clear()
 
 bool Queue::remove ( BaseJob::RefPtr job )
 {
-  AtomicJobSet::Guard guard ( _queued.mutex() );
-  const unsigned int num ( _queued.getReference().erase ( job ) );
-  return ( num > 0 );
+  bool found ( false );
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    Lane &lane ( **i );
+    AtomicPriorityQueue::Guard guard ( lane.queued.mutex() );
+    if ( true == lane.queued.getReference().erase ( job ) )
+    {
+      --_numQueued;
+      this->_updateFirst ( lane );
+      found = true;
+      break;
+    }
+  }
+
+  if ( false == found )
+    return false;
+
+  BaseJob::JobList removed ( 1, job );
+  this->_cancelJobs ( removed );
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel and finish the jobs that were taken out of the queue. Their 
+//  successors are cancelled too, so they are finished here instead of 
+//  being queued.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::_cancelJobs ( BaseJob::JobList &jobs )
+{
+  while ( false == jobs.empty() )
+  {
+    BaseJob::RefPtr job ( USUL_MOVE ( jobs.back() ) );
+    jobs.pop_back();
+    job->cancel();
+    job->_finish ( jobs );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Change the priority of the job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Queue::prioritize ( BaseJob::RefPtr job, Priority p )
+{
+  if ( false == job.valid() )
+    return false;
+
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    Lane &lane ( **i );
+    AtomicPriorityQueue::Guard guard ( lane.queued.mutex() );
+    PriorityQueue &queue ( lane.queued.getReference() );
+    const PriorityQueue::Entry *entry ( queue.find ( job ) );
+    if ( 0x0 != entry )
+    {
+      job->_priority = p;
+      queue.update ( job, this->_key ( p, entry->time ) );
+      this->_updateFirst ( lane );
+      return true;
+    }
+  }
+
+  // The job is not queued.
+  job->_priority = p;
+  return false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Change the deadline of the job.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Queue::reschedule ( BaseJob::RefPtr job, Usul::Types::UInt64 deadline )
+{
+  if ( false == job.valid() )
+    return false;
+
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    Lane &lane ( **i );
+    AtomicPriorityQueue::Guard guard ( lane.queued.mutex() );
+    PriorityQueue &queue ( lane.queued.getReference() );
+    if ( true == queue.contains ( job ) )
+    {
+      job->deadlineSet ( deadline );
+      queue.updateDeadline ( job, deadline );
+      this->_updateFirst ( lane );
+      return true;
+    }
+  }
+
+  // The job is not queued.
+  job->deadlineSet ( deadline );
+  return false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Turn earliest-deadline-first on or off. The lanes are re-ordered.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::deadlinesSet ( bool state )
+{
+  _deadlines = state;
+
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    Lane &lane ( **i );
+    AtomicPriorityQueue::Guard guard ( lane.queued.mutex() );
+    lane.queued.getReference().deadlinesSet ( state );
+    this->_updateFirst ( lane );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is it earliest-deadline-first?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Queue::deadlinesGet() const
+{
+  return _deadlines;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set what happens to a job that missed its deadline.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::missedSet ( Missed missed )
+{
+  _missed = missed;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get what happens to a job that missed its deadline.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Queue::Missed Queue::missedGet() const
+{
+  const unsigned int missed ( _missed );
+  return static_cast < Missed > ( missed );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Set the aging rate. The queued jobs are given new keys.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::agingSet ( Usul::Types::UInt64 milliseconds )
+{
+  _aging = milliseconds;
+  this->prioritize ( &Helper::currentPriority );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the aging rate.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Usul::Types::UInt64 Queue::agingGet() const
+{
+  return _aging;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the key for a job with the given priority that was queued at the 
+//  given time in microseconds. With aging, a job queued later gets a larger 
+//  key, which is the same as the jobs that are already queued moving ahead. 
+//  This way the keys never change while the jobs wait.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+PriorityQueue::Key Queue::_key ( Priority p, Usul::Types::UInt64 time ) const
+{
+  const Usul::Types::UInt64 aging ( _aging );
+  if ( ( 0 == aging ) || ( time <= _epoch ) )
+  {
+    return p;
+  }
+
+  // Stay below the value that means a lane is empty.
+  const PriorityQueue::Key levels ( static_cast < PriorityQueue::Key > ( ( time - _epoch ) / ( aging * 1000 ) ) );
+  const PriorityQueue::Key limit ( Helper::EMPTY_LANE - 1 );
+  return ( ( p > limit - levels ) ? limit : ( p + levels ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Update the lane's first key. Call with the lane's queue locked.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::_updateFirst ( Lane &lane )
+{
+  const PriorityQueue &jobs ( lane.queued.getReference() );
+  lane.first = ( ( true == jobs.empty() ) ? Helper::EMPTY_LANE : jobs.first().key );
 }
 
 
@@ -178,10 +601,10 @@ void Queue::_startThreads()
     // This handles two or more threads ebtering this function at the same time.
     if ( false == _started )
     {
-      for ( ThreadList::iterator i = threads.begin(); i != threads.end(); ++i )
+      for ( unsigned int i = 0; i < threads.size(); ++i )
       {
-	ThreadPtr &thread ( *i );
-	thread = ThreadPtr ( new boost::thread ( boost::bind ( &Queue::_runThread, this ) ) );
+	ThreadPtr &thread ( threads[i] );
+	thread = ThreadPtr ( new boost::thread ( boost::bind ( &Queue::_runThread, this, i ) ) );
       }
 
       // Set the flag for quick checking.
@@ -197,8 +620,14 @@ void Queue::_startThreads()
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Queue::_runThread()
+void Queue::_runThread ( unsigned int index )
 {
+  // When work-stealing each thread has its own lane.
+  if ( true == this->isWorkStealing() )
+  {
+    _currentLane.reset ( _lanes.at ( index % _lanes.size() ).get() );
+  }
+
   while ( false == _cancelled )
   {
     Usul::Functions::noThrow ( boost::bind ( &Queue::_executeNextJob, this ), "2797080869" );
@@ -208,20 +637,63 @@ void Queue::_runThread()
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Execute the next job or sleep if there are no jobs.
+//  Wait for a job and then execute it.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 void Queue::_executeNextJob()
 {
-  // This will return false if there are no jobs.
-  if ( false == this->executeNextJob() )
+  // Blocks until there is a job or we are cancelled.
+  this->_waitForJob();
+
+  // Another thread may have taken the job, which is fine.
+  if ( false == _cancelled )
+  {
+    this->executeNextJob();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Block the calling thread until there is a job or we are cancelled.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::_waitForJob()
+{
+  Guard guard ( _mutex );
+  ++_numIdle;
+  while ( ( false == _cancelled ) && ( 0 == _numQueued ) )
   {
-    boost::this_thread::sleep ( boost::posix_time::milliseconds ( _sleep ) );
+    _jobAdded.wait ( _mutex );
   }
+  --_numIdle;
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Removes the job from the running jobs when it goes out of scope. It lives 
+//  on the stack so that running a job does not allocate.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+struct Queue::RunningJob : public boost::noncopyable
+{
+  RunningJob ( Queue &queue, const LanePtr &lane, const BaseJob::RefPtr &job ) : 
+    _queue ( queue ), _lane ( lane ), _job ( job ){}
+  ~RunningJob()
+  {
+    Usul::Functions::noThrow ( boost::bind ( &Queue::_runningJobRemove, &_queue, boost::cref ( _lane ), boost::cref ( _job ) ), "1605274119" );
+  }
+private:
+  Queue &_queue;
+  const LanePtr &_lane;
+  const BaseJob::RefPtr &_job;
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Execute the next job. Return false if there are no jobs.
@@ -230,18 +702,32 @@ void Queue::_executeNextJob()
 
 bool Queue::executeNextJob()
 {
-  // Get the next job.
-  BaseJob::RefPtr job ( this->_getNextJob() );
+  // Get the next job, the lane it is running in, and when it was queued.
+  LanePtr lane ( 0x0 );
+  Usul::Types::UInt64 queued ( 0 );
+  BaseJob::RefPtr job ( this->_getNextJob ( lane, queued ) );
 
   // If we have a job...
   if ( true == job.valid() )
   {
     // Always remove it from the running collection.
-    Usul::Scope::Caller::RefPtr remove ( Usul::Scope::makeCaller 
-      ( boost::bind ( &Queue::_runningJobRemove, this, job ) ) );
+    RunningJob remove ( *this, lane, job );
+
+    // Execute the job. It is not finished if it was restarted.
+    const unsigned int depth ( _numQueued );
+    const Usul::Types::UInt64 start ( Usul::System::Clock::microseconds() );
+    const Metrics::Outcome outcome ( this->_executeJob ( *job ) );
+    const Usul::Types::UInt64 finish ( Usul::System::Clock::microseconds() );
+    if ( Metrics::RESTARTED != outcome )
+    {
+      this->_finishJob ( *job );
+    }
 
-    // Execute the job.
-    this->_executeJob ( job );
+    // The clock can go backwards if the system time is changed.
+    lane->metrics.record ( job->priority(), 
+      ( start > queued ) ? start - queued : 0, 
+      ( finish > start ) ? finish - start : 0, 
+      depth, outcome );
 
     // If we get to here then we successfully executed the job.
     return true;
@@ -254,77 +740,192 @@ bool Queue::executeNextJob()
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Get the next job.
+//  Get the next job. This is the first job in the lane with the smallest
+//  key. The calling thread's own lane wins a tie. When using deadlines, 
+//  jobs that missed theirs are handled here.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-BaseJob::RefPtr Queue::_getNextJob()
+BaseJob::RefPtr Queue::_getNextJob ( LanePtr &from, Usul::Types::UInt64 &queued )
 {
-  // Initialize the next job.
-  BaseJob::RefPtr next ( 0x0 );
+  Lane *own ( _currentLane.get() );
 
-  // Local scope to minimize the time we lock.
+  // Only look at the clock if we need it.
+  const bool deadlines ( _deadlines );
+  const Missed missed ( this->missedGet() );
+  const Usul::Types::UInt64 now ( ( true == deadlines ) ? Usul::System::Clock::microseconds() : 0 );
+
+  // Another thread can take the job between looking and locking.
+  while ( _numQueued > 0 )
   {
-    // Lock queue and get shortcut.
-    AtomicJobSet::Guard guard ( _queued.mutex() );
-    AtomicJobSet::ValueType &q ( _queued.getReference() );
+    // Find the lane with the smallest key without locking.
+    LanePtr best ( 0x0 );
+    Priority priority ( Helper::EMPTY_LANE );
+    for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+    {
+      const Priority first ( (*i)->first );
+      if ( ( first < priority ) || ( ( first == priority ) && ( own == i->get() ) ) )
+      {
+        best = *i;
+        priority = first;
+      }
+    }
+
+    // All the lanes have emptied.
+    if ( 0x0 == best.get() )
+    {
+      break;
+    }
 
-    // If there are jobs...
-    if ( false == q.empty() )
+    // Local scope to minimize the time we lock.
+    BaseJob::RefPtr next ( 0x0 );
+    bool drop ( false );
     {
-      // The next job will always be at the beginning of the map.
-      AtomicJobSet::ValueType::iterator i ( q.begin() );
-      next = *i;
+      // Lock queue and get shortcut.
+      AtomicPriorityQueue::Guard guard ( best->queued.mutex() );
+      PriorityQueue &q ( best->queued.getReference() );
 
-      // Erase the job from the queue.
-      q.erase ( i );
+      // If there are jobs...
+      while ( false == q.empty() )
+      {
+        // The next job is always at the top of the heap.
+        const PriorityQueue::Entry &first ( q.first() );
+        const bool late ( ( true == deadlines ) && ( first.deadline > 0 ) && ( first.deadline < now ) );
+        if ( true == late )
+        {
+          best->metrics.missed ( first.job->priority() );
+        }
+
+        // A downgraded job goes behind the ones that still have deadlines.
+        if ( ( true == late ) && ( Queue::MISSED_DOWNGRADE == missed ) )
+        {
+          BaseJob::RefPtr job ( first.job );
+          job->deadlineSet ( 0 );
+          q.updateDeadline ( job, 0 );
+          continue;
+        }
+
+        queued = first.time;
+        next = q.pop();
+        --_numQueued;
+        drop = ( ( true == late ) && ( Queue::MISSED_DROP == missed ) );
+        break;
+      }
+      this->_updateFirst ( *best );
     }
-  }
 
-  // If we have a job...
-  if ( true == next.valid() )
-  {
-    // Add job to running collection.
-    this->_runningJobAdd ( next );
+    // A dropped job is finished without running.
+    if ( true == drop )
+    {
+      this->_dropJob ( *best, *next, queued, now );
+      continue;
+    }
+
+    // If we have a job...
+    if ( true == next.valid() )
+    {
+      // Add job to the lane's running collection.
+      {
+        AtomicJobSet::Guard guard ( best->running.mutex() );
+        best->running.getReference().insert ( next );
+      }
+      from = best;
+      return next;
+    }
   }
 
-  // Return the next job, which may be null.
-  return next;
+  // No job.
+  return BaseJob::RefPtr ( 0x0 );
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Execute the job.
+//  Cancel and finish the job without running it.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Queue::_executeJob ( BaseJob::RefPtr job )
+void Queue::_dropJob ( Lane &lane, BaseJob &job, Usul::Types::UInt64 queued, Usul::Types::UInt64 now )
 {
-  if ( false == job.valid() )
-    return;
+  const unsigned int depth ( _numQueued );
+  job.cancel();
+  this->_finishJob ( job );
+  lane.metrics.record ( job.priority(), ( now > queued ) ? now - queued : 0, 0, depth, Metrics::DROPPED );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Signal that the job finished and add the jobs that were waiting on it. 
+//  Each goes to the queue it was added to, which may not be this one. If 
+//  that queue is gone then the job is cancelled, as its queued jobs were.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Queue::_finishJob ( BaseJob &job )
+{
+  BaseJob::JobList ready;
+  job._finish ( ready );
+
+  for ( BaseJob::JobList::iterator i = ready.begin(); i != ready.end(); ++i )
+  {
+    BaseJob::RefPtr next ( USUL_MOVE ( *i ) );
+    BaseJob::QueueLinkPtr link;
+    link.swap ( next->_queueLink );
 
+    if ( 0x0 == link.get() )
+    {
+      this->add ( next );
+      continue;
+    }
+
+    // Keep the queue from being destroyed while the job is added.
+    {
+      BaseJob::Guard guard ( link->mutex );
+      if ( 0x0 != link->queue )
+      {
+        link->queue->add ( next );
+        continue;
+      }
+    }
+
+    next->cancel();
+    this->_finishJob ( *next );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Execute the job. Returns how it ended.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Metrics::Outcome Queue::_executeJob ( BaseJob &job )
+{
   USUL_TRY_BLOCK
   {
-    job->execute();
+    job.execute();
+    return ( ( true == job.isCancelled() ) ? Metrics::CANCELLED : Metrics::FINISHED );
   }
 
   catch ( const Usul::Exceptions::Cancelled & )
   {
-    return;
+    job.cancel();
+    return Metrics::CANCELLED;
   }
 
   catch ( const Usul::Exceptions::Restart & )
   {
-    this->add ( job );
-    return;
+    this->_restartJob ( job );
+    return Metrics::RESTARTED;
   }
 
   catch ( const Usul::Exceptions::Error &e )
   {
     std::cout << Usul::Strings::format ( 
       "Error ", e.id(), " caught while running job ", 
-      job->id(), ", thread ", Usul::Threads::currentThreadId(), ", ", 
+      job.id(), ", thread ", Usul::Threads::currentThreadId(), ", ", 
       e.message(), '\n' ) << std::flush;
   }
 
@@ -332,7 +933,7 @@ void Queue::_executeJob ( BaseJob::RefPtr job )
   {
     std::cout << Usul::Strings::format ( 
       "Error 8569575400: standard exception caught while running job ", 
-      job->id(), ", thread ", Usul::Threads::currentThreadId(), ", ", 
+      job.id(), ", thread ", Usul::Threads::currentThreadId(), ", ", 
       e.what(), '\n' ) << std::flush;
   }
 
@@ -340,140 +941,163 @@ void Queue::_executeJob ( BaseJob::RefPtr job )
   {
     std::cout << Usul::Strings::format ( 
       "Error 4268555760: unknown exception caught while running thread ", 
-      job->id(), ", thread ", Usul::Threads::currentThreadId(), 
+      job.id(), ", thread ", Usul::Threads::currentThreadId(), 
       '\n' ) << std::flush;
   }
+
+  return Metrics::FAILED;
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Return the number of jobs.
+//  Get a copy of the metrics. Each lane has its own, so add them up.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-unsigned int Queue::size() const
+Metrics::Snapshot Queue::metrics() const
 {
-  return _queued.size();
+  Metrics::Snapshot s;
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    s.add ( (*i)->metrics.snapshot() );
+  }
+  s.threads = this->numThreads();
+  s.depth = this->size();
+  s.running = this->numRunning();
+  return s;
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Is the queue empty?
+//  Start the metrics over.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-bool Queue::empty() const
+void Queue::metricsReset()
 {
-  return _queued.empty();
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    (*i)->metrics.reset();
+  }
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Set the sleep duration.
+//  Return the number of jobs.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Queue::sleepDurationSet ( unsigned long milliseconds )
+unsigned int Queue::size() const
 {
-  _sleep = milliseconds;
+  return _numQueued;
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Get the sleep duration.
+//  Set the sleep duration. Does nothing because the threads wait on a 
+//  condition instead.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-unsigned long Queue::sleepDurationGet() const
+void Queue::sleepDurationSet ( unsigned long )
 {
-  return _sleep;
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Wait for the job to finish.
+//  Get the sleep duration.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-bool Queue::wait ( BaseJob::RefPtr job, unsigned long s, Usul::Types::UInt64 timeout )
+unsigned long Queue::sleepDurationGet() const
 {
-  // Capture the start time.
-  const Usul::Types::UInt64 start ( Usul::System::Clock::milliseconds() );
+  return 0;
+}
 
-  // Loop until the job is done or we're out of time.
-  while ( true )
-  {
-    // If the job is not running then we're done.
-    if ( false == this->isRunning ( job ) )
-    {
-      return true;
-    }
 
-    // See if we've taken too long.
-    if ( timeout > 0 )
-    {
-      const Usul::Types::UInt64 now ( Usul::System::Clock::milliseconds() );
-      if ( ( now - start ) >= timeout )
-      {
-        return false;
-      }
-    }
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is the queue empty?
+//
+///////////////////////////////////////////////////////////////////////////////
 
-    // Sleep for a while.
-    Usul::System::Sleep::milliseconds ( s );
-  }
+bool Queue::empty() const
+{
+  return ( 0 == _numQueued );
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Is the job running?
+//  Wait for the job to finish.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-bool Queue::isRunning ( BaseJob::RefPtr job ) const
+bool Queue::wait ( BaseJob::RefPtr job, unsigned long, Usul::Types::UInt64 timeout )
 {
-  // Lock running collection and get shortcut.
-  AtomicJobSet::Guard guard ( _running.mutex() );
-  const AtomicJobSet::ValueType &r ( _running.getReference() );
+  // If the job is not running then we're done.
+  if ( ( false == job.valid() ) || ( false == this->isRunning ( job ) ) )
+  {
+    return true;
+  }
 
-  // Look for the job.
-  AtomicJobSet::ValueType::const_iterator i ( r.find ( job ) );
-  return ( r.end() != i );
+  // Block until the job signals that it finished.
+  return job->wait ( timeout );
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Add the job to the running collection.
+//  Is the job running?
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Queue::_runningJobAdd ( BaseJob::RefPtr job )
+bool Queue::isRunning ( BaseJob::RefPtr job ) const
 {
-  if ( true == job.valid() )
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
   {
-    AtomicJobSet::Guard guard ( _running.mutex() );
-    _running.getReference().insert ( job );
+    // Lock running collection and get shortcut.
+    const AtomicJobSet &running ( (*i)->running );
+    AtomicJobSet::Guard guard ( running.mutex() );
+    const JobSet &r ( running.getReference() );
+
+    // Look for the job.
+    if ( r.end() != r.find ( job ) )
+    {
+      return true;
+    }
   }
+  return false;
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Remove the job from the running collection.
+//  Remove the job from the lane's running collection.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-void Queue::_runningJobRemove ( BaseJob::RefPtr job )
+void Queue::_runningJobRemove ( const LanePtr &lane, const BaseJob::RefPtr &job )
 {
-  AtomicJobSet::Guard guard ( _running.mutex() );
-  _running.getReference().erase ( job );
+  if ( 0x0 == lane.get() )
+    return;
+
+  {
+    AtomicJobSet::Guard guard ( lane->running.mutex() );
+    lane->running.getReference().erase ( job );
+  }
+
+  // Only the destructor waits for running jobs to finish.
+  if ( true == _cancelled )
+  {
+    Guard guard ( _mutex );
+    _jobFinished.notify_all();
+  }
 }
 
 
@@ -485,8 +1109,11 @@ void Queue::_runningJobRemove ( BaseJob::RefPtr job )
 
 unsigned int Queue::numRunning() const
 {
-  AtomicJobSet::Guard guard ( _running.mutex() );
-  const unsigned int num ( _running.getReference().size() );
+  unsigned int num ( 0 );
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    num += (*i)->running.size();
+  }
   return num;
 }
 
@@ -507,33 +1134,33 @@ unsigned int Queue::numThreads() const
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  See if a higher-priority job is waiting.
+//  Does each thread have its own lane?
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-bool Queue::isHigherPriorityJobWaiting ( BaseJob::Priority priority ) const
+bool Queue::isWorkStealing() const
 {
-  // Lock the queue.
-  Threads::Guard guard ( _queued.mutex() );
+  return ( _lanes.size() > 1 );
+}
 
-  // Get a shortcut.
-  const JobSet &queued ( _queued.getReference() );
 
-  // If it's not empty...
-  if ( false == queued.empty() )
-  {
-    // Get the the next job.
-    const BaseJob::RefPtr &job ( *( queued.begin() ) );
+///////////////////////////////////////////////////////////////////////////////
+//
+//  See if a higher-priority job is waiting.
+//
+///////////////////////////////////////////////////////////////////////////////
 
-    // Make sure it is valid...
-    if ( true == job.valid() )
+bool Queue::isHigherPriorityJobWaiting ( BaseJob::Priority priority ) const
+{
+  // Each lane knows the key of its first job. A more negative key is 
+  // "higher". Compare with the key the given priority would have now.
+  const PriorityQueue::Key key ( this->_key ( priority, Usul::System::Clock::microseconds() ) );
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    const Priority first ( (*i)->first );
+    if ( first < key )
     {
-      // A more negative priority is "higher".
-      if ( job->priority() < priority )
-      {
-	// The pending job is higher priority.
-	return true;
-      }
+      return true;
     }
   }
 
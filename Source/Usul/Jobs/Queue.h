@@ -21,14 +21,24 @@
 #include "Usul/Atomic/Bool.h"
 #include "Usul/Atomic/Container.h"
 #include "Usul/Atomic/Integer.h"
+#include "Usul/Atomic/Object.h"
 #include "Usul/Base/Referenced.h"
 #include "Usul/Jobs/Job.h"
+#include "Usul/Jobs/Metrics.h"
+#include "Usul/Jobs/PriorityQueue.h"
+#include "Usul/Preprocess/Deprecated.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/Mutex.h"
 #include "Usul/Types/Types.h"
 
+#include "boost/function.hpp"
 #include "boost/noncopyable.hpp"
 #include "boost/shared_ptr.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/tss.hpp"
 
 #include <set>
+#include <utility>
 #include <vector>
 
 namespace boost { class thread; }
@@ -57,20 +67,65 @@ public:
   typedef BaseJob::Priority Priority;
   typedef std::set < BaseJob::RefPtr, BaseJob::Less > JobSet;
   typedef Usul::Atomic::Container < JobSet > AtomicJobSet;
+  typedef Usul::Atomic::Object < PriorityQueue > AtomicPriorityQueue;
+  typedef boost::condition_variable_any Condition;
+  typedef Usul::Threads::Mutex Mutex;
+  typedef Usul::Threads::Guard < Mutex > Guard;
+  typedef boost::function0 < void > Callback;
+  typedef std::pair < Usul::Types::UInt64, Usul::Types::UInt64 > RestartDelay;
 
   USUL_REFERENCED_CLASS ( Queue );
 
-  // Pass zero for use in calling thread.
-  Queue ( unsigned int numThreads );
+  // What happens to a job that has not started by its deadline.
+  enum Missed
+  {
+    MISSED_RUN,       // Run it anyway.
+    MISSED_DOWNGRADE, // Clear its deadline so that it runs after the others.
+    MISSED_DROP       // Cancel it without running it.
+  };
+
+  // Queued and running jobs. There is one lane for each thread when 
+  // work-stealing, otherwise all the threads share one lane. The first 
+  // member is the key of the lane's first job, so it can be read without 
+  // locking. The metrics are for the jobs taken from this lane.
+  struct Lane : public boost::noncopyable
+  {
+    Lane();
+    AtomicPriorityQueue queued;
+    AtomicJobSet running;
+    Usul::Atomic::Integer < Priority > first;
+    Metrics metrics;
+  };
+  typedef boost::shared_ptr < Lane > LanePtr;
+  typedef std::vector < LanePtr > Lanes;
+
+  // Pass zero for use in calling thread. When work-stealing, jobs added 
+  // from inside a job go to the calling thread's lane, and idle threads 
+  // take jobs from the other lanes. Priority is honored across lanes.
+  Queue ( unsigned int numThreads, bool workStealing = false );
 
   // Add the job.
   template < class Function > 
   BaseJob::RefPtr       add ( Function f, Priority p = 0 );
   void                  add ( BaseJob::RefPtr );
 
-  // Clear the queue. This has no effect on jobs already running.
+  // Aging makes jobs that have been queued longer come first. A job moves 
+  // ahead one priority level for every given number of milliseconds that 
+  // it waits. Zero, the default, turns aging off.
+  void                  agingSet ( Usul::Types::UInt64 milliseconds );
+  Usul::Types::UInt64   agingGet() const;
+
+  // Clear the queue. This has no effect on jobs already running. The 
+  // queued jobs are cancelled and finished, as are their successors.
   void                  clear();
 
+  // Earliest-deadline-first. When on, the jobs with a deadline come before 
+  // the others, earliest first, no matter the priority. Jobs without one 
+  // are ordered by priority as usual. When work-stealing, each lane is in 
+  // this order but the lanes are compared by priority. Off by default.
+  void                  deadlinesSet ( bool );
+  bool                  deadlinesGet() const;
+
   // Is the queue empty?
   bool                  empty() const;
 
@@ -86,15 +141,58 @@ public:
   // Is the job running?
   bool                  isRunning ( BaseJob::RefPtr ) const;
 
+  // Does each thread have its own lane?
+  bool                  isWorkStealing() const;
+
+  // Get a copy of the metrics, or start them over.
+  Metrics::Snapshot     metrics() const;
+  void                  metricsReset();
+
+  // Get/set what happens to a job that has not started by its deadline. 
+  // Only used when deadlines are on. The default is to run it anyway.
+  void                  missedSet ( Missed );
+  Missed                missedGet() const;
+
+  // Set the function that is called after a job is added. A queue without 
+  // threads can use it to know when to call executeNextJob(). It is called 
+  // in the thread that added the job, so it should not block.
+  void                  notifySet ( Callback );
+
   // Return the number of running jobs.
   unsigned int          numRunning() const;
 
   // Return the number of threads.
   unsigned int          numThreads() const;
 
-  // Remove the job from the queue. This does not cancel a running job.
+  // Change the priority of the job. If it is queued then it is moved to its 
+  // new place without being removed. Returns false if it is not queued.
+  bool                  prioritize ( BaseJob::RefPtr, Priority );
+
+  // Change the priority of all the queued jobs. The function is called 
+  // once for each job and returns the new priority. Each lane is locked 
+  // once and re-ordered in linear time, which is faster than moving the 
+  // jobs one at a time when most of them change. The lane is locked while 
+  // the function is called, so it should not use this queue.
+  template < class Function >
+  void                  prioritize ( Function f );
+
+  // Remove the job from the queue. The job is cancelled and finished so 
+  // that whoever waits on it wakes up, and its successors are cancelled. 
+  // This does not cancel a running job. Returns false if it is not queued.
   bool                  remove ( BaseJob::RefPtr );
 
+  // Get/set how long, in milliseconds, a job that throws 
+  // Usul::Exceptions::Restart waits before it is queued again. The wait 
+  // starts at the first value and doubles each time the same job restarts, 
+  // up to the second. The default is one millisecond up to one second. 
+  // A first value of zero queues it again right away.
+  void                  restartDelaySet ( const RestartDelay & );
+  RestartDelay          restartDelayGet() const;
+
+  // Change the deadline of the job. If it is queued then it is moved to its 
+  // new place without being removed. Returns false if it is not queued.
+  bool                  reschedule ( BaseJob::RefPtr, Usul::Types::UInt64 deadline );
+
   // Get the running jobs.
   template < class SetType >
   void                  running ( SetType & ) const;
@@ -102,9 +200,10 @@ public:
   // Return size of the queue.
   unsigned int          size() const;
 
-  // Set/get the sleep duration. The threads sleep and then look for a job.
-  void                  sleepDurationSet ( unsigned long milliseconds );
-  unsigned long         sleepDurationGet() const;
+  // The threads no longer sleep between jobs. Kept so that old code 
+  // compiles; setting has no effect and getting returns zero.
+  USUL_MARK_DEPRECATED_WITH_MESSAGE ( void sleepDurationSet ( unsigned long milliseconds ), "Threads no longer sleep" );
+  USUL_MARK_DEPRECATED_WITH_MESSAGE ( unsigned long sleepDurationGet() const, "Threads no longer sleep" );
 
   // Get the queued jobs.
   template < class SetType >
@@ -112,34 +211,66 @@ public:
 
   // Wait for the job to finish. Returns false if it timed out.
   // Returns true if it found and waited for the job to finish.
-  // Also returns true if it did not find the job.
+  // Also returns true if it did not find the job. The sleep duration 
+  // is no longer used because the job signals when it finishes.
   bool                  wait ( BaseJob::RefPtr, unsigned long sleepDuration = 100, Usul::Types::UInt64 timeout = 0 );
 
 protected:
 
   virtual ~Queue();
 
-  void                  _executeJob ( BaseJob::RefPtr );
+  void                  _cancelJobs ( BaseJob::JobList & );
+
+  Metrics::Outcome      _executeJob ( BaseJob & );
 
   void                  _executeNextJob();
 
-  BaseJob::RefPtr       _getNextJob();
+  void                  _finishJob ( BaseJob & );
+
+  void                  _restartJob ( BaseJob & );
+
+  PriorityQueue::Key    _key ( Priority, Usul::Types::UInt64 time ) const;
+
+  BaseJob::RefPtr       _getNextJob ( LanePtr &, Usul::Types::UInt64 &queued );
+
+  void                  _dropJob ( Lane &, BaseJob &, Usul::Types::UInt64 queued, Usul::Types::UInt64 now );
 
-  void                  _runningJobAdd ( BaseJob::RefPtr );
-  void                  _runningJobRemove ( BaseJob::RefPtr );
+  Lane &                _laneForAdd();
 
-  void                  _runThread();
+  void                  _runningJobRemove ( const LanePtr &, const BaseJob::RefPtr & );
+
+  void                  _runThread ( unsigned int index );
 
   void                  _startThreads();
 
+  void                  _updateFirst ( Lane & );
+
+  void                  _waitForJob();
+
 private:
 
+  // Removes the job from the running jobs when it goes out of scope.
+  struct RunningJob;
+
   Threads _threads;
   Usul::Atomic::Bool _started;
   Usul::Atomic::Bool _cancelled;
-  Usul::Atomic::Integer < unsigned long > _sleep;
-  AtomicJobSet _queued;
-  AtomicJobSet _running;
+  const Lanes _lanes;
+  boost::thread_specific_ptr < Lane > _currentLane;
+  Usul::Atomic::Integer < unsigned long > _nextLane;
+  Usul::Atomic::Integer < unsigned long > _numQueued;
+  Usul::Atomic::Integer < unsigned long > _numIdle;
+  mutable Mutex _mutex;
+  Condition _jobAdded;
+  Condition _jobFinished;
+  const Usul::Types::UInt64 _epoch;
+  Usul::Atomic::Integer < Usul::Types::UInt64 > _aging;
+  Usul::Atomic::Bool _deadlines;
+  Usul::Atomic::Integer < unsigned int > _missed;
+  Usul::Atomic::Object < RestartDelay > _restartDelay;
+  Usul::Atomic::Bool _hasNotify;
+  Usul::Atomic::Object < Callback > _notify;
+  const BaseJob::QueueLinkPtr _link;
 };
 
 
@@ -165,9 +296,13 @@ template < class F > BaseJob::RefPtr Queue::add ( F f, Priority p )
 
 template < class SetType > void Queue::running ( SetType &s ) const
 {
-  AtomicJobSet::Guard guard ( _running.mutex() );
-  const JobSet &jobs ( _running.getReference() );
-  s.insert ( jobs.begin(), jobs.end() );
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    const AtomicJobSet &running ( (*i)->running );
+    AtomicJobSet::Guard guard ( running.mutex() );
+    const JobSet &jobs ( running.getReference() );
+    s.insert ( jobs.begin(), jobs.end() );
+  }
 }
 
 
@@ -179,9 +314,47 @@ template < class SetType > void Queue::running ( SetType &s ) const
 
 template < class SetType > void Queue::queued ( SetType &s ) const
 {
-  AtomicJobSet::Guard guard ( _queued.mutex() );
-  const JobSet &jobs ( _queued.getReference() );
-  s.insert ( jobs.begin(), jobs.end() );
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    const AtomicPriorityQueue &queued ( (*i)->queued );
+    AtomicPriorityQueue::Guard guard ( queued.mutex() );
+    const PriorityQueue &jobs ( queued.getReference() );
+    for ( unsigned int j = 0; j < jobs.size(); ++j )
+    {
+      s.insert ( jobs.at ( j ).job );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Change the priority of all the queued jobs.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class F > void Queue::prioritize ( F f )
+{
+  for ( Lanes::const_iterator i = _lanes.begin(); i != _lanes.end(); ++i )
+  {
+    Lane &lane ( **i );
+    AtomicPriorityQueue::Guard guard ( lane.queued.mutex() );
+    PriorityQueue &jobs ( lane.queued.getReference() );
+    if ( true == jobs.empty() )
+      continue;
+
+    for ( unsigned int j = 0; j < jobs.size(); ++j )
+    {
+      const PriorityQueue::Entry &entry ( jobs.at ( j ) );
+      BaseJob::RefPtr job ( entry.job );
+      const Priority p ( f ( job ) );
+      job->_priority = p;
+      jobs.key ( j, this->_key ( p, entry.time ) );
+    }
+
+    jobs.rebuild();
+    this->_updateFirst ( lane );
+  }
 }
 
 
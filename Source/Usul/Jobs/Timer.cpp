@@ -0,0 +1,595 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Adds jobs to queues at a later time.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Config/Config.h"
+#include "Usul/Jobs/Timer.h"
+#include "Usul/Functions/NoThrow.h"
+#include "Usul/System/Clock.h"
+
+#include "boost/bind.hpp"
+#include "boost/thread/thread.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Usul::Jobs;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Initialize the singleton at startup to avoid problems with construction
+//  in multi-threaded environments.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  struct Init
+  {
+    Init()
+    {
+      Usul::Jobs::Timer::instance();
+    }
+    ~Init()
+    {
+      Usul::Jobs::Timer::destroy();
+    }
+  } _init;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Singleton instance.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Usul
+{
+  namespace Jobs
+  {
+    namespace Detail
+    {
+      Usul::Jobs::Timer *_timer ( 0x0 );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // Returned when there is nothing to wait for.
+  const Timer::UInt64 FOREVER ( std::numeric_limits < Timer::UInt64 >::max() );
+
+  // Add the job to the queue.
+  inline void add ( Queue::RefPtr queue, BaseJob::RefPtr job )
+  {
+    queue->add ( job );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Get the instance.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer &Timer::instance()
+{
+  if ( 0x0 == Usul::Jobs::Detail::_timer )
+  {
+    Usul::Jobs::Detail::_timer = new Timer();
+  }
+  return *Usul::Jobs::Detail::_timer;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destroy the single instance. Not thread safe.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::destroy()
+{
+  Timer *t ( Usul::Jobs::Detail::_timer );
+  Usul::Jobs::Detail::_timer = 0x0;
+  delete t;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Entry constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer::Entry::Entry() :
+  id ( 0 ),
+  expires ( 0 ),
+  interval ( 0 ),
+  queue(),
+  job(),
+  function(),
+  priority ( 0 )
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer::Timer() :
+  _mutex(),
+  _changed(),
+  _thread(),
+  _stop ( false ),
+  _dirty ( false ),
+  _nextId ( 0 ),
+  _current ( Timer::_now() ),
+  _live()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer::~Timer()
+{
+  USUL_TRY_BLOCK
+  {
+    // Tell the thread to stop. Set the flag while locked so that it does
+    // not miss the wake-up.
+    ThreadPtr thread;
+    {
+      Guard guard ( _mutex );
+      _stop = true;
+      _changed.notify_all();
+      thread = _thread;
+    }
+
+    if ( 0x0 != thread.get() )
+    {
+      thread->join();
+    }
+
+    // Release the queues and jobs.
+    this->clear();
+  }
+  USUL_DEFINE_CATCH_BLOCKS ( "2215638094" );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the time in milliseconds.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer::UInt64 Timer::_now()
+{
+  return ( Usul::System::Clock::microseconds() / 1000 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the job to the queue after the delay.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer::ID Timer::schedule ( Queue::RefPtr queue, BaseJob::RefPtr job, UInt64 milliseconds )
+{
+  if ( ( false == queue.valid() ) || ( false == job.valid() ) )
+    return 0;
+
+  Entry entry;
+  entry.expires = milliseconds;
+  entry.queue = queue;
+  entry.job = job;
+  return this->_add ( entry );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add a new job at every interval.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer::ID Timer::repeat ( Queue::RefPtr queue, Function f, UInt64 milliseconds, Priority p )
+{
+  if ( ( false == queue.valid() ) || ( true == f.empty() ) )
+    return 0;
+
+  Entry entry;
+  entry.expires = std::max < UInt64 > ( milliseconds, 1 );
+  entry.interval = entry.expires;
+  entry.queue = queue;
+  entry.function = f;
+  entry.priority = p;
+  return this->_add ( entry );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the entry. The expiration is the delay when passed in.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer::ID Timer::_add ( Entry &entry )
+{
+  Guard guard ( _mutex );
+
+  // When there is nothing waiting the wheels are not turning, so catch up.
+  const UInt64 now ( Timer::_now() );
+  if ( true == _live.empty() )
+  {
+    this->_clear();
+    _current = now;
+  }
+
+  entry.id = ++_nextId;
+  entry.expires += now;
+  this->_insert ( Timeout ( entry.id, entry.expires ) );
+  _live.insert ( Entries::value_type ( entry.id, entry ) );
+
+  // Start the thread the first time.
+  if ( 0x0 == _thread.get() )
+  {
+    _thread = ThreadPtr ( new boost::thread ( boost::bind ( &Timer::_run, this ) ) );
+  }
+
+  // Wake up the thread so that it sleeps for the right amount.
+  _dirty = true;
+  _changed.notify_one();
+
+  return entry.id;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel the job with the id. The entry and its references are released 
+//  now, and the id is removed from its slot when the wheel gets there.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool Timer::cancel ( ID id )
+{
+  // Release the references after unlocking, in case that deletes them.
+  Entry entry;
+  {
+    Guard guard ( _mutex );
+    Entries::iterator found ( _live.find ( id ) );
+    if ( _live.end() == found )
+      return false;
+
+    entry = found->second;
+    _live.erase ( found );
+  }
+  return true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cancel everything.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::clear()
+{
+  Guard guard ( _mutex );
+  this->_clear();
+  _changed.notify_one();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Empty the wheels. The caller has the lock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::_clear()
+{
+  _live.clear();
+  for ( unsigned int i = 0; i < FIRST_SIZE; ++i )
+  {
+    Slot().swap ( _first[i] );
+  }
+  for ( unsigned int w = 0; w < NUM_WHEELS; ++w )
+  {
+    for ( unsigned int i = 0; i < WHEEL_SIZE; ++i )
+    {
+      Slot().swap ( _wheels[w][i] );
+    }
+  }
+
+  _dirty = true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of jobs waiting to be added.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int Timer::size() const
+{
+  Guard guard ( _mutex );
+  return _live.size();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Put the entry in its slot. Entries that expire within the first wheel
+//  go in the slot for their millisecond. The others go in the wheel whose
+//  range they are in, and move down when that slot comes around. Entries
+//  past the last wheel go in the farthest slot and are placed again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::_insert ( const Timeout &timeout )
+{
+  const UInt64 expires ( std::max ( timeout.second, _current ) );
+  const UInt64 delta ( expires - _current );
+
+  if ( delta < FIRST_SIZE )
+  {
+    _first[expires & FIRST_MASK].push_back ( timeout );
+    return;
+  }
+
+  for ( unsigned int w = 0; w < NUM_WHEELS; ++w )
+  {
+    const unsigned int shift ( FIRST_BITS + w * WHEEL_BITS );
+    const UInt64 range ( static_cast < UInt64 > ( 1 ) << ( shift + WHEEL_BITS ) );
+    const bool last ( NUM_WHEELS == w + 1 );
+    if ( ( delta < range ) || ( true == last ) )
+    {
+      const UInt64 at ( ( delta < range ) ? expires : ( _current + range - 1 ) );
+      _wheels[w][( at >> shift ) & WHEEL_MASK].push_back ( timeout );
+      return;
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Move the entries in the wheel's slot down to where they belong now.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::_cascade ( unsigned int wheel, unsigned int index )
+{
+  Slot slot;
+  slot.swap ( _wheels[wheel][index] );
+
+  for ( Slot::const_iterator i = slot.begin(); i != slot.end(); ++i )
+  {
+    if ( _live.end() != _live.find ( i->first ) )
+    {
+      this->_insert ( *i );
+    }
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Handle the current millisecond and move to the next one.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::_tick ( Due &due )
+{
+  // When the first wheel comes around, move the next slot of the wheel
+  // above it down. Keep going up while those come around too.
+  const unsigned int index ( static_cast < unsigned int > ( _current & FIRST_MASK ) );
+  if ( 0 == index )
+  {
+    for ( unsigned int w = 0; w < NUM_WHEELS; ++w )
+    {
+      const unsigned int shift ( FIRST_BITS + w * WHEEL_BITS );
+      const unsigned int i ( static_cast < unsigned int > ( ( _current >> shift ) & WHEEL_MASK ) );
+      this->_cascade ( w, i );
+      if ( 0 != i )
+        break;
+    }
+  }
+
+  Slot slot;
+  slot.swap ( _first[index] );
+  ++_current;
+
+  for ( Slot::const_iterator i = slot.begin(); i != slot.end(); ++i )
+  {
+    this->_fire ( i->first, due );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The entry's time has come.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::_fire ( ID id, Due &due )
+{
+  // It may have been cancelled.
+  Entries::iterator found ( _live.find ( id ) );
+  if ( _live.end() == found )
+    return;
+
+  // Jobs that run once are done with.
+  Entry &entry ( found->second );
+  if ( 0 == entry.interval )
+  {
+    due.push_back ( Due::value_type ( entry.queue, entry.job ) );
+    _live.erase ( found );
+    return;
+  }
+
+  // Make a new job unless the last one has not finished.
+  if ( ( false == entry.job.valid() ) || ( true == entry.job->isFinished() ) )
+  {
+    entry.job = Usul::Jobs::makeJob ( entry.priority, entry.function );
+    due.push_back ( Due::value_type ( entry.queue, entry.job ) );
+  }
+
+  // Go again. If we fell behind then skip the missed times.
+  entry.expires = std::max ( entry.expires + entry.interval, _current );
+  this->_insert ( Timeout ( entry.id, entry.expires ) );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Move past the empty slots of the first wheel, up to the next slot with 
+//  something in it, the next turn of the wheel, or the slot after now.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::_skip ( UInt64 now )
+{
+  const unsigned int index ( static_cast < unsigned int > ( _current & FIRST_MASK ) );
+  const UInt64 limit ( std::min < UInt64 > ( FIRST_SIZE - index, now + 1 - _current ) );
+
+  UInt64 i ( 0 );
+  while ( ( i < limit ) && ( true == _first[index + i].empty() ) )
+  {
+    ++i;
+  }
+  _current += i;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Turn the wheels up to now. Returns how many milliseconds to sleep.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Timer::UInt64 Timer::_process ( Due &due )
+{
+  _dirty = false;
+  const UInt64 now ( Timer::_now() );
+
+  // Nothing to do until something is added.
+  if ( true == _live.empty() )
+  {
+    _current = now;
+    return Helper::FOREVER;
+  }
+
+  // Only stop at the slots with something in them and where the wheels 
+  // come around, so catching up is not one step per millisecond.
+  while ( _current <= now )
+  {
+    if ( 0 != ( _current & FIRST_MASK ) )
+    {
+      this->_skip ( now );
+      if ( _current > now )
+        break;
+    }
+    this->_tick ( due );
+  }
+
+  if ( false == due.empty() )
+    return 0;
+
+  // Sleep until the next slot with something in it, or until the first
+  // wheel comes around.
+  const unsigned int index ( static_cast < unsigned int > ( _current & FIRST_MASK ) );
+  UInt64 wake ( _current );
+  if ( 0 != index )
+  {
+    unsigned int i ( index );
+    while ( ( i < FIRST_SIZE ) && ( true == _first[i].empty() ) )
+    {
+      ++i;
+    }
+    wake += ( i - index );
+  }
+
+  return ( ( wake > now ) ? ( wake - now ) : 0 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The thread's function.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void Timer::_run()
+{
+  while ( true )
+  {
+    Due due;
+    UInt64 sleep ( 0 );
+    {
+      Guard guard ( _mutex );
+      if ( true == _stop )
+        return;
+      sleep = this->_process ( due );
+    }
+
+    // Add the jobs without the lock because adding may start threads.
+    for ( Due::iterator i = due.begin(); i != due.end(); ++i )
+    {
+      Usul::Functions::noThrow ( boost::bind ( &Helper::add, i->first, i->second ), "1394862070" );
+    }
+    if ( false == due.empty() )
+      continue;
+
+    // Sleep unless something changed since we looked.
+    Guard guard ( _mutex );
+    if ( ( true == _stop ) || ( true == _dirty ) )
+      continue;
+
+    if ( Helper::FOREVER == sleep )
+    {
+      _changed.wait ( _mutex );
+    }
+    else
+    {
+      // Wait for a duration rather than until a system time, so that 
+      // changing the system time does not change how long we sleep.
+      _changed.timed_wait ( _mutex, 
+        boost::posix_time::milliseconds ( static_cast < long > ( sleep ) ) );
+    }
+  }
+}
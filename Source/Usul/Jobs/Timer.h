@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Adds jobs to queues at a later time, once or at an interval. The times
+//  are kept in a hierarchical timer wheel with a resolution of one
+//  millisecond, and the entries in a hash table by id, so adding and 
+//  cancelling is constant time on average. One thread sleeps until the 
+//  next job is due.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_JOBS_TIMER_H_
+#define _USUL_JOBS_TIMER_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/Jobs/Queue.h"
+#include "Usul/Threads/Guard.h"
+#include "Usul/Threads/Mutex.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/function.hpp"
+#include "boost/noncopyable.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/unordered_map.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace boost { class thread; }
+
+
+namespace Usul {
+namespace Jobs {
+
+
+class USUL_EXPORT Timer : public boost::noncopyable
+{
+public:
+
+  typedef Usul::Types::UInt64 UInt64;
+  typedef UInt64 ID;
+  typedef BaseJob::Priority Priority;
+  typedef boost::function1 < void, BaseJob::RefPtr > Function;
+  typedef Usul::Threads::Mutex Mutex;
+  typedef Usul::Threads::Guard < Mutex > Guard;
+
+  // Singleton interface.
+  static Timer &        instance();
+  static void           destroy();
+
+  // Cancel the job with the id and release its queue and job. Returns false 
+  // if it already went to its queue or there is no such id. Jobs already 
+  // added are not cancelled.
+  bool                  cancel ( ID );
+
+  // Cancel everything.
+  void                  clear();
+
+  // Every interval, add a new job to the queue that calls the function.
+  // A new job is not added while the last one is still queued or running.
+  // The first one is added after one interval.
+  ID                    repeat ( Queue::RefPtr, Function, UInt64 milliseconds, Priority p = 0 );
+
+  // Add the job to the queue after the delay.
+  ID                    schedule ( Queue::RefPtr, BaseJob::RefPtr, UInt64 milliseconds );
+
+  // Return the number of jobs waiting to be added.
+  unsigned int          size() const;
+
+private:
+
+  struct Entry
+  {
+    Entry();
+    ID id;
+    UInt64 expires;
+    UInt64 interval;
+    Queue::RefPtr queue;
+    BaseJob::RefPtr job;
+    Function function;
+    Priority priority;
+  };
+  typedef boost::unordered_map < ID, Entry > Entries;
+
+  // The slots only hold the ids and times. Cancelled ids are skipped.
+  typedef std::pair < ID, UInt64 > Timeout;
+  typedef std::vector < Timeout > Slot;
+  typedef std::vector < std::pair < Queue::RefPtr, BaseJob::RefPtr > > Due;
+  typedef boost::shared_ptr < boost::thread > ThreadPtr;
+
+  // The first wheel has a slot for each millisecond. Each of the others
+  // has slots as long as the whole wheel before it.
+  enum
+  {
+    FIRST_BITS = 8,
+    FIRST_SIZE = 1 << FIRST_BITS,
+    FIRST_MASK = FIRST_SIZE - 1,
+    WHEEL_BITS = 6,
+    WHEEL_SIZE = 1 << WHEEL_BITS,
+    WHEEL_MASK = WHEEL_SIZE - 1,
+    NUM_WHEELS = 3
+  };
+
+  Timer();
+  ~Timer();
+
+  ID                    _add ( Entry & );
+
+  void                  _cascade ( unsigned int wheel, unsigned int index );
+
+  void                  _clear();
+
+  void                  _fire ( ID, Due & );
+
+  void                  _insert ( const Timeout & );
+
+  static UInt64         _now();
+
+  UInt64                _process ( Due & );
+
+  void                  _run();
+
+  void                  _skip ( UInt64 now );
+
+  void                  _tick ( Due & );
+
+  mutable Mutex _mutex;
+  boost::condition_variable_any _changed;
+  ThreadPtr _thread;
+  bool _stop;
+  bool _dirty;
+  ID _nextId;
+  UInt64 _current;
+  Entries _live;
+  Slot _first[FIRST_SIZE];
+  Slot _wheels[NUM_WHEELS][WHEEL_SIZE];
+};
+
+
+} // namespace Jobs
+} // namespace Usul
+
+
+#endif // _USUL_JOBS_TIMER_H_
@@ -229,24 +229,28 @@ public:
 
   template < class MatrixType > Box transform ( const MatrixType &m ) const
   {
-    // Transform the eight corners.
-    const Vector c1 ( m * Vector ( _min[0], _min[1], _min[2] ) );
-    const Vector c2 ( m * Vector ( _max[0], _min[1], _min[2] ) );
-    const Vector c3 ( m * Vector ( _max[0], _max[1], _min[2] ) );
-    const Vector c4 ( m * Vector ( _min[0], _max[1], _min[2] ) );
-    const Vector c5 ( m * Vector ( _min[0], _min[1], _max[2] ) );
-    const Vector c6 ( m * Vector ( _max[0], _min[1], _max[2] ) );
-    const Vector c7 ( m * Vector ( _max[0], _max[1], _max[2] ) );
-    const Vector c8 ( m * Vector ( _min[0], _max[1], _max[2] ) );
+    // Transform the eight corners together.
+    Vector c[8] =
+    {
+      Vector ( _min[0], _min[1], _min[2] ),
+      Vector ( _max[0], _min[1], _min[2] ),
+      Vector ( _max[0], _max[1], _min[2] ),
+      Vector ( _min[0], _max[1], _min[2] ),
+      Vector ( _min[0], _min[1], _max[2] ),
+      Vector ( _max[0], _min[1], _max[2] ),
+      Vector ( _max[0], _max[1], _max[2] ),
+      Vector ( _min[0], _max[1], _max[2] )
+    };
+    m.transform ( c, 8, c );
 
     // Build up the new bounding box.
-    Box b ( c1, c2 );
-    b = Box::bounds ( b, c3 );
-    b = Box::bounds ( b, c4 );
-    b = Box::bounds ( b, c5 );
-    b = Box::bounds ( b, c6 );
-    b = Box::bounds ( b, c7 );
-    b = Box::bounds ( b, c8 );
+    Box b ( c[0], c[1] );
+    b = Box::bounds ( b, c[2] );
+    b = Box::bounds ( b, c[3] );
+    b = Box::bounds ( b, c[4] );
+    b = Box::bounds ( b, c[5] );
+    b = Box::bounds ( b, c[6] );
+    b = Box::bounds ( b, c[7] );
 
     // Return new bounding box.
     return b;
@@ -28,11 +28,431 @@
 #include "Usul/Math/Vector3.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <stdexcept>
 
+#ifdef USUL_HAS_AVX
+# include <immintrin.h>
+#elif defined ( USUL_HAS_SSE2 )
+# include <emmintrin.h>
+#endif
+
 
 namespace Usul {
 namespace Math {
+namespace Detail {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Kernels that work on the arrays of 16, in the order described above.
+//  The answer can be the same array as the input.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Multiply, c = a * b.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > inline void multiply44 ( const T *a, const T *b, T *c )
+{
+  T r[16];
+  for ( unsigned int j = 0; j < 16; j += 4 )
+  {
+    r[j]     = a[0] * b[j] + a[4] * b[j + 1] + a[8]  * b[j + 2] + a[12] * b[j + 3];
+    r[j + 1] = a[1] * b[j] + a[5] * b[j + 1] + a[9]  * b[j + 2] + a[13] * b[j + 3];
+    r[j + 2] = a[2] * b[j] + a[6] * b[j + 1] + a[10] * b[j + 2] + a[14] * b[j + 3];
+    r[j + 3] = a[3] * b[j] + a[7] * b[j + 1] + a[11] * b[j + 2] + a[15] * b[j + 3];
+  }
+  std::copy ( r, r + 16, c );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Invert using the 2x2 sub-determinants so that each one is only found
+//  once. Returns false if the determinant is zero.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > inline bool inverse44 ( const T *a, T *answer )
+{
+  const T s0 ( a[0] * a[5] - a[4] * a[1] );
+  const T s1 ( a[0] * a[6] - a[4] * a[2] );
+  const T s2 ( a[0] * a[7] - a[4] * a[3] );
+  const T s3 ( a[1] * a[6] - a[5] * a[2] );
+  const T s4 ( a[1] * a[7] - a[5] * a[3] );
+  const T s5 ( a[2] * a[7] - a[6] * a[3] );
+
+  const T c5 ( a[10] * a[15] - a[14] * a[11] );
+  const T c4 ( a[9]  * a[15] - a[13] * a[11] );
+  const T c3 ( a[9]  * a[14] - a[13] * a[10] );
+  const T c2 ( a[8]  * a[15] - a[12] * a[11] );
+  const T c1 ( a[8]  * a[14] - a[12] * a[10] );
+  const T c0 ( a[8]  * a[13] - a[12] * a[9]  );
+
+  const T d ( s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0 );
+  if ( 0 == d )
+    return false;
+
+  const T s ( static_cast < T > ( 1 ) / d );
+  T r[16];
+
+  r[0]  = (  a[5]  * c5 - a[6]  * c4 + a[7]  * c3 ) * s;
+  r[1]  = ( -a[1]  * c5 + a[2]  * c4 - a[3]  * c3 ) * s;
+  r[2]  = (  a[13] * s5 - a[14] * s4 + a[15] * s3 ) * s;
+  r[3]  = ( -a[9]  * s5 + a[10] * s4 - a[11] * s3 ) * s;
+
+  r[4]  = ( -a[4]  * c5 + a[6]  * c2 - a[7]  * c1 ) * s;
+  r[5]  = (  a[0]  * c5 - a[2]  * c2 + a[3]  * c1 ) * s;
+  r[6]  = ( -a[12] * s5 + a[14] * s2 - a[15] * s1 ) * s;
+  r[7]  = (  a[8]  * s5 - a[10] * s2 + a[11] * s1 ) * s;
+
+  r[8]  = (  a[4]  * c4 - a[5]  * c2 + a[7]  * c0 ) * s;
+  r[9]  = ( -a[0]  * c4 + a[1]  * c2 - a[3]  * c0 ) * s;
+  r[10] = (  a[12] * s4 - a[13] * s2 + a[15] * s0 ) * s;
+  r[11] = ( -a[8]  * s4 + a[9]  * s2 - a[11] * s0 ) * s;
+
+  r[12] = ( -a[4]  * c3 + a[5]  * c1 - a[6]  * c0 ) * s;
+  r[13] = (  a[0]  * c3 - a[1]  * c1 + a[2]  * c0 ) * s;
+  r[14] = ( -a[12] * s3 + a[13] * s1 - a[14] * s0 ) * s;
+  r[15] = (  a[8]  * s3 - a[9]  * s1 + a[10] * s0 ) * s;
+
+  std::copy ( r, r + 16, answer );
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Transform the points like the operator for a 3D vector does, with the
+//  divide by w.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T, class Vector3_ > inline void transform44 ( const T *m, const Vector3_ *points, std::size_t count, Vector3_ *answer )
+{
+  for ( std::size_t i = 0; i < count; ++i )
+  {
+    const T x ( points[i][0] );
+    const T y ( points[i][1] );
+    const T z ( points[i][2] );
+    const T w ( static_cast < T > ( 1 ) / ( m[3] * x + m[7] * y + m[11] * z + m[15] ) );
+    answer[i][0] = w * ( m[0] * x + m[4] * y + m[8]  * z + m[12] );
+    answer[i][1] = w * ( m[1] * x + m[5] * y + m[9]  * z + m[13] );
+    answer[i][2] = w * ( m[2] * x + m[6] * y + m[10] * z + m[14] );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The kernels used by the matrix. Specialized for SIMD below.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class T > struct Matrix44Kernels
+{
+  static void multiply ( const T *a, const T *b, T *c )
+  {
+    Detail::multiply44 ( a, b, c );
+  }
+  static bool inverse ( const T *a, T *answer )
+  {
+    return Detail::inverse44 ( a, answer );
+  }
+  template < class Vector3_ > static void transform ( const T *m, const Vector3_ *points, std::size_t count, Vector3_ *answer )
+  {
+    Detail::transform44 ( m, points, count, answer );
+  }
+};
+
+
+#ifdef USUL_HAS_SSE2
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  SSE kernels for float. Each column is one register. The sums are added
+//  in the same order as the plain code.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template <> struct Matrix44Kernels < float >
+{
+  static void multiply ( const float *a, const float *b, float *c )
+  {
+    const __m128 a0 ( _mm_loadu_ps ( a ) );
+    const __m128 a1 ( _mm_loadu_ps ( a + 4 ) );
+    const __m128 a2 ( _mm_loadu_ps ( a + 8 ) );
+    const __m128 a3 ( _mm_loadu_ps ( a + 12 ) );
+
+    __m128 r[4];
+    for ( unsigned int j = 0; j < 4; ++j )
+    {
+      const float *bj ( b + j * 4 );
+      r[j] = _mm_add_ps ( _mm_add_ps ( _mm_add_ps (
+        _mm_mul_ps ( a0, _mm_set1_ps ( bj[0] ) ),
+        _mm_mul_ps ( a1, _mm_set1_ps ( bj[1] ) ) ),
+        _mm_mul_ps ( a2, _mm_set1_ps ( bj[2] ) ) ),
+        _mm_mul_ps ( a3, _mm_set1_ps ( bj[3] ) ) );
+    }
+
+    _mm_storeu_ps ( c,      r[0] );
+    _mm_storeu_ps ( c + 4,  r[1] );
+    _mm_storeu_ps ( c + 8,  r[2] );
+    _mm_storeu_ps ( c + 12, r[3] );
+  }
+
+  // Splits the matrix into 2x2 blocks and inverts it with them. Each block
+  // is one register, stored as row-major 2x2. The columns are treated as
+  // rows, which is fine because the inverse of the transpose is the
+  // transpose of the inverse.
+  // See: https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+  static bool inverse ( const float *m, float *answer )
+  {
+    const __m128 m0 ( _mm_loadu_ps ( m ) );
+    const __m128 m1 ( _mm_loadu_ps ( m + 4 ) );
+    const __m128 m2 ( _mm_loadu_ps ( m + 8 ) );
+    const __m128 m3 ( _mm_loadu_ps ( m + 12 ) );
+
+    const __m128 A ( _mm_movelh_ps ( m0, m1 ) );
+    const __m128 B ( _mm_movehl_ps ( m1, m0 ) );
+    const __m128 C ( _mm_movelh_ps ( m2, m3 ) );
+    const __m128 D ( _mm_movehl_ps ( m3, m2 ) );
+
+    // The determinants of the blocks as ( |A| |B| |C| |D| ).
+    const __m128 detSub ( _mm_sub_ps (
+      _mm_mul_ps ( _mm_shuffle_ps ( m0, m2, _MM_SHUFFLE ( 2, 0, 2, 0 ) ), _mm_shuffle_ps ( m1, m3, _MM_SHUFFLE ( 3, 1, 3, 1 ) ) ),
+      _mm_mul_ps ( _mm_shuffle_ps ( m0, m2, _MM_SHUFFLE ( 3, 1, 3, 1 ) ), _mm_shuffle_ps ( m1, m3, _MM_SHUFFLE ( 2, 0, 2, 0 ) ) ) ) );
+    const __m128 detA ( _mm_shuffle_ps ( detSub, detSub, _MM_SHUFFLE ( 0, 0, 0, 0 ) ) );
+    const __m128 detB ( _mm_shuffle_ps ( detSub, detSub, _MM_SHUFFLE ( 1, 1, 1, 1 ) ) );
+    const __m128 detC ( _mm_shuffle_ps ( detSub, detSub, _MM_SHUFFLE ( 2, 2, 2, 2 ) ) );
+    const __m128 detD ( _mm_shuffle_ps ( detSub, detSub, _MM_SHUFFLE ( 3, 3, 3, 3 ) ) );
+
+    // Adjugate products D#C and A#B.
+    const __m128 DC ( _adjugateMultiply ( D, C ) );
+    const __m128 AB ( _adjugateMultiply ( A, B ) );
+
+    // The blocks of the adjugate.
+    __m128 X ( _mm_sub_ps ( _mm_mul_ps ( detD, A ), _multiply ( B, DC ) ) );
+    __m128 W ( _mm_sub_ps ( _mm_mul_ps ( detA, D ), _multiply ( C, AB ) ) );
+    __m128 Y ( _mm_sub_ps ( _mm_mul_ps ( detB, C ), _multiplyAdjugate ( D, AB ) ) );
+    __m128 Z ( _mm_sub_ps ( _mm_mul_ps ( detC, B ), _multiplyAdjugate ( A, DC ) ) );
+
+    // |M| = |A||D| + |B||C| - trace ( ( A#B ) ( D#C ) )
+    __m128 trace ( _mm_mul_ps ( AB, _mm_shuffle_ps ( DC, DC, _MM_SHUFFLE ( 3, 1, 2, 0 ) ) ) );
+    trace = _mm_add_ps ( trace, _mm_shuffle_ps ( trace, trace, _MM_SHUFFLE ( 1, 0, 3, 2 ) ) );
+    trace = _mm_add_ps ( trace, _mm_shuffle_ps ( trace, trace, _MM_SHUFFLE ( 2, 3, 0, 1 ) ) );
+    const __m128 det ( _mm_sub_ps ( _mm_add_ps ( _mm_mul_ps ( detA, detD ), _mm_mul_ps ( detB, detC ) ), trace ) );
+
+    if ( 0 == _mm_cvtss_f32 ( det ) )
+      return false;
+
+    const __m128 scale ( _mm_div_ps ( _mm_setr_ps ( 1.0f, -1.0f, -1.0f, 1.0f ), det ) );
+    X = _mm_mul_ps ( X, scale );
+    Y = _mm_mul_ps ( Y, scale );
+    Z = _mm_mul_ps ( Z, scale );
+    W = _mm_mul_ps ( W, scale );
+
+    // Take the adjugate of each block while putting them back together.
+    _mm_storeu_ps ( answer,      _mm_shuffle_ps ( X, Y, _MM_SHUFFLE ( 1, 3, 1, 3 ) ) );
+    _mm_storeu_ps ( answer + 4,  _mm_shuffle_ps ( X, Y, _MM_SHUFFLE ( 0, 2, 0, 2 ) ) );
+    _mm_storeu_ps ( answer + 8,  _mm_shuffle_ps ( Z, W, _MM_SHUFFLE ( 1, 3, 1, 3 ) ) );
+    _mm_storeu_ps ( answer + 12, _mm_shuffle_ps ( Z, W, _MM_SHUFFLE ( 0, 2, 0, 2 ) ) );
+    return true;
+  }
+
+  template < class Vector3_ > static void transform ( const float *m, const Vector3_ *points, std::size_t count, Vector3_ *answer )
+  {
+    const __m128 m0 ( _mm_loadu_ps ( m ) );
+    const __m128 m1 ( _mm_loadu_ps ( m + 4 ) );
+    const __m128 m2 ( _mm_loadu_ps ( m + 8 ) );
+    const __m128 m3 ( _mm_loadu_ps ( m + 12 ) );
+    const __m128 one ( _mm_set1_ps ( 1.0f ) );
+
+    float r[4];
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+      __m128 v ( _mm_add_ps ( _mm_add_ps ( _mm_add_ps (
+        _mm_mul_ps ( m0, _mm_set1_ps ( points[i][0] ) ),
+        _mm_mul_ps ( m1, _mm_set1_ps ( points[i][1] ) ) ),
+        _mm_mul_ps ( m2, _mm_set1_ps ( points[i][2] ) ) ),
+        m3 ) );
+      v = _mm_mul_ps ( v, _mm_div_ps ( one, _mm_shuffle_ps ( v, v, _MM_SHUFFLE ( 3, 3, 3, 3 ) ) ) );
+      _mm_storeu_ps ( r, v );
+      answer[i][0] = r[0];
+      answer[i][1] = r[1];
+      answer[i][2] = r[2];
+    }
+  }
+
+private:
+
+  // 2x2 row-major a * b.
+  static __m128 _multiply ( __m128 a, __m128 b )
+  {
+    return _mm_add_ps (
+      _mm_mul_ps ( a, _mm_shuffle_ps ( b, b, _MM_SHUFFLE ( 3, 0, 3, 0 ) ) ),
+      _mm_mul_ps ( _mm_shuffle_ps ( a, a, _MM_SHUFFLE ( 2, 3, 0, 1 ) ), _mm_shuffle_ps ( b, b, _MM_SHUFFLE ( 1, 2, 1, 2 ) ) ) );
+  }
+
+  // 2x2 row-major adjugate ( a ) * b.
+  static __m128 _adjugateMultiply ( __m128 a, __m128 b )
+  {
+    return _mm_sub_ps (
+      _mm_mul_ps ( _mm_shuffle_ps ( a, a, _MM_SHUFFLE ( 0, 0, 3, 3 ) ), b ),
+      _mm_mul_ps ( _mm_shuffle_ps ( a, a, _MM_SHUFFLE ( 2, 2, 1, 1 ) ), _mm_shuffle_ps ( b, b, _MM_SHUFFLE ( 1, 0, 3, 2 ) ) ) );
+  }
+
+  // 2x2 row-major a * adjugate ( b ).
+  static __m128 _multiplyAdjugate ( __m128 a, __m128 b )
+  {
+    return _mm_sub_ps (
+      _mm_mul_ps ( a, _mm_shuffle_ps ( b, b, _MM_SHUFFLE ( 0, 3, 0, 3 ) ) ),
+      _mm_mul_ps ( _mm_shuffle_ps ( a, a, _MM_SHUFFLE ( 2, 3, 0, 1 ) ), _mm_shuffle_ps ( b, b, _MM_SHUFFLE ( 1, 2, 1, 2 ) ) ) );
+  }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  SIMD kernels for double. With AVX each column is one register, and with
+//  SSE2 it is two. The inverse is the plain one.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template <> struct Matrix44Kernels < double >
+{
+  #ifdef USUL_HAS_AVX
+
+  static void multiply ( const double *a, const double *b, double *c )
+  {
+    const __m256d a0 ( _mm256_loadu_pd ( a ) );
+    const __m256d a1 ( _mm256_loadu_pd ( a + 4 ) );
+    const __m256d a2 ( _mm256_loadu_pd ( a + 8 ) );
+    const __m256d a3 ( _mm256_loadu_pd ( a + 12 ) );
+
+    __m256d r[4];
+    for ( unsigned int j = 0; j < 4; ++j )
+    {
+      const double *bj ( b + j * 4 );
+      r[j] = _mm256_add_pd ( _mm256_add_pd ( _mm256_add_pd (
+        _mm256_mul_pd ( a0, _mm256_set1_pd ( bj[0] ) ),
+        _mm256_mul_pd ( a1, _mm256_set1_pd ( bj[1] ) ) ),
+        _mm256_mul_pd ( a2, _mm256_set1_pd ( bj[2] ) ) ),
+        _mm256_mul_pd ( a3, _mm256_set1_pd ( bj[3] ) ) );
+    }
+
+    _mm256_storeu_pd ( c,      r[0] );
+    _mm256_storeu_pd ( c + 4,  r[1] );
+    _mm256_storeu_pd ( c + 8,  r[2] );
+    _mm256_storeu_pd ( c + 12, r[3] );
+  }
+
+  template < class Vector3_ > static void transform ( const double *m, const Vector3_ *points, std::size_t count, Vector3_ *answer )
+  {
+    const __m256d m0 ( _mm256_loadu_pd ( m ) );
+    const __m256d m1 ( _mm256_loadu_pd ( m + 4 ) );
+    const __m256d m2 ( _mm256_loadu_pd ( m + 8 ) );
+    const __m256d m3 ( _mm256_loadu_pd ( m + 12 ) );
+    const __m256d one ( _mm256_set1_pd ( 1.0 ) );
+
+    double r[4];
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+      __m256d v ( _mm256_add_pd ( _mm256_add_pd ( _mm256_add_pd (
+        _mm256_mul_pd ( m0, _mm256_set1_pd ( points[i][0] ) ),
+        _mm256_mul_pd ( m1, _mm256_set1_pd ( points[i][1] ) ) ),
+        _mm256_mul_pd ( m2, _mm256_set1_pd ( points[i][2] ) ) ),
+        m3 ) );
+      const __m128d hi ( _mm256_extractf128_pd ( v, 1 ) );
+      const __m128d w ( _mm_unpackhi_pd ( hi, hi ) );
+      v = _mm256_mul_pd ( v, _mm256_div_pd ( one, _mm256_insertf128_pd ( _mm256_castpd128_pd256 ( w ), w, 1 ) ) );
+      _mm256_storeu_pd ( r, v );
+      answer[i][0] = r[0];
+      answer[i][1] = r[1];
+      answer[i][2] = r[2];
+    }
+  }
+
+  #else
+
+  static void multiply ( const double *a, const double *b, double *c )
+  {
+    // The low half of each column is rows 0-1 and the high half is rows 2-3.
+    __m128d lo[4];
+    __m128d hi[4];
+    for ( unsigned int k = 0; k < 4; ++k )
+    {
+      lo[k] = _mm_loadu_pd ( a + k * 4 );
+      hi[k] = _mm_loadu_pd ( a + k * 4 + 2 );
+    }
+
+    __m128d r[8];
+    for ( unsigned int j = 0; j < 4; ++j )
+    {
+      const double *bj ( b + j * 4 );
+      const __m128d b0 ( _mm_set1_pd ( bj[0] ) );
+      const __m128d b1 ( _mm_set1_pd ( bj[1] ) );
+      const __m128d b2 ( _mm_set1_pd ( bj[2] ) );
+      const __m128d b3 ( _mm_set1_pd ( bj[3] ) );
+      r[j * 2] = _mm_add_pd ( _mm_add_pd ( _mm_add_pd (
+        _mm_mul_pd ( lo[0], b0 ), _mm_mul_pd ( lo[1], b1 ) ), _mm_mul_pd ( lo[2], b2 ) ), _mm_mul_pd ( lo[3], b3 ) );
+      r[j * 2 + 1] = _mm_add_pd ( _mm_add_pd ( _mm_add_pd (
+        _mm_mul_pd ( hi[0], b0 ), _mm_mul_pd ( hi[1], b1 ) ), _mm_mul_pd ( hi[2], b2 ) ), _mm_mul_pd ( hi[3], b3 ) );
+    }
+
+    for ( unsigned int i = 0; i < 8; ++i )
+    {
+      _mm_storeu_pd ( c + i * 2, r[i] );
+    }
+  }
+
+  template < class Vector3_ > static void transform ( const double *m, const Vector3_ *points, std::size_t count, Vector3_ *answer )
+  {
+    __m128d lo[4];
+    __m128d hi[4];
+    for ( unsigned int k = 0; k < 4; ++k )
+    {
+      lo[k] = _mm_loadu_pd ( m + k * 4 );
+      hi[k] = _mm_loadu_pd ( m + k * 4 + 2 );
+    }
+    const __m128d one ( _mm_set1_pd ( 1.0 ) );
+
+    double r[4];
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+      const __m128d x ( _mm_set1_pd ( points[i][0] ) );
+      const __m128d y ( _mm_set1_pd ( points[i][1] ) );
+      const __m128d z ( _mm_set1_pd ( points[i][2] ) );
+      const __m128d vlo ( _mm_add_pd ( _mm_add_pd ( _mm_add_pd (
+        _mm_mul_pd ( lo[0], x ), _mm_mul_pd ( lo[1], y ) ), _mm_mul_pd ( lo[2], z ) ), lo[3] ) );
+      const __m128d vhi ( _mm_add_pd ( _mm_add_pd ( _mm_add_pd (
+        _mm_mul_pd ( hi[0], x ), _mm_mul_pd ( hi[1], y ) ), _mm_mul_pd ( hi[2], z ) ), hi[3] ) );
+      const __m128d w ( _mm_div_pd ( one, _mm_unpackhi_pd ( vhi, vhi ) ) );
+      _mm_storeu_pd ( r,     _mm_mul_pd ( vlo, w ) );
+      _mm_storeu_pd ( r + 2, _mm_mul_pd ( vhi, w ) );
+      answer[i][0] = r[0];
+      answer[i][1] = r[1];
+      answer[i][2] = r[2];
+    }
+  }
+
+  #endif
+
+  static bool inverse ( const double *a, double *answer )
+  {
+    return Detail::inverse44 ( a, answer );
+  }
+};
+
+
+#endif // USUL_HAS_SSE2
+
+
+} // namespace Detail
 
 
 template
@@ -336,35 +756,7 @@ public:
 
   bool inverse ( ThisType &m ) const
   {
-    T d = this->determinant();
-
-    if ( 0 == d ) 
-      return false;
-
-    m[0]  =   this->_determinant3x3 ( 1, 2, 3, 1, 2, 3 );
-    m[4]  = - this->_determinant3x3 ( 1, 2, 3, 0, 2, 3 );
-    m[8]  =   this->_determinant3x3 ( 1, 2, 3, 0, 1, 3 );
-    m[12] = - this->_determinant3x3 ( 1, 2, 3, 0, 1, 2 );
-
-    m[1]  = - this->_determinant3x3 ( 0, 2, 3, 1, 2, 3 );
-    m[5]  =   this->_determinant3x3 ( 0, 2, 3, 0, 2, 3 );
-    m[9]  = - this->_determinant3x3 ( 0, 2, 3, 0, 1, 3 );
-    m[13] =   this->_determinant3x3 ( 0, 2, 3, 0, 1, 2 );
-
-    m[2]  =   this->_determinant3x3 ( 0, 1, 3, 1, 2, 3 );
-    m[6]  = - this->_determinant3x3 ( 0, 1, 3, 0, 2, 3 );
-    m[10] =   this->_determinant3x3 ( 0, 1, 3, 0, 1, 3 );
-    m[14] = - this->_determinant3x3 ( 0, 1, 3, 0, 1, 2 );
-
-    m[3]  = - this->_determinant3x3 ( 0, 1, 2, 1, 2, 3 );
-    m[7]  =   this->_determinant3x3 ( 0, 1, 2, 0, 2, 3 );
-    m[11] = - this->_determinant3x3 ( 0, 1, 2, 0, 1, 3 );
-    m[15] =   this->_determinant3x3 ( 0, 1, 2, 0, 1, 2 );
-
-    m.transpose();
-    m /= d;
-
-    return true;
+    return Detail::Matrix44Kernels<T>::inverse ( _m, m._m );
   }
 
 
@@ -516,6 +908,19 @@ public:
     c[15] = a[3] * b[12] + a[7] * b[13] + a[11] * b[14] + a[15] * b[15];
   }
 
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Multiply, c = a * b. This one uses the SIMD kernels when it can.
+  //  The answer can be one of the inputs.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  static void multiply ( const ThisType &a, const ThisType &b, ThisType &c )
+  {
+    Detail::Matrix44Kernels<T>::multiply ( a._m, b._m, c._m );
+  }
+
   
   /////////////////////////////////////////////////////////////////////////////
   //
@@ -530,6 +935,10 @@ public:
     multiply ( m, _m, a );
     this->set ( a );
   }
+  void preMultiply ( const ThisType &m )
+  {
+    multiply ( m, *this, *this );
+  }
 
 
   /////////////////////////////////////////////////////////////////////////////
@@ -545,6 +954,23 @@ public:
     multiply ( _m, m, a );
     this->set ( a );
   }
+  void postMultiply ( const ThisType &m )
+  {
+    multiply ( *this, m, *this );
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Transform the points like multiplying each one by this matrix does.
+  //  The answer can be the same array as the points.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  template < class Vector3_ > void transform ( const Vector3_ *points, std::size_t count, Vector3_ *answer ) const
+  {
+    Detail::Matrix44Kernels<T>::transform ( _m, points, count, answer );
+  }
 
 
   /////////////////////////////////////////////////////////////////////////////
@@ -98,6 +98,40 @@ public:
   }
 
 
+#ifdef USUL_HAS_RVALUE_REFERENCES
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Move constructor.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  QueryPointer ( QueryPointer &&ptr ) USUL_NO_THROW : BaseClass ( USUL_MOVE ( static_cast < BaseClass & > ( ptr ) ) )
+  {
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Copy and move assignment. Declaring the move constructor means that the 
+  //  compiler no longer writes the copy assignment for us.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  QueryPointer &operator = ( const QueryPointer &ptr )
+  {
+    BaseClass::operator = ( ptr );
+    return *this;
+  }
+  QueryPointer &operator = ( QueryPointer &&ptr ) USUL_NO_THROW
+  {
+    BaseClass::operator = ( USUL_MOVE ( static_cast < BaseClass & > ( ptr ) ) );
+    return *this;
+  }
+
+#endif
+
+
   /////////////////////////////////////////////////////////////////////////////
   //
   //  Assignment from another smart-pointer (the base class).
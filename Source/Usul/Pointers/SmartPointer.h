@@ -124,6 +124,23 @@ struct SmartPointer
   }
 
 
+#ifdef USUL_HAS_RVALUE_REFERENCES
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Move constructor. Takes the reference, so the count does not change.
+  //  The other pointer is left null, which is not checked.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  SmartPointer ( ThisType &&p ) USUL_NO_THROW : _p ( p._p )
+  {
+    p._p = 0x0;
+  }
+
+#endif
+
+
   /////////////////////////////////////////////////////////////////////////////
   //
   //  Destructor.
@@ -214,6 +231,47 @@ struct SmartPointer
     return *this;
   }
 
+#ifdef USUL_HAS_RVALUE_REFERENCES
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Move assignment. Takes the reference and leaves the other pointer null.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  ThisType &operator = ( ThisType &&p ) USUL_NO_THROW
+  {
+    if ( this != &p )
+    {
+      T *old ( _p );
+      _p = p._p;
+      p._p = 0x0;
+
+      // Release the old one last, for the same reason as in _set().
+      if ( old )
+      {
+        ReferencePolicy::unref ( old );
+      }
+    }
+    return *this;
+  }
+
+#endif
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Swap the pointers. The counts do not change.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  void swap ( ThisType &p )
+  {
+    T *t ( _p );
+    _p = p._p;
+    p._p = t;
+  }
+
 
   /////////////////////////////////////////////////////////////////////////////
   //
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Handle to a registry node.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Config/Config.h"
+#include "Usul/Registry/Handle.h"
+#include "Usul/Registry/Database.h"
+
+#include <stdexcept>
+
+using namespace Usul::Registry;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Handle::Handle ( Database &db, const Path &path ) :
+  _root ( db.root() ),
+  _path ( path ),
+  _mutex(),
+  _node(),
+  _structure ( 0 )
+{
+  if ( false == _root.valid() )
+  {
+    throw std::invalid_argument ( "Error 2976210455: Registry database has no root" );
+  }
+  this->_find();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Handle::Handle ( Node::RefPtr root, const Path &path ) :
+  _root ( root ),
+  _path ( path ),
+  _mutex(),
+  _node(),
+  _structure ( 0 )
+{
+  if ( false == _root.valid() )
+  {
+    throw std::invalid_argument ( "Error 1613493870: Null root node for registry handle" );
+  }
+  this->_find();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Handle::~Handle()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the path.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+const Handle::Path &Handle::path() const
+{
+  return _path;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the node. Only look it up again if nodes were removed since.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Node::RefPtr Handle::node() const
+{
+  // Read the structure first. It is set after the node.
+  if ( Node::structureVersion() == _structure )
+  {
+    Node::RefPtr node ( _node );
+    if ( true == node.valid() )
+      return node;
+  }
+
+  return this->_find();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Look up the node and remember it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Node::RefPtr Handle::_find() const
+{
+  Guard guard ( _mutex );
+
+  const Version structure ( Node::structureVersion() );
+  Node::RefPtr root ( _root );
+  Node::RefPtr node ( &((*root)[_path]) );
+
+  _node = node;
+  _structure = structure;
+
+  return node;
+}
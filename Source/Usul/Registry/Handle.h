@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Handle to a registry node. The path is looked up once, and again only
+//  if nodes were removed since. Finding the node takes no lock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_REGISTRY_HANDLE_CLASS_H_
+#define _USUL_REGISTRY_HANDLE_CLASS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/Atomic/Integer.h"
+#include "Usul/Atomic/Pointer.h"
+#include "Usul/Registry/Node.h"
+#include "Usul/Threads/Mutex.h"
+
+#include "boost/noncopyable.hpp"
+
+namespace Usul { namespace Registry { class Database; } }
+
+
+namespace Usul {
+namespace Registry {
+
+
+class USUL_EXPORT Handle : public boost::noncopyable
+{
+public:
+
+  // Typedefs.
+  typedef Node::Path Path;
+  typedef Node::Version Version;
+  typedef Node::Guard Guard;
+
+  // Constructors and destructor.
+  Handle ( Database &, const Path & );
+  Handle ( Node::RefPtr root, const Path & );
+  ~Handle();
+
+  // Return the node. Creates nodes as needed.
+  Node::RefPtr                    node() const;
+
+  // Return the path.
+  const Path &                    path() const;
+
+private:
+
+  Node::RefPtr                    _find() const;
+
+  const Node::RefPtr _root;
+  const Path _path;
+  mutable Usul::Threads::Mutex _mutex;
+  mutable Usul::Atomic::Pointer<Node::RefPtr> _node;
+  mutable Usul::Atomic::Integer<Version> _structure;
+};
+
+
+} // namespace Registry
+} // namespace Usul
+
+
+#endif // _USUL_REGISTRY_HANDLE_CLASS_H_
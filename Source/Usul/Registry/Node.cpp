@@ -20,6 +20,18 @@
 using namespace Usul::Registry;
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Changes when nodes are removed, so that handles find their nodes again.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  Usul::Atomic::Integer < Node::Version > _structureVersion ( 0 );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Constructor.
@@ -29,7 +41,8 @@ using namespace Usul::Registry;
 Node::Node() : BaseClass(),
   _name(),
   _value(),
-  _kids()
+  _kids(),
+  _version ( 0 )
 {
 }
 
@@ -69,6 +82,7 @@ void Node::accept ( Visitor *v )
 void Node::set ( const std::string &s )
 {
   _value = s;
+  ++_version;
 }
 
 
@@ -122,7 +136,10 @@ std::string Node::get ( const std::string &defaultValue, bool setValueIfEmpty )
 void Node::clear()
 {
   _value.clear();
+  ++_version;
+
   _kids.clear();
+  ++Helper::_structureVersion;
 }
 
 
@@ -246,3 +263,27 @@ unsigned int Node::numChildren() const
   Guard ( _kids.mutex() );
   return _kids.getReference().size();
 }
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of times the value changed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Node::Version Node::version() const
+{
+  return _version;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the number of times nodes were removed from any registry.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Node::Version Node::structureVersion()
+{
+  return Helper::_structureVersion;
+}
@@ -19,6 +19,7 @@
 #include "Usul/Config/Config.h"
 #include "Usul/Base/Referenced.h"
 #include "Usul/Atomic/Container.h"
+#include "Usul/Atomic/Integer.h"
 #include "Usul/Atomic/String.h"
 #include "Usul/Convert/Convert.h"
 #include "Usul/Threads/Guard.h"
@@ -47,6 +48,7 @@ public:
   typedef Usul::Base::Referenced BaseClass;
   typedef std::vector<std::string> Path;
   typedef Usul::Threads::Guard<Usul::Threads::Mutex> Guard;
+  typedef unsigned long Version;
 
   // Smart-pointer definitions.
   USUL_REFERENCED_CLASS ( Node );
@@ -96,6 +98,12 @@ public:
   void                            set ( const char * );
   template < class T > void       set ( const T &t );
 
+  // Return the number of times the value changed.
+  Version                         version() const;
+
+  // Return the number of times nodes were removed from any registry.
+  static Version                  structureVersion();
+
 protected:
 
   // Use reference counting.
@@ -108,6 +116,7 @@ private:
   Usul::Atomic::String _name;
   Usul::Atomic::String _value;
   Usul::Atomic::Container<Children> _kids;
+  Usul::Atomic::Integer<Version> _version;
 };
 
 
@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Typed registry value. The string is only converted when the node
+//  changes, so it can be read often, like once per frame or per job.
+//  Reading it takes no lock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_REGISTRY_VALUE_CLASS_H_
+#define _USUL_REGISTRY_VALUE_CLASS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Atomic/Pointer.h"
+#include "Usul/Base/Referenced.h"
+#include "Usul/Registry/Handle.h"
+
+#include "boost/noncopyable.hpp"
+
+
+namespace Usul {
+namespace Registry {
+
+
+template < class T > class Value : public boost::noncopyable
+{
+public:
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Typedefs.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  typedef T ValueType;
+  typedef Handle::Path Path;
+  typedef Handle::Version Version;
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Constructors.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  Value ( Database &db, const Path &path, const ValueType &defaultValue ) :
+    _handle ( db, path ),
+    _defaultValue ( defaultValue ),
+    _cache()
+  {
+  }
+  Value ( Node::RefPtr root, const Path &path, const ValueType &defaultValue ) :
+    _handle ( root, path ),
+    _defaultValue ( defaultValue ),
+    _cache()
+  {
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Get the value. Only converts the string if the node changed.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  ValueType get() const
+  {
+    Node::RefPtr node ( _handle.node() );
+
+    // Read the version before the string. It is set after.
+    const Version version ( node->version() );
+    typename Cache::RefPtr cache ( _cache );
+    if ( ( true == cache.valid() ) && ( version == cache->version ) && ( node == cache->node ) )
+    {
+      return cache->value;
+    }
+
+    const ValueType value ( node->get < ValueType > ( _defaultValue ) );
+    _cache = typename Cache::RefPtr ( new Cache ( node, version, value ) );
+    return value;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Set the value.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  void set ( const ValueType &value )
+  {
+    _handle.node()->set ( value );
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Has the value changed since the caller's version? If so, update the
+  //  caller's version and return true.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  bool changed ( Version &seen ) const
+  {
+    const Version version ( _handle.node()->version() );
+    if ( version == seen )
+      return false;
+
+    seen = version;
+    return true;
+  }
+
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  Return the handle.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  const Handle &handle() const
+  {
+    return _handle;
+  }
+
+private:
+
+  /////////////////////////////////////////////////////////////////////////////
+  //
+  //  The converted value and the node version it came from.
+  //
+  /////////////////////////////////////////////////////////////////////////////
+
+  class Cache : public Usul::Base::Referenced
+  {
+  public:
+
+    typedef Usul::Base::Referenced BaseClass;
+    USUL_REFERENCED_CLASS ( Cache );
+
+    Cache ( Node::RefPtr n, Version v, const ValueType &t ) : BaseClass(),
+      node ( n ),
+      version ( v ),
+      value ( t )
+    {
+    }
+
+    const Node::RefPtr node;
+    const Version version;
+    const ValueType value;
+
+  protected:
+
+    virtual ~Cache()
+    {
+    }
+  };
+
+  Handle _handle;
+  const ValueType _defaultValue;
+  mutable Usul::Atomic::Pointer < typename Cache::RefPtr > _cache;
+};
+
+
+} // namespace Registry
+} // namespace Usul
+
+
+#endif // _USUL_REGISTRY_VALUE_CLASS_H_
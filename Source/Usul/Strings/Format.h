@@ -18,184 +18,361 @@
 
 #include "Usul/Config/Config.h"
 
+#include <cstdio>
+#include <cstring>
 #include <sstream>
+#include <string>
+
+#if __cplusplus >= 201703L
+# include <charconv>
+#endif
 
 
 namespace Usul {
 namespace Strings {
+namespace Detail {
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Collects the text on the stack. Only long strings use the heap. 
+//
+///////////////////////////////////////////////////////////////////////////////
+
+class Writer
+{
+public:
+
+  Writer() : _size ( 0 ), _spilled ( false ), _heap()
+  {
+  }
+
+  void append ( const char *s, std::size_t n )
+  {
+    if ( ( false == _spilled ) && ( n <= ( SIZE - _size ) ) )
+    {
+      std::memcpy ( _stack + _size, s, n );
+      _size += n;
+      return;
+    }
+    if ( false == _spilled )
+    {
+      _heap.reserve ( _size + n + SIZE );
+      _heap.assign ( _stack, _size );
+      _spilled = true;
+    }
+    _heap.append ( s, n );
+  }
+
+  void append ( char c )
+  {
+    this->append ( &c, 1 );
+  }
+
+  std::string str() const
+  {
+    return ( ( true == _spilled ) ? _heap : std::string ( _stack, _size ) );
+  }
+
+private:
+
+  enum { SIZE = 256 };
+
+  char _stack[SIZE];
+  std::size_t _size;
+  bool _spilled;
+  std::string _heap;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the number's digits. They come out the same as from a stream.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class UnsignedType > inline void appendUnsigned ( Writer &w, UnsignedType u, bool negative )
+{
+  char buffer[32];
+  char *end ( buffer + sizeof ( buffer ) );
+  char *begin ( end );
+  do
+  {
+    *--begin = static_cast < char > ( '0' + ( u % 10 ) );
+    u /= 10;
+  }
+  while ( u > 0 );
+  if ( true == negative )
+  {
+    *--begin = '-';
+  }
+  w.append ( begin, static_cast < std::size_t > ( end - begin ) );
+}
+template < class SignedType, class UnsignedType > inline void appendSigned ( Writer &w, SignedType i )
+{
+  // Negate as unsigned so that the smallest value works.
+  const bool negative ( i < 0 );
+  const UnsignedType u ( static_cast < UnsignedType > ( i ) );
+  Detail::appendUnsigned ( w, ( ( true == negative ) ? ( 0 - u ) : u ), negative );
+}
+inline void appendReal ( Writer &w, double d )
+{
+  char buffer[64];
+  #ifdef __cpp_lib_to_chars
+  const std::to_chars_result result ( std::to_chars ( buffer, buffer + sizeof ( buffer ), d, std::chars_format::general, 6 ) );
+  w.append ( buffer, static_cast < std::size_t > ( result.ptr - buffer ) );
+  #elif defined ( _MSC_VER ) && ( _MSC_VER < 1900 )
+  const int size ( ::_snprintf ( buffer, sizeof ( buffer ), "%g", d ) );
+  w.append ( buffer, ( ( size > 0 ) ? static_cast < std::size_t > ( size ) : 0 ) );
+  #else
+  const int size ( ::snprintf ( buffer, sizeof ( buffer ), "%g", d ) );
+  w.append ( buffer, ( ( size > 0 ) ? static_cast < std::size_t > ( size ) : 0 ) );
+  #endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Append the value. Types without an overload use a stream.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+inline void append ( Writer &w, const std::string &s )          { w.append ( s.data(), s.size() ); }
+inline void append ( Writer &w, const char *s )                 { w.append ( s, ( ( 0x0 == s ) ? 0 : std::strlen ( s ) ) ); }
+inline void append ( Writer &w, char *s )                       { Detail::append ( w, static_cast < const char * > ( s ) ); }
+inline void append ( Writer &w, const signed char *s )          { Detail::append ( w, reinterpret_cast < const char * > ( s ) ); }
+inline void append ( Writer &w, const unsigned char *s )        { Detail::append ( w, reinterpret_cast < const char * > ( s ) ); }
+inline void append ( Writer &w, signed char *s )                { Detail::append ( w, reinterpret_cast < const char * > ( s ) ); }
+inline void append ( Writer &w, unsigned char *s )              { Detail::append ( w, reinterpret_cast < const char * > ( s ) ); }
+inline void append ( Writer &w, char c )                        { w.append ( c ); }
+inline void append ( Writer &w, signed char c )                 { w.append ( static_cast < char > ( c ) ); }
+inline void append ( Writer &w, unsigned char c )               { w.append ( static_cast < char > ( c ) ); }
+inline void append ( Writer &w, bool b )                        { w.append ( ( true == b ) ? '1' : '0' ); }
+inline void append ( Writer &w, short i )                       { Detail::appendSigned < long, unsigned long > ( w, i ); }
+inline void append ( Writer &w, int i )                         { Detail::appendSigned < long, unsigned long > ( w, i ); }
+inline void append ( Writer &w, long i )                        { Detail::appendSigned < long, unsigned long > ( w, i ); }
+inline void append ( Writer &w, long long i )                   { Detail::appendSigned < long long, unsigned long long > ( w, i ); }
+inline void append ( Writer &w, unsigned short u )              { Detail::appendUnsigned < unsigned long > ( w, u, false ); }
+inline void append ( Writer &w, unsigned int u )                { Detail::appendUnsigned < unsigned long > ( w, u, false ); }
+inline void append ( Writer &w, unsigned long u )               { Detail::appendUnsigned < unsigned long > ( w, u, false ); }
+inline void append ( Writer &w, unsigned long long u )          { Detail::appendUnsigned < unsigned long long > ( w, u, false ); }
+inline void append ( Writer &w, float f )                       { Detail::appendReal ( w, f ); }
+inline void append ( Writer &w, double d )                      { Detail::appendReal ( w, d ); }
+
+// Pointers are written in hex, like a stream does.
+inline void append ( Writer &w, const void *p )
+{
+  const std::size_t a ( reinterpret_cast < std::size_t > ( p ) );
+  if ( 0 == a )
+  {
+    w.append ( '0' );
+    return;
+  }
+  char buffer[32];
+  char *end ( buffer + sizeof ( buffer ) );
+  char *begin ( end );
+  for ( std::size_t u = a; u > 0; u >>= 4 )
+  {
+    *--begin = "0123456789abcdef"[u & 0xF];
+  }
+  *--begin = 'x';
+  *--begin = '0';
+  w.append ( begin, static_cast < std::size_t > ( end - begin ) );
+}
+template < class T > inline void append ( Writer &w, T *p )
+{
+  Detail::append ( w, static_cast < const void * > ( p ) );
+}
+
+template < class T > inline void append ( Writer &w, const T &t )
+{
+  std::ostringstream out;
+  out << t;
+  const std::string s ( out.str() );
+  w.append ( s.data(), s.size() );
+}
+
+template < class T > inline Writer &operator << ( Writer &w, const T &t )
+{
+  append ( w, t );
+  return w;
+}
+
+
+} // namespace Detail
 
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Format the string.
+//  Format the string. Common types are written without making a stream.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 template < class T1 > 
 inline std::string format ( const T1 &t1 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1;
   return out.str();
 }
 template < class T1, class T2 > 
 inline std::string format ( const T1 &t1, const T2 &t2 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2;
   return out.str();
 }
 template < class T1, class T2, class T3 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16, class T17 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16, const T17 &t17 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16 << t17;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16, class T17, class T18 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16, const T17 &t17, const T18 &t18 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16 << t17 << t18;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16, class T17, class T18, class T19 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16, const T17 &t17, const T18 &t18, const T19 &t19 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16 << t17 << t18 << t19;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16, class T17, class T18, class T19, class T20 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16, const T17 &t17, const T18 &t18, const T19 &t19, const T20 &t20 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16 << t17 << t18 << t19 << t20;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16, class T17, class T18, class T19, class T20, class T21 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16, const T17 &t17, const T18 &t18, const T19 &t19, const T20 &t20, const T21 &t21 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16 << t17 << t18 << t19 << t20 << t21;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16, class T17, class T18, class T19, class T20, class T21, class T22 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16, const T17 &t17, const T18 &t18, const T19 &t19, const T20 &t20, const T21 &t21, const T22 &t22 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16 << t17 << t18 << t19 << t20 << t21 << t22;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16, class T17, class T18, class T19, class T20, class T21, class T22, class T23 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16, const T17 &t17, const T18 &t18, const T19 &t19, const T20 &t20, const T21 &t21, const T22 &t22, const T23 &t23 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16 << t17 << t18 << t19 << t20 << t21 << t22 << t23;
   return out.str();
 }
 template < class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13, class T14, class T15, class T16, class T17, class T18, class T19, class T20, class T21, class T22, class T23, class T24 > 
 inline std::string format ( const T1 &t1, const T2 &t2, const T3 &t3, const T4 &t4, const T5 &t5, const T6 &t6, const T7 &t7, const T8 &t8, const T9 &t9, const T10 &t10, const T11 &t11, const T12 &t12, const T13 &t13, const T14 &t14, const T15 &t15, const T16 &t16, const T17 &t17, const T18 &t18, const T19 &t19, const T20 &t20, const T21 &t21, const T22 &t22, const T23 &t23, const T24 &t24 )
 {
-  std::ostringstream out;
+  Detail::Writer out;
   out << t1 << t2 << t3 << t4 << t5 << t6 << t7 << t8 << t9 << t10 << t11 << t12 << t13 << t14 << t15 << t16 << t17 << t18 << t19 << t20 << t21 << t22 << t23 << t24;
   return out.str();
 }
@@ -17,8 +17,13 @@
 
 #include <ctime>
 
-#ifndef _MSC_VER
+#ifdef _MSC_VER
+# define NOMINMAX
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h> // For QueryPerformanceCounter
+#else
 # include <sys/time.h> // For gettimeofday
+# include <time.h>     // For clock_gettime
 #endif 
 
 
@@ -40,6 +45,59 @@ namespace
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Returns the nanoseconds offset from a platform dependent value. Unlike 
+//  the others, this clock never goes backwards. Use it to time short things.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Usul::Types::UInt64 Usul::System::Clock::nanoseconds() 
+{
+#ifdef _MSC_VER
+  LARGE_INTEGER frequency, count;
+  ::QueryPerformanceFrequency ( &frequency );
+  ::QueryPerformanceCounter ( &count );
+  const Usul::Types::UInt64 seconds ( count.QuadPart / frequency.QuadPart );
+  const Usul::Types::UInt64 remainder ( count.QuadPart % frequency.QuadPart );
+  return seconds * 1000000000 + ( remainder * 1000000000 ) / frequency.QuadPart;
+#else
+  struct timespec t1;
+  ::clock_gettime ( CLOCK_MONOTONIC, &t1 );
+  Usul::Types::UInt64 seconds ( t1.tv_sec );
+  Usul::Types::UInt64 nanoSec ( t1.tv_nsec );
+  return seconds * 1000000000 + nanoSec;
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Returns the microseconds offset from a platform dependent value. Like 
+//  the nanoseconds, it never goes backwards when the system time changes, 
+//  so use it for deadlines and waiting.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+Usul::Types::UInt64 Usul::System::Clock::microseconds() 
+{
+#ifdef _MSC_VER
+  LARGE_INTEGER frequency, count;
+  ::QueryPerformanceFrequency ( &frequency );
+  ::QueryPerformanceCounter ( &count );
+  const Usul::Types::UInt64 seconds ( count.QuadPart / frequency.QuadPart );
+  const Usul::Types::UInt64 remainder ( count.QuadPart % frequency.QuadPart );
+  return seconds * 1000000 + ( remainder * 1000000 ) / frequency.QuadPart;
+#else
+  struct timespec t1;
+  ::clock_gettime ( CLOCK_MONOTONIC, &t1 );
+  Usul::Types::UInt64 seconds ( t1.tv_sec );
+  Usul::Types::UInt64 microSec ( t1.tv_nsec / 1000 );
+  return seconds * 1000000 + microSec;
+#endif
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Returns the milliseconds offset from a platform dependent value.
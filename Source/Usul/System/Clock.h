@@ -26,6 +26,8 @@ namespace System {
 
 struct USUL_EXPORT Clock
 {
+  static Usul::Types::UInt64          nanoseconds();
+  static Usul::Types::UInt64          microseconds();
   static Usul::Types::UInt64          milliseconds();
   static Usul::Types::UInt64          seconds();
 };
@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Mutex that is not recursive and spins before it waits.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Threads/FastMutex.h"
+#include "Usul/Exceptions/Exceptions.h"
+#include "Usul/Strings/Format.h"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace Usul::Threads;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  // Never spin more than this.
+  const unsigned int MAX_SPINS ( 100 );
+
+  // Tell the processor we are spinning.
+  inline void pause()
+  {
+    #if defined ( _MSC_VER )
+    _mm_pause();
+    #elif defined ( __i386__ ) || defined ( __x86_64__ )
+    __asm__ __volatile__ ( "pause" );
+    #endif
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+FastMutex::FastMutex() : _mutex(), _spins ( 10 )
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Destructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+FastMutex::~FastMutex()
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Try for a while to get the lock. The number of tries moves towards what
+//  it took the last time, so a lock that is held long stops spinning.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool FastMutex::_spin()
+{
+  if ( true == _mutex.try_lock() )
+    return true;
+
+  const unsigned int spins ( _spins );
+  const unsigned int most ( std::min ( spins * 2 + 10, Helper::MAX_SPINS ) );
+  for ( unsigned int i = 0; i < most; ++i )
+  {
+    Helper::pause();
+    if ( true == _mutex.try_lock() )
+    {
+      // The update is not atomic, it is only a guess.
+      _spins = spins + ( static_cast < int > ( i ) - static_cast < int > ( spins ) ) / 8;
+      return true;
+    }
+  }
+
+  _spins = spins + ( static_cast < int > ( most ) - static_cast < int > ( spins ) ) / 8;
+  return false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Lock the mutex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FastMutex::lock()
+{
+  if ( false == this->_spin() )
+  {
+    _mutex.lock();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Lock the mutex, waiting no longer than the timeout.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FastMutex::lock ( Usul::Types::UInt64 timeout, unsigned long )
+{
+  if ( true == this->_spin() )
+    return;
+
+  if ( false == _mutex.timed_lock ( boost::posix_time::milliseconds ( static_cast < long > ( timeout ) ) ) )
+  {
+    throw Usul::Exceptions::TimedOut ( Usul::Strings::format
+      ( "Warning 3047181254: Could not acquire lock within ", timeout, " milliseconds." ) );
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Unlock the mutex.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void FastMutex::unlock()
+{
+  _mutex.unlock();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Try to lock the mutex. Will return true if the lock has been acquired.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool FastMutex::trylock()
+{
+  return _mutex.try_lock();
+}
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Mutex that is not recursive. It spins for a short time before waiting,
+//  and learns how long to spin from how long the lock is usually held.
+//  Use it for locks that are held briefly and often. Locking it twice in
+//  the same thread deadlocks.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_THREADS_FAST_MUTEX_CLASS_H_
+#define _USUL_THREADS_FAST_MUTEX_CLASS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/thread/mutex.hpp"
+
+
+namespace Usul {
+namespace Threads {
+
+
+class USUL_EXPORT FastMutex
+{
+public:
+
+  // Construction/Destruction.
+  FastMutex();
+  ~FastMutex();
+
+  // Lock the mutex. The second one throws Usul::Exceptions::TimedOut if
+  // it waits longer than the timeout, in milliseconds. The pause is not
+  // used; it is there so that this class can replace Mutex.
+  void            lock();
+  void            lock ( Usul::Types::UInt64 timeout, unsigned long millisecondPause = 0 );
+
+  // Unlock the mutex.
+  void            unlock();
+
+  // Try to lock the mutex. Will return true if the lock has been acquired.
+  bool            trylock();
+
+private:
+
+  FastMutex ( const FastMutex & );             // No copying
+  FastMutex &operator = ( const FastMutex & ); // No assignment
+
+  bool            _spin();
+
+  boost::timed_mutex _mutex;
+  volatile unsigned int _spins;
+};
+
+
+} // namespace Threads
+} // namespace Usul
+
+
+#endif // _USUL_THREADS_FAST_MUTEX_CLASS_H_
@@ -18,6 +18,10 @@
 
 #include "Usul/Config/Config.h"
 
+#ifdef USUL_PROFILE_LOCKS
+#include "Usul/Threads/LockProfiler.h"
+#endif
+
 
 namespace Usul {
 namespace Threads {
@@ -29,6 +33,34 @@ public:
 
   typedef MutexType_ MutexType;
 
+#ifdef USUL_PROFILE_LOCKS
+
+  typedef Usul::Threads::LockProfiler::Site Site;
+  typedef Usul::Threads::LockProfiler::Probe Probe;
+
+  // Constructor. Locks the mutex.
+  Guard ( MutexType &m, const Site &site = USUL_THREADS_LOCK_SITE ) : _mutex ( m ), _probe ( site )
+  {
+    _probe.lock ( _mutex );
+  }
+
+  // Constructor. Locks the mutex.
+  template < class ObjectType > Guard ( ObjectType *object, const Site &site = USUL_THREADS_LOCK_SITE ) :
+    _mutex ( object->mutex() ),
+    _probe ( site )
+  {
+    _probe.lock ( _mutex );
+  }
+
+  // Destructor. Unlocks the mutex.
+  ~Guard()
+  {
+    _mutex.unlock();
+    _probe.unlocked();
+  }
+
+#else
+
   // Constructor. Locks the mutex.
   Guard ( MutexType &m ) : _mutex ( m )
   {
@@ -47,9 +79,14 @@ public:
     _mutex.unlock();
   }
 
+#endif
+
 protected:
 
   MutexType &_mutex;
+#ifdef USUL_PROFILE_LOCKS
+  Probe _probe;
+#endif
 };
 
 
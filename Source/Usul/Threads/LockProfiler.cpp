@@ -0,0 +1,306 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Records lock contention for each guard in the code.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Usul/Threads/LockProfiler.h"
+
+#include "boost/thread/locks.hpp"
+#include "boost/thread/tss.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
+using namespace Usul::Threads;
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Helper functions and data. Nothing here uses Usul::Threads::Guard,
+//  because that would record itself.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Helper
+{
+  typedef boost::mutex Mutex;
+  typedef boost::lock_guard < Mutex > Lock;
+
+  // What one thread recorded. Only the report reads it from other threads.
+  struct Table
+  {
+    Mutex mutex;
+    LockProfiler::Sites sites;
+  };
+  typedef std::vector < Table * > Tables;
+
+  // Add the sites to the others.
+  inline void merge ( const LockProfiler::Sites &from, LockProfiler::Sites &to )
+  {
+    for ( LockProfiler::Sites::const_iterator i = from.begin(); i != from.end(); ++i )
+    {
+      to[i->first].add ( i->second );
+    }
+  }
+
+  void retire ( Table * );
+
+  // Never deleted because guards may be used during static destruction.
+  struct State
+  {
+    State() : mutex(), tables(), retired(), current ( &Helper::retire ), enabled ( false )
+    {
+    }
+
+    Mutex mutex;
+    Tables tables;
+    LockProfiler::Sites retired;
+    boost::thread_specific_ptr < Table > current;
+    volatile bool enabled;
+  };
+  State *_state ( 0x0 );
+
+  inline State &state()
+  {
+    if ( 0x0 == _state )
+    {
+      _state = new State;
+    }
+    return *_state;
+  }
+
+  // Called when a thread ends. Keep what it recorded.
+  void retire ( Table *table )
+  {
+    if ( 0x0 == table )
+      return;
+
+    State &s ( Helper::state() );
+    {
+      Lock lock ( s.mutex );
+      Helper::merge ( table->sites, s.retired );
+      s.tables.erase ( std::remove ( s.tables.begin(), s.tables.end(), table ), s.tables.end() );
+    }
+    delete table;
+  }
+
+  // Return this thread's table.
+  inline Table &table()
+  {
+    State &s ( Helper::state() );
+    Table *t ( s.current.get() );
+    if ( 0x0 == t )
+    {
+      t = new Table;
+      s.current.reset ( t );
+      Lock lock ( s.mutex );
+      s.tables.push_back ( t );
+    }
+    return *t;
+  }
+
+  // Longest total wait first.
+  inline bool longerWait ( const std::pair < LockProfiler::Site, LockProfiler::Stats > &a,
+                           const std::pair < LockProfiler::Site, LockProfiler::Stats > &b )
+  {
+    return ( a.second.waitTotal > b.second.waitTotal );
+  }
+
+  // Make the state before there are threads.
+  struct Init
+  {
+    Init()
+    {
+      Helper::state();
+    }
+  } _init;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Order the sites. The same file can have more than one string, so compare
+//  the text. The line usually decides it.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool LockProfiler::Site::operator < ( const Site &s ) const
+{
+  if ( line != s.line )
+    return ( line < s.line );
+  if ( file == s.file )
+    return false;
+  return ( std::strcmp ( file, s.file ) < 0 );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Stats constructor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+LockProfiler::Stats::Stats() :
+  count ( 0 ),
+  contended ( 0 ),
+  waitTotal ( 0 ),
+  waitMaximum ( 0 ),
+  holdTotal ( 0 ),
+  holdMaximum ( 0 )
+{
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Add the other stats.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void LockProfiler::Stats::add ( const Stats &s )
+{
+  count += s.count;
+  contended += s.contended;
+  waitTotal += s.waitTotal;
+  waitMaximum = std::max ( waitMaximum, s.waitMaximum );
+  holdTotal += s.holdTotal;
+  holdMaximum = std::max ( holdMaximum, s.holdMaximum );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Is the profiler recording?
+//
+///////////////////////////////////////////////////////////////////////////////
+
+bool LockProfiler::enabled()
+{
+  return Helper::state().enabled;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Start or stop recording.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void LockProfiler::enable ( bool state )
+{
+  Helper::state().enabled = state;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Record one lock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void LockProfiler::record ( const Site &site, bool contended, UInt64 wait, UInt64 hold )
+{
+  Helper::Table &t ( Helper::table() );
+  Helper::Lock lock ( t.mutex );
+
+  Stats &s ( t.sites[site] );
+  ++s.count;
+  if ( true == contended )
+  {
+    ++s.contended;
+  }
+  s.waitTotal += wait;
+  s.waitMaximum = std::max ( s.waitMaximum, wait );
+  s.holdTotal += hold;
+  s.holdMaximum = std::max ( s.holdMaximum, hold );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Forget everything recorded so far.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void LockProfiler::reset()
+{
+  Helper::State &s ( Helper::state() );
+  Helper::Lock lock ( s.mutex );
+  s.retired.clear();
+  for ( Helper::Tables::iterator i = s.tables.begin(); i != s.tables.end(); ++i )
+  {
+    Helper::Lock tableLock ( (*i)->mutex );
+    (*i)->sites.clear();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return what has been recorded, from all threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+LockProfiler::Sites LockProfiler::sites()
+{
+  Helper::State &s ( Helper::state() );
+  Helper::Lock lock ( s.mutex );
+  Sites answer ( s.retired );
+  for ( Helper::Tables::iterator i = s.tables.begin(); i != s.tables.end(); ++i )
+  {
+    Helper::Lock tableLock ( (*i)->mutex );
+    Helper::merge ( (*i)->sites, answer );
+  }
+  return answer;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the sites that waited the longest, longest first.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+LockProfiler::SortedSites LockProfiler::sorted ( unsigned int maximum )
+{
+  const Sites all ( LockProfiler::sites() );
+  SortedSites answer ( all.begin(), all.end() );
+  const SortedSites::size_type size ( std::min < SortedSites::size_type > ( maximum, answer.size() ) );
+  std::partial_sort ( answer.begin(), answer.begin() + size, answer.end(), &Helper::longerWait );
+  answer.resize ( size, SortedSites::value_type ( Site ( "", 0 ), Stats() ) );
+  return answer;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Write the sites that waited the longest. Times are in microseconds.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+void LockProfiler::report ( std::ostream &out, unsigned int maximum )
+{
+  const SortedSites sites ( LockProfiler::sorted ( maximum ) );
+  for ( SortedSites::const_iterator i = sites.begin(); i != sites.end(); ++i )
+  {
+    const Site &site ( i->first );
+    const Stats &s ( i->second );
+    out << site.file << ':' << site.line
+        << " locked " << s.count
+        << ", contended " << s.contended
+        << ", wait total " << s.waitTotal / 1000.0
+        << " max " << s.waitMaximum / 1000.0
+        << ", hold total " << s.holdTotal / 1000.0
+        << " max " << s.holdMaximum / 1000.0 << '\n';
+  }
+}
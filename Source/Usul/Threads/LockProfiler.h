@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Records how often each Usul::Threads::Guard in the code locks its mutex,
+//  how often it had to wait, how long it waited, and how long it held the
+//  lock. Times are in nanoseconds.
+//
+//  Guards only record when the code is built with USUL_PROFILE_LOCKS
+//  defined, and then only while the profiler is enabled. Each thread
+//  records into its own table, so enabling it on a busy system adds a few
+//  clock reads per lock and no shared writes. Build everything with the
+//  same setting, because it changes the size of Guard.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_THREADS_LOCK_PROFILER_CLASS_H_
+#define _USUL_THREADS_LOCK_PROFILER_CLASS_H_
+
+#include "Usul/Config/Config.h"
+#include "Usul/Export/Export.h"
+#include "Usul/System/Clock.h"
+#include "Usul/Types/Types.h"
+
+#include "boost/noncopyable.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/shared_mutex.hpp"
+
+#include <iosfwd>
+#include <map>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The file and line of the code that makes a guard. Used as a default
+//  argument, so that it is evaluated where the guard is made.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined ( __GNUC__ ) || ( defined ( _MSC_VER ) && _MSC_VER >= 1926 )
+#define USUL_THREADS_LOCK_SITE Usul::Threads::LockProfiler::Site ( __builtin_FILE(), __builtin_LINE() )
+#else
+#define USUL_THREADS_LOCK_SITE Usul::Threads::LockProfiler::Site ( "unknown", 0 )
+#endif
+
+
+namespace Usul {
+namespace Threads {
+
+
+class USUL_EXPORT LockProfiler : public boost::noncopyable
+{
+public:
+
+  typedef Usul::Types::UInt64 UInt64;
+
+  // Where the lock is taken.
+  struct USUL_EXPORT Site
+  {
+    Site ( const char *f, unsigned int l ) : file ( f ), line ( l ){}
+
+    bool                operator < ( const Site & ) const;
+
+    const char *file;
+    unsigned int line;
+  };
+
+  // What happened at one site.
+  struct USUL_EXPORT Stats
+  {
+    Stats();
+
+    void                add ( const Stats & );
+
+    UInt64 count;
+    UInt64 contended;
+    UInt64 waitTotal;
+    UInt64 waitMaximum;
+    UInt64 holdTotal;
+    UInt64 holdMaximum;
+  };
+  typedef std::map < Site, Stats > Sites;
+  typedef std::vector < std::pair < Site, Stats > > SortedSites;
+
+  // Made by the guard. Locks the mutex and times it.
+  class Probe
+  {
+  public:
+
+    Probe ( const Site &site ) : _site ( site ), _start ( 0 ), _wait ( 0 ), _contended ( false )
+    {
+    }
+
+    template < class MutexType > void lock ( MutexType &m );
+
+    // Call after the mutex is unlocked.
+    void unlocked()
+    {
+      if ( 0 != _start )
+      {
+        LockProfiler::record ( _site, _contended, _wait, Usul::System::Clock::nanoseconds() - _start );
+      }
+    }
+
+  private:
+
+    Site _site;
+    UInt64 _start;
+    UInt64 _wait;
+    bool _contended;
+  };
+
+  // Is the profiler recording?
+  static bool           enabled();
+
+  // Start or stop recording.
+  static void           enable ( bool );
+
+  // Record one lock.
+  static void           record ( const Site &, bool contended, UInt64 wait, UInt64 hold );
+
+  // Forget everything recorded so far.
+  static void           reset();
+
+  // Return what has been recorded, from all threads.
+  static Sites          sites();
+
+  // Return the sites that waited the longest, longest first.
+  static SortedSites    sorted ( unsigned int maximum );
+
+  // Write the sites that waited the longest. Times are in microseconds.
+  static void           report ( std::ostream &, unsigned int maximum = 20 );
+};
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Try the lock. Usul mutexes call it trylock, boost calls it try_lock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Detail
+{
+  template < class MutexType > inline bool tryLock ( MutexType &m )
+  {
+    return m.trylock();
+  }
+  inline bool tryLock ( boost::mutex &m )
+  {
+    return m.try_lock();
+  }
+  inline bool tryLock ( boost::shared_mutex &m )
+  {
+    return m.try_lock();
+  }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Lock the mutex. Only read the clock when the profiler is enabled, and
+//  only time the wait when the lock is not free.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+template < class MutexType > inline void LockProfiler::Probe::lock ( MutexType &m )
+{
+  if ( false == LockProfiler::enabled() )
+  {
+    m.lock();
+    return;
+  }
+
+  if ( true == Usul::Threads::Detail::tryLock ( m ) )
+  {
+    _start = Usul::System::Clock::nanoseconds();
+    return;
+  }
+
+  const UInt64 before ( Usul::System::Clock::nanoseconds() );
+  m.lock();
+  _start = Usul::System::Clock::nanoseconds();
+  _wait = _start - before;
+  _contended = true;
+}
+
+
+} // namespace Threads
+} // namespace Usul
+
+
+#endif // _USUL_THREADS_LOCK_PROFILER_CLASS_H_
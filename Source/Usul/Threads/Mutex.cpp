@@ -19,6 +19,7 @@
 #include "Usul/System/Clock.h"
 #include "Usul/System/Sleep.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 using namespace Usul::Threads;
@@ -48,14 +49,19 @@ Mutex::~Mutex()
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Lock the mutex.
+//  Lock the mutex. Throws if it takes longer than the timeout, in 
+//  milliseconds. Where the system cannot wait for a mutex with a timeout, 
+//  try again after a pause that doubles up to the given one.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 void Mutex::lock ( Usul::Types::UInt64 timeout, unsigned long pause )
 {
+#if defined ( USUL_WINDOWS ) || defined ( __APPLE__ )
+
   // Get the current time.
   const Usul::Types::UInt64 start ( Usul::System::Clock::milliseconds() );
+  unsigned long wait ( 1 );
 
   // Try to acquire the lock...
   while ( false == this->trylock() )
@@ -71,7 +77,22 @@ void Mutex::lock ( Usul::Types::UInt64 timeout, unsigned long pause )
         ( "Warning 1373313702: Could not acquire lock within ", timeout, " milliseconds." ) );
     }
 
-    // Try again in "pause" milliseconds.
-    Usul::System::Sleep::milliseconds ( pause );
+    // Try again soon, but not after the timeout.
+    const Usul::Types::UInt64 left ( timeout - duration + 1 );
+    Usul::System::Sleep::milliseconds ( static_cast < unsigned long > ( std::min < Usul::Types::UInt64 > ( wait, left ) ) );
+    wait = std::min ( wait * 2, std::max ( pause, 1ul ) );
   }
+
+#else
+
+  // The system waits for us, so there is no pause.
+  (void) pause;
+
+  if ( false == BaseClass::timedlock ( timeout ) )
+  {
+    throw Usul::Exceptions::TimedOut ( Usul::Strings::format 
+      ( "Warning 1373313702: Could not acquire lock within ", timeout, " milliseconds." ) );
+  }
+
+#endif
 }
@@ -57,7 +57,9 @@ public:
   Mutex();
   ~Mutex();
 
-  // Lock the mutex.
+  // Lock the mutex. The second one throws Usul::Exceptions::TimedOut if 
+  // it waits longer than the timeout, in milliseconds. The pause is only 
+  // used where the mutex has to be polled.
   void            lock() { BaseClass::lock(); }
   void            lock ( Usul::Types::UInt64 timeout, unsigned long millisecondPause = 500 );
 
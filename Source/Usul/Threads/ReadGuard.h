@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2009, Perry L Miller IV
+//  All rights reserved.
+//  BSD License: http://www.opensource.org/licenses/bsd-license.html
+//
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Guard that holds a shared lock. Other readers may hold it at the same
+//  time. Use Usul::Threads::Guard for the exclusive lock.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _USUL_THREADS_READ_GUARD_CLASS_H_
+#define _USUL_THREADS_READ_GUARD_CLASS_H_
+
+#include "Usul/Config/Config.h"
+
+
+namespace Usul {
+namespace Threads {
+
+
+template < class MutexType_ > class ReadGuard
+{
+public:
+
+  typedef MutexType_ MutexType;
+
+  // Constructor. Locks the mutex for reading.
+  ReadGuard ( MutexType &m ) : _mutex ( m )
+  {
+    _mutex.lock_shared();
+  }
+
+  // Constructor. Locks the mutex for reading.
+  template < class ObjectType > ReadGuard ( ObjectType *object ) : _mutex ( object->mutex() )
+  {
+    _mutex.lock_shared();
+  }
+
+  // Destructor. Unlocks the mutex.
+  ~ReadGuard()
+  {
+    _mutex.unlock_shared();
+  }
+
+protected:
+
+  MutexType &_mutex;
+};
+
+
+} // namespace Threads
+} // namespace Usul
+
+
+#endif // _USUL_THREADS_READ_GUARD_CLASS_H_
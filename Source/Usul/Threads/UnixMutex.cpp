@@ -21,6 +21,7 @@
 #include <stdexcept>
 
 #include <cerrno>
+#include <ctime>
 #include <iostream>
 
 using namespace Usul::Threads;
@@ -164,3 +165,57 @@ bool UnixMutex::trylock()
 {
   return ( 0 == ::pthread_mutex_trylock ( &_mutex ) );
 }
+
+
+#ifndef __APPLE__
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Wait up to the given milliseconds for the lock. Returns false if it 
+//  timed out. Where pthread_mutex_clocklock() exists (glibc 2.30 and later)
+//  the end time is on the monotonic clock. Otherwise it is on the system 
+//  clock, so changing the system time changes how long this waits.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined ( __GLIBC__ ) && ( ( __GLIBC__ > 2 ) || ( ( 2 == __GLIBC__ ) && ( __GLIBC_MINOR__ >= 30 ) ) )
+#define USUL_THREADS_HAVE_CLOCKLOCK
+#endif
+
+bool UnixMutex::timedlock ( Usul::Types::UInt64 milliseconds )
+{
+  #ifdef USUL_THREADS_HAVE_CLOCKLOCK
+  const clockid_t clock ( CLOCK_MONOTONIC );
+  #else
+  const clockid_t clock ( CLOCK_REALTIME );
+  #endif
+
+  // The time is absolute.
+  timespec end;
+  ::clock_gettime ( clock, &end );
+  end.tv_sec += static_cast < time_t > ( milliseconds / 1000 );
+  end.tv_nsec += static_cast < long > ( ( milliseconds % 1000 ) * 1000000 );
+  if ( end.tv_nsec >= 1000000000 )
+  {
+    end.tv_sec += 1;
+    end.tv_nsec -= 1000000000;
+  }
+
+  #ifdef USUL_THREADS_HAVE_CLOCKLOCK
+  const int result ( ::pthread_mutex_clocklock ( &_mutex, clock, &end ) );
+  #else
+  const int result ( ::pthread_mutex_timedlock ( &_mutex, &end ) );
+  #endif
+  if ( ETIMEDOUT == result )
+    return false;
+
+  if ( 0 != result )
+  {
+    throw std::runtime_error ( Usul::Strings::format 
+      ( "Error 2841605377: Failed to lock mutex, error ", result ) );
+  }
+
+  return true;
+}
+
+#endif
@@ -17,6 +17,7 @@
 #define _USUL_THREADS_UNIX_MUTEX_CLASS_H_
 
 #include "Usul/Config/Config.h"
+#include "Usul/Types/Types.h"
 
 #include <pthread.h>
 
@@ -42,6 +43,12 @@ public:
   // Try to lock the mutex. Will return true if the lock has been acquired.
   bool            trylock();
 
+  #ifndef __APPLE__
+  // Wait up to the given milliseconds for the lock. Returns false if it 
+  // timed out.
+  bool            timedlock ( Usul::Types::UInt64 milliseconds );
+  #endif
+
 private:
 
   UnixMutex ( const UnixMutex & );             // No copying